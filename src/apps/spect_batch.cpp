@@ -0,0 +1,581 @@
+/**************************************************************************************************
+**
+**
+** TODO: License
+**
+** Author: Ondrej Ille
+**************************************************************************************************/
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#include "OptionParser.h"
+
+#include "spect.h"
+#include "CpuSimulator.h"
+#include "CpuModel.h"
+#include "CpuSnapshot.h"
+#include "HexHandler.h"
+#include "KeyMemory.h"
+#include "ProgramImage.h"
+#include "ThreadPool.h"
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Command line options
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+enum  optionIndex {
+    UNKNOWN,
+    HELP,
+    VERSION,
+    MANIFEST,
+    JOBS,
+    FIRST_ADDR,
+    ISA_VERSION,
+    PARITY,
+    MAX_INSTR_CNT,
+    ENGINE,
+    CONTEXT_FORMAT,
+    SPARSE_KEYMEM
+};
+
+const option::Descriptor usage[] =
+{
+    {UNKNOWN,               0,  ""  ,    ""                     ,option::Arg::None,         "USAGE: spect_batch [options] --manifest=<file>\n\n"
+                                                                                            "Executes jobs from manifest file in parallel. Each job runs a program on its own model\n"
+                                                                                            "instance, like single invocation of 'spect_iss'. Each distinct program is compiled once.\n\n"
+                                                                                            "Options:" },
+    {HELP,                  0,  "h" ,    "help"                 ,option::Arg::None,         "  --help                       Print usage and exit." },
+    {VERSION,               0,  "v" ,    "version"              ,option::Arg::None,         "  --version                    Display program version and exit." },
+    {MANIFEST,              0,  ""  ,    "manifest"             ,option::Arg::Optional,     "  --manifest=<file>            Manifest with jobs to execute (see below).\n"},
+    {JOBS,                  0,  "j" ,    "jobs"                 ,option::Arg::Optional,     "  --jobs=<n>                   Number of worker threads (default = number of hardware threads).\n"},
+    {FIRST_ADDR,            0,  ""  ,    "first-address"        ,option::Arg::Optional,     "  --first-address=<addr>       Address to place first instruction of compiled programs.\n"},
+    {ISA_VERSION,           0,  ""  ,    "isa-version"          ,option::Arg::Optional,     "  --isa-version=<version>      Version of Instruction set architecture:\n"
+                                                                                            "                                   1 - For SPECT design spec version <= 1.0 (TROPIC01 MPW1)\n"
+                                                                                            "                                   2 - For SPECT design spec version > 1.0 (default)\n"},
+    {PARITY,                0,  ""  ,    "parity"               ,option::Arg::Optional,     "  --parity=<type>              Parity type:\n"
+                                                                                            "                                   1 - Odd parity.\n"
+                                                                                            "                                   2 - Even parity.\n"
+                                                                                            "                               else - No parity (default).\n"},
+    {MAX_INSTR_CNT,         0,  ""  ,    "max-instr-cnt"        ,option::Arg::Optional,     "  --max-instr-cnt=<n>          Default limit for number of instructions executed by each job (default = 10^8).\n"},
+    {ENGINE,                0,  ""  ,    "engine"               ,option::Arg::Optional,     "  --engine=<engine>            Instruction execution engine (see 'spect_iss --help'):\n"
+                                                                                            "                                   reference - Reference engine.\n"
+                                                                                            "                                   fast      - Fast engine (default).\n"},
+    {CONTEXT_FORMAT,        0,  ""  ,    "context-format"       ,option::Arg::Optional,     "  --context-format=<format>    Format of context dumped by jobs (see 'spect_iss --help'):\n"
+                                                                                            "                                   binary - Binary with header and checksum (default).\n"
+                                                                                            "                                   text   - Human readable text.\n"},
+    {SPARSE_KEYMEM,         0,  ""  ,    "sparse-keymem"        ,option::Arg::Optional,     "  --sparse-keymem              Key memory dumped by jobs holds only used slots.\n"},
+    {UNKNOWN,               0,  ""  ,    ""                     ,option::Arg::None,         "\nManifest holds one job per line, empty lines and lines starting with '#' are ignored.\n"
+                                                                                            "Job is given by whitespace separated options (same meaning as for 'spect_iss'):\n"
+                                                                                            "  --program=<s-file>                Program to compile (compiled once for all jobs).\n"
+                                                                                            "  --instruction-mem=<hex-file>      Assembled program (loaded once for all jobs).\n"
+                                                                                            "  --start-pc=<addr>                 Address of first executed instruction.\n"
+                                                                                            "  --const-rom=<hex-file>            Content of Constant ROM to be loaded.\n"
+                                                                                            "  --data-ram-in=<hex-file>          Content of Data RAM IN to be loaded.\n"
+                                                                                            "  --emem-in=<hex-file>              Content of EMEM IN to be loaded.\n"
+                                                                                            "  --grv-hex=<hex-file>              Data for GRV instruction.\n"
+                                                                                            "  --load-context=<file>             Load context before execution.\n"
+                                                                                            "  --load-context-delta=<file>       Apply context delta on top of loaded context.\n"
+                                                                                            "  --load-keymem=<file>              Load Key memory before execution.\n"
+                                                                                            "  --max-instr-cnt=<n>               Limit for number of executed instructions.\n"
+                                                                                            "  --data-ram-out=<hex-file>         Dump Data RAM OUT after execution.\n"
+                                                                                            "  --emem-out=<hex-file>             Dump EMEM OUT after execution.\n"
+                                                                                            "  --dump-context=<file>             Dump context after execution.\n"
+                                                                                            "  --dump-context-delta=<file>       Dump context changed by execution.\n"
+                                                                                            "  --dump-keymem=<file>              Dump Key memory after execution.\n"
+                                                                                            "  --expect-data-ram-out=<hex-file>  Expected content of Data RAM OUT, job fails on mismatch.\n"
+                                                                                            "  --expect-emem-out=<hex-file>      Expected content of EMEM OUT, job fails on mismatch.\n"
+                                                                                            "Paths are relative to current working directory.\n"},
+
+    {0,0,0,0,0,0}
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Manifest job options
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+enum  jobOptionIndex {
+    J_UNKNOWN,
+    J_PROGRAM,
+    J_INSTRUCTION_MEM_HEX,
+    J_START_PC,
+    J_CONST_ROM_HEX,
+    J_DATA_RAM_IN_HEX,
+    J_EMEM_IN_HEX,
+    J_GRV_HEX,
+    J_LOAD_CONTEXT,
+    J_LOAD_CONTEXT_DELTA,
+    J_LOAD_KEYMEM,
+    J_MAX_INSTR_CNT,
+    J_DATA_RAM_OUT_HEX,
+    J_EMEM_OUT_HEX,
+    J_DUMP_CONTEXT,
+    J_DUMP_CONTEXT_DELTA,
+    J_DUMP_KEYMEM,
+    J_EXPECT_DATA_RAM_OUT_HEX,
+    J_EXPECT_EMEM_OUT_HEX,
+    J_NUM_OPTIONS
+};
+
+const option::Descriptor job_usage[] =
+{
+    {J_UNKNOWN,                 0,  "",  ""                     ,option::Arg::None,     ""},
+    {J_PROGRAM,                 0,  "",  "program"              ,option::Arg::Optional, ""},
+    {J_INSTRUCTION_MEM_HEX,     0,  "",  "instruction-mem"      ,option::Arg::Optional, ""},
+    {J_START_PC,                0,  "",  "start-pc"             ,option::Arg::Optional, ""},
+    {J_CONST_ROM_HEX,           0,  "",  "const-rom"            ,option::Arg::Optional, ""},
+    {J_DATA_RAM_IN_HEX,         0,  "",  "data-ram-in"          ,option::Arg::Optional, ""},
+    {J_EMEM_IN_HEX,             0,  "",  "emem-in"              ,option::Arg::Optional, ""},
+    {J_GRV_HEX,                 0,  "",  "grv-hex"              ,option::Arg::Optional, ""},
+    {J_LOAD_CONTEXT,            0,  "",  "load-context"         ,option::Arg::Optional, ""},
+    {J_LOAD_CONTEXT_DELTA,      0,  "",  "load-context-delta"   ,option::Arg::Optional, ""},
+    {J_LOAD_KEYMEM,             0,  "",  "load-keymem"          ,option::Arg::Optional, ""},
+    {J_MAX_INSTR_CNT,           0,  "",  "max-instr-cnt"        ,option::Arg::Optional, ""},
+    {J_DATA_RAM_OUT_HEX,        0,  "",  "data-ram-out"         ,option::Arg::Optional, ""},
+    {J_EMEM_OUT_HEX,            0,  "",  "emem-out"             ,option::Arg::Optional, ""},
+    {J_DUMP_CONTEXT,            0,  "",  "dump-context"         ,option::Arg::Optional, ""},
+    {J_DUMP_CONTEXT_DELTA,      0,  "",  "dump-context-delta"   ,option::Arg::Optional, ""},
+    {J_DUMP_KEYMEM,             0,  "",  "dump-keymem"          ,option::Arg::Optional, ""},
+    {J_EXPECT_DATA_RAM_OUT_HEX, 0,  "",  "expect-data-ram-out"  ,option::Arg::Optional, ""},
+    {J_EXPECT_EMEM_OUT_HEX,     0,  "",  "expect-emem-out"      ,option::Arg::Optional, ""},
+
+    {0,0,0,0,0,0}
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Program shared by jobs. Compiled (or loaded) once before jobs are executed.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct Program {
+    std::string path;
+    bool is_hex;
+
+    // Program image shared by models of all workers
+    std::shared_ptr<const spect::ProgramImage> image;
+
+    // Empty if program is ready, compilation / load error otherwise
+    std::string error;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Single job of the manifest
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct Job {
+    // Line of the manifest
+    int line_nr;
+    std::string line;
+
+    // Options of the job, empty string - option not used
+    std::string opts[J_NUM_OPTIONS];
+
+    // Index of program within 'programs'
+    size_t program;
+
+    // Job result
+    bool passed = false;
+    std::string result;
+};
+
+std::vector<Program> programs;
+std::vector<Job> jobs;
+
+int isa_version = DEFAULT_ISA_VERSION;
+spect::ParityType parity_type = spect::ParityType::NONE;
+uint32_t first_addr = SPECT_INSTR_MEM_BASE;
+uint64_t max_instr_cnt = 10E8;
+spect::ExecEngine engine = spect::ExecEngine::FAST;
+spect::ContextFormat context_format = spect::ContextFormat::BINARY;
+bool sparse_keymem = false;
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Parse manifest file to 'jobs', collect distinct programs to 'programs'
+/// @returns True if manifest is valid, False otherwise
+///////////////////////////////////////////////////////////////////////////////////////////////////
+static bool ParseManifest(const std::string &path)
+{
+    std::ifstream ifs(path);
+    if (!ifs.is_open()) {
+        std::cout << "Unable to open manifest: " << path << "\n";
+        return false;
+    }
+
+    std::map<std::string, size_t> program_index;
+    std::string line;
+    int line_nr = 0;
+
+    while (std::getline(ifs, line)) {
+        line_nr++;
+
+        std::istringstream iss(line);
+        std::vector<std::string> tokens;
+        std::string token;
+        while (iss >> token)
+            tokens.push_back(token);
+
+        if (tokens.empty() || tokens[0][0] == '#')
+            continue;
+
+        std::vector<const char*> argv;
+        for (const auto &t : tokens)
+            argv.push_back(t.c_str());
+
+        option::Stats stats(job_usage, argv.size(), argv.data());
+        std::vector<option::Option> options(stats.options_max), buffer(stats.buffer_max);
+        option::Parser parse(job_usage, argv.size(), argv.data(), options.data(), buffer.data());
+
+        if (parse.error() || options[J_UNKNOWN] || parse.nonOptionsCount() > 0) {
+            std::cout << path << ":" << line_nr << ": Invalid job: " << line << "\n";
+            return false;
+        }
+
+        Job job;
+        job.line_nr = line_nr;
+        job.line = line;
+        for (int i = 0; i < J_NUM_OPTIONS; i++)
+            if (options[i] && options[i].last()->arg)
+                job.opts[i] = options[i].last()->arg;
+
+        bool is_hex = !job.opts[J_INSTRUCTION_MEM_HEX].empty();
+        if (is_hex == !job.opts[J_PROGRAM].empty()) {
+            std::cout << path << ":" << line_nr << ": Job needs exactly one of '--program' or "
+                         "'--instruction-mem'\n";
+            return false;
+        }
+
+        std::string program = is_hex ? job.opts[J_INSTRUCTION_MEM_HEX] : job.opts[J_PROGRAM];
+        std::string key = (is_hex ? "hex:" : "s:") + program;
+        auto it = program_index.find(key);
+        if (it == program_index.end()) {
+            it = program_index.emplace(key, programs.size()).first;
+            programs.emplace_back();
+            programs.back().path = program;
+            programs.back().is_hex = is_hex;
+        }
+        job.program = it->second;
+
+        jobs.push_back(std::move(job));
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Compile or load program to its program image
+///////////////////////////////////////////////////////////////////////////////////////////////////
+static void PrepareProgram(Program &program)
+{
+    auto image = std::make_shared<spect::ProgramImage>(isa_version, parity_type);
+
+    try {
+        if (program.is_hex)
+            image->LoadInstrMemHex(program.path);
+        else
+            image->LoadProgram(program.path, first_addr);
+    } catch (std::exception &err) {
+        program.error = err.what();
+        return;
+    }
+
+    program.image = image;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Compare memory region of the model with expected HEX file
+/// @returns Empty string on match, description of first mismatch otherwise
+///////////////////////////////////////////////////////////////////////////////////////////////////
+static std::string CompareHex(const std::string &path, spect::CpuModel *model, uint32_t offset,
+                              uint32_t size)
+{
+    std::vector<uint32_t> exp(SPECT_TOTAL_MEM_SIZE / 4, 0);
+    spect::HexHandler::LoadHexFile(path, exp.data(), offset);
+
+    std::vector<uint32_t> mem(SPECT_TOTAL_MEM_SIZE / 4, 0);
+    model->ReadMemoryBlock(offset, mem.data() + (offset >> 2), size);
+
+    for (uint32_t addr = offset; addr < offset + size; addr += 4) {
+        if (mem[addr >> 2] != exp[addr >> 2])
+            return "Mismatch against " + path + " at " + spect::tohexs(addr, 4) + ": " +
+                   spect::tohexs(mem[addr >> 2], 8) + " (expected " +
+                   spect::tohexs(exp[addr >> 2], 8) + ")";
+    }
+
+    return "";
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Execute single job on simulator owned by the worker thread
+///////////////////////////////////////////////////////////////////////////////////////////////////
+static void ExecuteJob(spect::CpuSimulator *simulator, const spect::CpuSnapshot &pristine,
+                       Job &job)
+{
+    const Program &program = programs[job.program];
+    if (!program.error.empty()) {
+        job.result = "Program " + program.path + " not available: " + program.error;
+        return;
+    }
+
+    spect::CpuModel *model = simulator->model_;
+    const std::string *opts = job.opts;
+
+    // Model is re-used, return it (including Key Memory) to the state before the first job
+    model->Restore(pristine);
+
+    // Decoded instructions are shared with models of other workers
+    model->SetProgramImage(program.image);
+
+    if (!opts[J_CONST_ROM_HEX].empty())
+        model->LoadHexFile(opts[J_CONST_ROM_HEX], SPECT_CONST_ROM_BASE);
+    if (!opts[J_DATA_RAM_IN_HEX].empty())
+        model->LoadHexFile(opts[J_DATA_RAM_IN_HEX], SPECT_DATA_RAM_IN_BASE);
+    if (!opts[J_EMEM_IN_HEX].empty())
+        model->LoadHexFile(opts[J_EMEM_IN_HEX], SPECT_EMEM_IN_BASE);
+
+    if (!opts[J_START_PC].empty()) {
+        uint32_t start_pc;
+        std::stringstream ss;
+        ss << std::hex << opts[J_START_PC];
+        ss >> start_pc;
+        model->SetStartPc(start_pc);
+    }
+
+    model->max_instr_cnt_ = max_instr_cnt;
+    if (!opts[J_MAX_INSTR_CNT].empty()) {
+        std::stringstream ss;
+        ss << opts[J_MAX_INSTR_CNT];
+        ss >> model->max_instr_cnt_;
+    }
+
+    if (!opts[J_GRV_HEX].empty()) {
+        std::vector<uint32_t> mem;
+        spect::HexHandler::LoadHexFile(opts[J_GRV_HEX], mem);
+        for (const auto &wrd : mem)
+            model->GrvQueuePush(wrd);
+    }
+
+    if (!opts[J_LOAD_KEYMEM].empty())
+        simulator->key_memory_->Load(opts[J_LOAD_KEYMEM]);
+
+    // Same sequence as 'spect_iss' in batch mode
+    model->Reset();
+    if (!opts[J_LOAD_CONTEXT].empty())
+        model->LoadContext(opts[J_LOAD_CONTEXT]);
+    if (!opts[J_LOAD_CONTEXT_DELTA].empty())
+        model->LoadContextDelta(opts[J_LOAD_CONTEXT_DELTA]);
+    model->SetContextBaseline();
+    model->Start();
+    model->Step(0);
+
+    if (!opts[J_DATA_RAM_OUT_HEX].empty())
+        model->DumpHexFile(opts[J_DATA_RAM_OUT_HEX], spect::HexFileType::ISS_WORD,
+                           SPECT_DATA_RAM_OUT_BASE, SPECT_DATA_RAM_OUT_SIZE);
+    if (!opts[J_EMEM_OUT_HEX].empty())
+        model->DumpHexFile(opts[J_EMEM_OUT_HEX], spect::HexFileType::ISS_WORD,
+                           SPECT_EMEM_OUT_BASE, SPECT_EMEM_OUT_SIZE);
+    if (!opts[J_DUMP_CONTEXT].empty())
+        model->DumpContext(opts[J_DUMP_CONTEXT], context_format);
+    if (!opts[J_DUMP_CONTEXT_DELTA].empty())
+        model->DumpContextDelta(opts[J_DUMP_CONTEXT_DELTA]);
+    if (!opts[J_DUMP_KEYMEM].empty())
+        simulator->key_memory_->Dump(opts[J_DUMP_KEYMEM], sparse_keymem);
+
+    if (!opts[J_EXPECT_DATA_RAM_OUT_HEX].empty()) {
+        job.result = CompareHex(opts[J_EXPECT_DATA_RAM_OUT_HEX], model, SPECT_DATA_RAM_OUT_BASE,
+                                SPECT_DATA_RAM_OUT_SIZE);
+        if (!job.result.empty())
+            return;
+    }
+
+    if (!opts[J_EXPECT_EMEM_OUT_HEX].empty()) {
+        job.result = CompareHex(opts[J_EXPECT_EMEM_OUT_HEX], model, SPECT_EMEM_OUT_BASE,
+                                SPECT_EMEM_OUT_SIZE);
+        if (!job.result.empty())
+            return;
+    }
+
+    job.passed = true;
+    job.result = std::to_string(model->instr_cnt_) + " instructions";
+    if (model->instr_cnt_ == model->max_instr_cnt_)
+        job.result += " (limit of executed instructions reached)";
+}
+
+
+int main(int argc, char** argv)
+{
+    argc-=(argc>0); argv+=(argc>0);
+    option::Stats  stats(usage, argc, argv);
+    option::Option options[stats.options_max], buffer[stats.buffer_max];
+    option::Parser parse(usage, argc, argv, options, buffer);
+
+    if (parse.error()) {
+        option::printUsage(std::cout, usage);
+        return 1;
+    }
+
+    bool has_unknown = false;
+    for (option::Option* opt = options[UNKNOWN]; opt; opt = opt->next()) {
+        std::cout << "Unknown option: " << opt->name << "\n";
+        has_unknown = true;
+    }
+
+    if (has_unknown) {
+        option::printUsage(std::cout, usage);
+        return 1;
+    }
+
+    if (options[HELP] || argc == 0) {
+        option::printUsage(std::cout, usage);
+        return 0;
+    }
+
+    if (options[VERSION]) {
+        std::cout << "SPECT Batch Instruction Set Simulator\n";
+        std::cout << "Version:  " TOOL_VERSION_TAG "\n";
+        std::cout << "GIT Hash: " TOOL_VERSION_HASH "\n";
+        return 0;
+    }
+
+    if (!options[MANIFEST] || !options[MANIFEST].arg) {
+        std::cout << "Manifest not specified, use '--manifest=<file>'\n";
+        return 1;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Options common to all jobs
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    if (options[ISA_VERSION]) {
+        std::stringstream ss;
+        ss << options[ISA_VERSION].arg;
+        ss >> isa_version;
+    }
+    std::cout << "Using ISA version: " << isa_version << std::endl;
+
+    if (options[PARITY]) {
+        if (*options[PARITY].arg == '1')
+            parity_type = spect::ParityType::ODD;
+        else if (*options[PARITY].arg == '2')
+            parity_type = spect::ParityType::EVEN;
+    }
+
+    if (options[FIRST_ADDR]) {
+        std::stringstream ss;
+        ss << std::hex << options[FIRST_ADDR].arg;
+        ss >> first_addr;
+    }
+
+    if (options[MAX_INSTR_CNT]) {
+        std::stringstream ss;
+        ss << options[MAX_INSTR_CNT].arg;
+        ss >> max_instr_cnt;
+    }
+
+    if (options[ENGINE]) {
+        std::string name = std::string(options[ENGINE].arg);
+        if (name == "reference") {
+            engine = spect::ExecEngine::REFERENCE;
+        } else if (name != "fast") {
+            std::cout << "Unknown execution engine: " << name << "\n";
+            option::printUsage(std::cout, usage);
+            return 1;
+        }
+    }
+
+    if (options[SPARSE_KEYMEM])
+        sparse_keymem = true;
+
+    if (options[CONTEXT_FORMAT]) {
+        std::string name = std::string(options[CONTEXT_FORMAT].arg);
+        if (name == "text") {
+            context_format = spect::ContextFormat::TEXT;
+        } else if (name != "binary") {
+            std::cout << "Unknown context format: " << name << "\n";
+            option::printUsage(std::cout, usage);
+            return 1;
+        }
+    }
+
+    unsigned num_threads = 0;
+    if (options[JOBS]) {
+        std::stringstream ss;
+        ss << options[JOBS].arg;
+        ss >> num_threads;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Load manifest and prepare programs
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    if (!ParseManifest(std::string(options[MANIFEST].arg)))
+        return 1;
+
+    for (auto &program : programs) {
+        PrepareProgram(program);
+        if (!program.error.empty())
+            std::cout << "Failed to prepare program " << program.path << ": " << program.error
+                      << "\n";
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Execute jobs, each worker thread re-uses its own simulator
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    spect::ThreadPool pool(num_threads);
+    std::vector<spect::CpuSimulator*> simulators;
+    std::vector<std::shared_ptr<const spect::CpuSnapshot>> pristine;
+    for (unsigned i = 0; i < pool.GetThreadCount(); i++) {
+        spect::CpuSimulator *simulator = new spect::CpuSimulator(isa_version);
+        simulator->model_->verbosity_ = VERBOSITY_NONE;
+        simulator->model_->SetParityType(parity_type);
+        simulator->model_->SetExecEngine(engine);
+        simulators.push_back(simulator);
+        pristine.push_back(simulator->model_->Snapshot());
+    }
+
+    std::cout << "Executing " << jobs.size() << " jobs on " << pool.GetThreadCount()
+              << " threads...\n";
+
+    std::mutex out_lock;
+    auto t_start = std::chrono::steady_clock::now();
+
+    pool.Run(jobs.size(), [&simulators, &pristine, &out_lock] (unsigned worker, size_t index) {
+        Job &job = jobs[index];
+        try {
+            ExecuteJob(simulators[worker], *pristine[worker], job);
+        } catch (std::exception &err) {
+            job.result = err.what();
+        }
+
+        std::lock_guard<std::mutex> guard(out_lock);
+        std::cout << (job.passed ? "PASSED" : "FAILED") << " (line " << job.line_nr << "): "
+                  << job.result << "\n";
+    });
+
+    std::chrono::duration<double> t_run = std::chrono::steady_clock::now() - t_start;
+
+    for (auto simulator : simulators)
+        delete simulator;
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Summary
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    size_t failed = 0;
+    for (const auto &job : jobs)
+        if (!job.passed)
+            failed++;
+
+    std::cout << std::string(80, '*') << "\n";
+    std::cout << "Jobs: " << jobs.size() << ", Passed: " << jobs.size() - failed << ", Failed: "
+              << failed << ", Time: " << t_run.count() << " s\n";
+    for (const auto &job : jobs)
+        if (!job.passed)
+            std::cout << "    Failed job (line " << job.line_nr << "): " << job.line << "\n";
+    std::cout << std::string(80, '*') << "\n";
+
+    return (failed > 0) ? 1 : 0;
+}
@@ -12,6 +12,7 @@
 #include <string>
 #include <sstream>
 #include <exception>
+#include <vector>
 
 #include "CpuModel.h"
 
@@ -32,7 +33,9 @@ enum  optionIndex {
     ISA_VERSION,
     PARITY,
     DUMP_PROGRAM,
-    DUMP_SYMBOLS
+    DUMP_SYMBOLS,
+    VERBOSE,
+    JOBS
 };
 
 const option::Descriptor usage[] =
@@ -55,6 +58,8 @@ const option::Descriptor usage[] =
                                                                             "                           else - No parity (default).\n"},
     {DUMP_PROGRAM,     0,  ""  ,    "dump-program"  ,option::Arg::Optional, "  --dump-program=<file>   File where program to dump compiled program (.s file with addresses)\n"},
     {DUMP_SYMBOLS,     0,  ""  ,    "dump-symbols"  ,option::Arg::Optional, "  --dump-symbols=<file>   File where dump all symbols found during compilation.\n"},
+    {VERBOSE,          0,  ""  ,    "verbose"       ,option::Arg::None,     "  --verbose               Print symbols as they are added and resolved during compilation.\n"},
+    {JOBS,             0,  "j" ,    "jobs"          ,option::Arg::Optional, "  --jobs=<n>              Number of threads parsing source files (default = number of hardware threads).\n"},
 
     {0,0,0,0,0,0}
 };
@@ -97,16 +102,24 @@ int main(int argc, char** argv)
         return 0;
     }
 
+    int isa_version = DEFAULT_ISA_VERSION;
     if (options[ISA_VERSION]) {
         std::stringstream ss;
-        int isa_version;
         ss << options[ISA_VERSION].arg;
         ss >> isa_version;
-        spect::InstructionFactory::SetActiveISAVersion(isa_version);
     }
-    std::cout << "Using ISA version: " << spect::InstructionFactory::GetActiveISAVersion() << std::endl;
+    std::cout << "Using ISA version: " << isa_version << std::endl;
 
-    comp = new spect::Compiler();
+    comp = new spect::Compiler(isa_version);
+    if (options[VERBOSE])
+        comp->symbols_->verbose_ = true;
+
+    comp->num_threads_ = 0;
+    if (options[JOBS]) {
+        std::stringstream ss;
+        ss << options[JOBS].arg;
+        ss >> comp->num_threads_;
+    }
     uint32_t first_addr = SPECT_INSTR_MEM_BASE;
 
     if (options[FIRST_ADDR]) {
@@ -120,11 +133,12 @@ int main(int argc, char** argv)
     comp->CompileInit(first_addr);
 
     // All remaining arguments are input source files
+    std::vector<std::string> paths;
+    for (int i = 0; i < parse.nonOptionsCount(); ++i)
+        paths.push_back(parse.nonOption(i));
+
     EXEC_WITH_ERR_HANDLER({
-        for (int i = 0; i < parse.nonOptionsCount(); ++i) {
-            std::string path = parse.nonOption(i);
-            comp->Compile(path);
-        }
+        comp->Compile(paths);
     }, {delete comp;})
 
 
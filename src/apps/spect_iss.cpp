@@ -39,10 +39,15 @@ enum  optionIndex {
     MAX_INSTR_CNT,
     DUMP_CONTEXT,
     LOAD_CONTEXT,
+    DUMP_CONTEXT_DELTA,
+    LOAD_CONTEXT_DELTA,
     DUMP_KEYMEM,
+    SPARSE_KEYMEM,
     LOAD_KEYMEM,
     TIMING_ACCURATE,
-    EXEC_TIME_STEP
+    EXEC_TIME_STEP,
+    ENGINE,
+    CONTEXT_FORMAT
 };
 
 const option::Descriptor usage[] =
@@ -74,10 +79,20 @@ const option::Descriptor usage[] =
     {MAX_INSTR_CNT,         0,  ""  ,    "max-instr-cnt"        ,option::Arg::Optional,     "  --max-instr-cnt=<n>          Limit for number of instructions executed by the simulator. When reached, simulator exits (default = 10^8). Decimal value. \n"},
     {DUMP_CONTEXT,          0,  ""  ,    "dump-context"         ,option::Arg::Optional,     "  --dump-context=<file>        Dump context (state of CPU - GPR registers, Memory content, Hash unit context, RAR stack) after execution to file. \n"},
     {LOAD_CONTEXT,          0,  ""  ,    "load-context"         ,option::Arg::Optional,     "  --load-context=<file>        Load context (state of CPU - GPR registers, Memory content, Hash unit context, RAR stack) before execution from file. \n"},
+    {DUMP_CONTEXT_DELTA,    0,  ""  ,    "dump-context-delta"   ,option::Arg::Optional,     "  --dump-context-delta=<file>  Dump only parts of context changed by the execution to file. \n"},
+    {LOAD_CONTEXT_DELTA,    0,  ""  ,    "load-context-delta"   ,option::Arg::Optional,     "  --load-context-delta=<file>  Apply context delta on top of context loaded by '--load-context' before execution. \n"},
     {DUMP_KEYMEM,           0,  ""  ,    "dump-keymem"          ,option::Arg::Optional,     "  --dump-keymem=<file>         Dump Key memory after execution to file. \n"},
+    {SPARSE_KEYMEM,         0,  ""  ,    "sparse-keymem"        ,option::Arg::Optional,     "  --sparse-keymem              Dump only used slots of Key memory by '--dump-keymem' (slots not in the file are empty). \n"},
     {LOAD_KEYMEM,           0,  ""  ,    "load-keymem"          ,option::Arg::Optional,     "  --load-keymem=<file>         Load Key memory before execution from file. \n"},
     {TIMING_ACCURATE,       0,  ""  ,    "timing-accurate"      ,option::Arg::Optional,     "  --timing-accurate            Launch simulator in the timing accurate mode.\n"},
     {EXEC_TIME_STEP,        0,  ""  ,    "execution-time-step"  ,option::Arg::Optional,     "  --execution-time-step=<n>    Instruction execution time step (in us) for timing accurate simulation (default = 10).\n"},
+    {ENGINE,                0,  ""  ,    "engine"               ,option::Arg::Optional,     "  --engine=<engine>            Instruction execution engine:\n"
+                                                                                            "                                   reference - Executes each instruction object, prints all debug info (default).\n"
+                                                                                            "                                   fast      - Executes pre-decoded instructions via handler table, does not print\n"
+                                                                                            "                                               per-instruction debug info.\n"},
+    {CONTEXT_FORMAT,        0,  ""  ,    "context-format"       ,option::Arg::Optional,     "  --context-format=<format>    Format of context dumped by '--dump-context' ('--load-context' detects format):\n"
+                                                                                            "                                   binary - Binary with header and checksum, fast to load (default).\n"
+                                                                                            "                                   text   - Human readable, one hex value per line.\n"},
 
     {0,0,0,0,0,0}
 };
@@ -123,19 +138,18 @@ int main(int argc, char** argv)
     ///////////////////////////////////////////////////////////////////////////////////////////////
     // Configure used ISA version
     ///////////////////////////////////////////////////////////////////////////////////////////////
+    int isa_version = DEFAULT_ISA_VERSION;
     if (options[ISA_VERSION]) {
         std::stringstream ss;
-        int isa_version;
         ss << options[ISA_VERSION].arg;
         ss >> isa_version;
-        spect::InstructionFactory::SetActiveISAVersion(isa_version);
     }
-    std::cout << "Using ISA version: " << spect::InstructionFactory::GetActiveISAVersion() << std::endl;
+    std::cout << "Using ISA version: " << isa_version << std::endl;
 
     ///////////////////////////////////////////////////////////////////////////////////////////////
     // Initialize CPU simulator
     ///////////////////////////////////////////////////////////////////////////////////////////////
-    simulator = new spect::CpuSimulator();
+    simulator = new spect::CpuSimulator(isa_version);
 
     ///////////////////////////////////////////////////////////////////////////////////////////////
     // Configure parity type
@@ -152,8 +166,6 @@ int main(int argc, char** argv)
     ///////////////////////////////////////////////////////////////////////////////////////////////
     // Compile the program if '.s' file passed on Command line and Preload memories
     ///////////////////////////////////////////////////////////////////////////////////////////////
-    uint32_t *m_mem = simulator->model_->GetMemoryPtr();
-
     uint32_t first_addr = SPECT_INSTR_MEM_BASE;
     if (options[PROGRAM] && options[FIRST_ADDR]) {
         std::stringstream ss;
@@ -175,7 +187,7 @@ int main(int argc, char** argv)
 
         EXEC_WITH_ERR_HANDLER({
             std::string path = std::string(options[INSTRUCTION_MEM_HEX].arg);
-            spect::HexHandler::LoadHexFile(path, m_mem, SPECT_INSTR_MEM_BASE);
+            simulator->model_->LoadHexFile(path, SPECT_INSTR_MEM_BASE);
         }, {delete simulator;})
     }
 
@@ -190,29 +202,32 @@ int main(int argc, char** argv)
             simulator->compiler_->print_fnc(line.c_str());
             simulator->compiler_->Compile(ss.str());
             simulator->compiler_->CompileFinish();
-            uint32_t *p_start = m_mem + (simulator->compiler_->program_->first_addr_ >> 2);
+            std::vector<uint32_t> mem(SPECT_TOTAL_MEM_SIZE / 4);
+            simulator->model_->ReadMemoryBlock(0, mem.data(), SPECT_TOTAL_MEM_SIZE);
+            uint32_t *p_start = mem.data() + (simulator->compiler_->program_->first_addr_ >> 2);
             simulator->compiler_->program_->Assemble(p_start, parity_type);
+            simulator->model_->WriteMemoryBlock(0, mem.data(), SPECT_TOTAL_MEM_SIZE);
         }, {delete simulator;})
     }
 
     if (options[CONST_ROM_HEX]) {
         EXEC_WITH_ERR_HANDLER({
             std::string path = std::string(options[CONST_ROM_HEX].arg);
-            spect::HexHandler::LoadHexFile(path, m_mem, SPECT_CONST_ROM_BASE);
+            simulator->model_->LoadHexFile(path, SPECT_CONST_ROM_BASE);
         }, {delete simulator;})
     }
 
     if (options[DATA_RAM_IN_HEX]) {
         EXEC_WITH_ERR_HANDLER({
             std::string path = std::string(options[DATA_RAM_IN_HEX].arg);
-            spect::HexHandler::LoadHexFile(path, m_mem, SPECT_DATA_RAM_IN_BASE);
+            simulator->model_->LoadHexFile(path, SPECT_DATA_RAM_IN_BASE);
         }, {delete simulator;})
     }
 
     if (options[EMEM_IN_HEX]) {
         EXEC_WITH_ERR_HANDLER({
             std::string path = std::string(options[EMEM_IN_HEX].arg);
-            spect::HexHandler::LoadHexFile(path, m_mem, SPECT_EMEM_IN_BASE);
+            simulator->model_->LoadHexFile(path, SPECT_EMEM_IN_BASE);
         }, {delete simulator;})
     }
 
@@ -260,6 +275,37 @@ int main(int argc, char** argv)
         ss >> simulator->model_->execution_time_step_;
     }
 
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Configure execution engine
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    if (options[ENGINE]) {
+        std::string engine = std::string(options[ENGINE].arg);
+        if (engine == "fast") {
+            simulator->model_->SetExecEngine(spect::ExecEngine::FAST);
+        } else if (engine != "reference") {
+            std::cout << "Unknown execution engine: " << engine << "\n";
+            option::printUsage(std::cout, usage);
+            delete simulator;
+            return 1;
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Configure format of dumped context
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    spect::ContextFormat context_format = spect::ContextFormat::BINARY;
+    if (options[CONTEXT_FORMAT]) {
+        std::string format = std::string(options[CONTEXT_FORMAT].arg);
+        if (format == "text") {
+            context_format = spect::ContextFormat::TEXT;
+        } else if (format != "binary") {
+            std::cout << "Unknown context format: " << format << "\n";
+            option::printUsage(std::cout, usage);
+            delete simulator;
+            return 1;
+        }
+    }
+
     ///////////////////////////////////////////////////////////////////////////////////////////////
     // Feed the GRV data to CPU model
     ///////////////////////////////////////////////////////////////////////////////////////////////
@@ -292,6 +338,9 @@ int main(int argc, char** argv)
     if (options[LOAD_CONTEXT])
         simulator->model_context_ = std::string(options[LOAD_CONTEXT].arg);
 
+    if (options[LOAD_CONTEXT_DELTA])
+        simulator->model_context_delta_ = std::string(options[LOAD_CONTEXT_DELTA].arg);
+
     if (options[LOAD_KEYMEM])
         simulator->key_memory_->Load(std::string(options[LOAD_KEYMEM].arg));
 
@@ -300,23 +349,26 @@ int main(int argc, char** argv)
     }, {delete simulator;})
 
     if (options[DATA_RAM_OUT_HEX]) {
-        spect::HexHandler::DumpHexFile(std::string(options[DATA_RAM_OUT_HEX].arg),
-            spect::HexFileType::ISS_WORD, simulator->model_->GetMemoryPtr(), SPECT_DATA_RAM_OUT_BASE,
-            SPECT_DATA_RAM_OUT_SIZE);
+        simulator->model_->DumpHexFile(std::string(options[DATA_RAM_OUT_HEX].arg),
+            spect::HexFileType::ISS_WORD, SPECT_DATA_RAM_OUT_BASE, SPECT_DATA_RAM_OUT_SIZE);
     }
 
     if (options[EMEM_OUT_HEX]) {
-        spect::HexHandler::DumpHexFile(std::string(options[EMEM_OUT_HEX].arg),
-            spect::HexFileType::ISS_WORD, simulator->model_->GetMemoryPtr(), SPECT_EMEM_OUT_BASE,
-            SPECT_EMEM_OUT_SIZE);
+        simulator->model_->DumpHexFile(std::string(options[EMEM_OUT_HEX].arg),
+            spect::HexFileType::ISS_WORD, SPECT_EMEM_OUT_BASE, SPECT_EMEM_OUT_SIZE);
     }
 
     if (options[DUMP_CONTEXT]) {
-        simulator->model_->DumpContext(std::string(options[DUMP_CONTEXT].arg));
+        simulator->model_->DumpContext(std::string(options[DUMP_CONTEXT].arg), context_format);
+    }
+
+    if (options[DUMP_CONTEXT_DELTA]) {
+        simulator->model_->DumpContextDelta(std::string(options[DUMP_CONTEXT_DELTA].arg));
     }
 
     if (options[DUMP_KEYMEM]) {
-        simulator->key_memory_->Dump(std::string(options[DUMP_KEYMEM].arg));
+        simulator->key_memory_->Dump(std::string(options[DUMP_KEYMEM].arg),
+                                     options[SPARSE_KEYMEM] ? true : false);
     }
 
     return 0;
@@ -7,6 +7,7 @@
 **************************************************************************************************/
 
 #include <stdio.h>
+#include <algorithm>
 #include <iostream>
 #include <cassert>
 
@@ -15,112 +16,148 @@
 #include "Compiler.h"
 #include "CpuModel.h"
 #include "CpuProgram.h"
-#include "HexHandler.h"
 
 #include "vpi_user.h"
 
 #include "spect_iss_dpi.h"
 
-spect::Compiler *compiler = nullptr;
-spect::CpuModel *model    = nullptr;
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// SPECT model instance. Each instance has its own model and compiler.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct spect_dpi_ctx {
+    spect::CpuModel *model    = nullptr;
+    spect::Compiler *compiler = nullptr;
+};
+
+// Instance used by functions without 'ctx' argument, created by 'spect_dpi_init'
+spect_dpi_ctx_t *default_ctx = nullptr;
 
 #define DPI_CALL_LOG_ENTER                                                                          \
-    assert (model != nullptr &&                                                         \
+    assert (ctx != nullptr &&                                                                       \
             MODEL_LABEL " Model not initalized. Did you forget to call 'spect_dpi_init'?");         \
-    if (model->verbosity_ >= VERBOSITY_HIGH)                                            \
+    if (ctx->model->verbosity_ >= VERBOSITY_HIGH)                                                   \
         vpi_printf("%s DPI function '%s' entered.\n", MODEL_LABEL, __func__);                       \
 
 #define DPI_CALL_LOG_EXIT                                                                           \
-    if (model->verbosity_ >= VERBOSITY_HIGH)                                            \
+    if (ctx->model->verbosity_ >= VERBOSITY_HIGH)                                                   \
         vpi_printf("%s DPI function '%s' exiting.\n", MODEL_LABEL, __func__);                       \
 
+// Exceptions shall not cross DPI boundary to the simulator, report error instead
+static uint32_t exec_error(const std::exception &e)
+{
+    vpi_printf("%s Failed to execute program: %s\n", MODEL_LABEL, e.what());
+    return SPECT_DPI_EXEC_ERROR;
+}
+
 extern "C" {
 
-    uint32_t spect_dpi_init()
+    spect_dpi_ctx_t* spect_dpi_create(int isa_version)
     {
         vpi_printf("%s DPI function '%s' entered.\n", MODEL_LABEL, __func__);
 
-        uint32_t rv = 0;
+        if (isa_version < 1 || isa_version > NUM_ISA_VERSIONS) {
+            vpi_printf("%s Failed to initialize SPECT DPI model: Invalid ISA version: %d\n",
+                       MODEL_LABEL, isa_version);
+            return nullptr;
+        }
+
+        spect_dpi_ctx_t *ctx = nullptr;
         try {
-            model    = new spect::CpuModel(SPECT_INSTR_MEM_AHB_W, SPECT_INSTR_MEM_AHB_R);
-            compiler = new spect::Compiler();
+            ctx = new spect_dpi_ctx_t();
+            ctx->model    = new spect::CpuModel(isa_version, SPECT_INSTR_MEM_AHB_W, SPECT_INSTR_MEM_AHB_R);
+            ctx->compiler = new spect::Compiler(isa_version);
+
+            // Testbench reads last executed instruction after each step
+            ctx->model->instr_sampling_ = true;
 
             // According to C standard, typecasting function pointer is undefined behavior,
             // but we only get rid of "const", so we hope its fine :)
-            model->print_fnc = (int (*)(const char *format, ...))(&(vpi_printf));
-            compiler->print_fnc = (int (*)(const char *format, ...))(&(vpi_printf));
+            ctx->model->print_fnc = (int (*)(const char *format, ...))(&(vpi_printf));
+            ctx->compiler->print_fnc = (int (*)(const char *format, ...))(&(vpi_printf));
         } catch (const std::bad_alloc& e) {
             vpi_printf("%s Failed to initialize SPECT DPI model: %s\n", MODEL_LABEL, e.what());
-            rv = 1;
+            if (ctx) {
+                delete ctx->model;
+                delete ctx->compiler;
+                delete ctx;
+                ctx = nullptr;
+            }
         }
 
         vpi_printf("%s DPI function '%s' exiting.\n", MODEL_LABEL, __func__);
-        return rv;
+        return ctx;
     }
 
-    void spect_dpi_exit()
+    void spect_dpi_destroy(spect_dpi_ctx_t *ctx)
     {
         vpi_printf("%s DPI function '%s' entered.\n", MODEL_LABEL, __func__);
 
-        delete model;
-        delete compiler;
+        if (ctx) {
+            delete ctx->model;
+            delete ctx->compiler;
+            delete ctx;
+        }
 
         vpi_printf("%s DPI function '%s' exiting.\n", MODEL_LABEL, __func__);
     }
 
-    void spect_dpi_reset()
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Functions operating on instance 'ctx'
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+
+    void spect_dpi_ctx_reset(spect_dpi_ctx_t *ctx)
     {
         DPI_CALL_LOG_ENTER
-        model->Reset();
+        ctx->model->Reset();
         DPI_CALL_LOG_EXIT
     }
 
-    void spect_dpi_start()
+    void spect_dpi_ctx_start(spect_dpi_ctx_t *ctx)
     {
         DPI_CALL_LOG_ENTER
-        model->Start();
+        ctx->model->Start();
         DPI_CALL_LOG_EXIT
     }
 
-    uint32_t spect_dpi_is_program_finished()
+    uint32_t spect_dpi_ctx_is_program_finished(spect_dpi_ctx_t *ctx)
     {
         DPI_CALL_LOG_ENTER
-        uint32_t rv = model->IsFinished();
+        uint32_t rv = ctx->model->IsFinished();
         DPI_CALL_LOG_EXIT
         return rv;
     }
 
-    uint32_t spect_dpi_get_memory(uint32_t addr)
+    uint32_t spect_dpi_ctx_get_memory(spect_dpi_ctx_t *ctx, uint32_t addr)
     {
         DPI_CALL_LOG_ENTER
-        uint32_t rv = model->GetMemory(addr);
+        uint32_t rv = ctx->model->GetMemory(addr);
         DPI_CALL_LOG_EXIT
         return rv;
     }
 
-    void spect_dpi_set_memory(uint32_t addr, uint32_t data)
+    void spect_dpi_ctx_set_memory(spect_dpi_ctx_t *ctx, uint32_t addr, uint32_t data)
     {
         DPI_CALL_LOG_ENTER
-        model->SetMemory(addr, data);
+        ctx->model->SetMemory(addr, data);
         DPI_CALL_LOG_EXIT
     }
 
-    uint32_t spect_dpi_ahb_read(uint32_t addr)
+    uint32_t spect_dpi_ctx_ahb_read(spect_dpi_ctx_t *ctx, uint32_t addr)
     {
         DPI_CALL_LOG_ENTER
-        uint32_t rv = model->ReadMemoryAhb(addr);
+        uint32_t rv = ctx->model->ReadMemoryAhb(addr);
         DPI_CALL_LOG_EXIT
         return rv;
     }
 
-    void spect_dpi_ahb_write(uint32_t addr, uint32_t data)
+    void spect_dpi_ctx_ahb_write(spect_dpi_ctx_t *ctx, uint32_t addr, uint32_t data)
     {
         DPI_CALL_LOG_ENTER
-        model->WriteMemoryAhb(addr, data);
+        ctx->model->WriteMemoryAhb(addr, data);
         DPI_CALL_LOG_EXIT
     }
 
-    uint32_t spect_dpi_get_mem_base(dpi_mem_type_t mem_type)
+    uint32_t spect_dpi_ctx_get_mem_base(spect_dpi_ctx_t *ctx, dpi_mem_type_t mem_type)
     {
         DPI_CALL_LOG_ENTER
         uint32_t rv = 0;
@@ -144,7 +181,7 @@ extern "C" {
         return rv;
     }
 
-    uint32_t spect_dpi_get_mem_size(dpi_mem_type_t mem_type)
+    uint32_t spect_dpi_ctx_get_mem_size(spect_dpi_ctx_t *ctx, dpi_mem_type_t mem_type)
     {
         DPI_CALL_LOG_ENTER
         uint32_t rv = 0;
@@ -168,37 +205,38 @@ extern "C" {
         return rv;
     }
 
-    uint32_t spect_dpi_get_gpr_part(uint32_t gpr, uint32_t part)
+    uint32_t spect_dpi_ctx_get_gpr_part(spect_dpi_ctx_t *ctx, uint32_t gpr, uint32_t part)
     {
         DPI_CALL_LOG_ENTER
-        uint256_t tmp = (model->GetGpr(gpr) >> (part * 32)) & uint256_t("0xFFFFFFFF");
+        uint256_t tmp = (ctx->model->GetGpr(gpr) >> (part * 32)) & uint256_t("0xFFFFFFFF");
         DPI_CALL_LOG_EXIT
         return (uint32_t)tmp;
     }
 
-    void spect_dpi_set_gpr_part(uint32_t gpr, uint32_t part, uint32_t data)
+    void spect_dpi_ctx_set_gpr_part(spect_dpi_ctx_t *ctx, uint32_t gpr, uint32_t part,
+                                    uint32_t data)
     {
         DPI_CALL_LOG_ENTER
         uint256_t mask = ~(uint256_t("0xFFFFFFFF") << (part * 32));
-        uint256_t tmp = model->GetGpr(gpr) & mask;
+        uint256_t tmp = ctx->model->GetGpr(gpr) & mask;
         tmp = tmp | (uint256_t(data) << (part * 32));
-        model->SetGpr(gpr, tmp);
+        ctx->model->SetGpr(gpr, tmp);
         DPI_CALL_LOG_EXIT
     }
 
-    uint32_t spect_dpi_get_flag(dpi_flag_type_t flag_type)
+    uint32_t spect_dpi_ctx_get_flag(spect_dpi_ctx_t *ctx, dpi_flag_type_t flag_type)
     {
         DPI_CALL_LOG_ENTER
         uint32_t rv;
         switch (flag_type) {
         case DPI_SPECT_FLAG_ZERO:
-            rv = model->GetCpuFlags().zero;
+            rv = ctx->model->GetCpuFlags().zero;
             break;
         case DPI_SPECT_FLAG_CARRY:
-            rv = model->GetCpuFlags().carry;
+            rv = ctx->model->GetCpuFlags().carry;
             break;
         case DPI_SPECT_FLAG_ERROR:
-            rv = model->GetCpuFlags().error;
+            rv = ctx->model->GetCpuFlags().error;
             break;
         default:
             rv = 0;
@@ -207,27 +245,28 @@ extern "C" {
         return rv;
     }
 
-    uint32_t spect_dpi_get_pc()
+    uint32_t spect_dpi_ctx_get_pc(spect_dpi_ctx_t *ctx)
     {
         DPI_CALL_LOG_ENTER
-        uint32_t rv = (uint32_t)model->GetPc();
+        uint32_t rv = (uint32_t)ctx->model->GetPc();
         DPI_CALL_LOG_EXIT
         return rv;
     }
 
-    void spect_dpi_set_pc(uint32_t value)
+    void spect_dpi_ctx_set_pc(spect_dpi_ctx_t *ctx, uint32_t value)
     {
         DPI_CALL_LOG_ENTER
-        model->SetPc((uint16_t)value);
+        ctx->model->SetPc((uint16_t)value);
         DPI_CALL_LOG_EXIT
     }
 
-    void spect_dpi_dump_instruction(uint32_t address, char *buf)
+    void spect_dpi_ctx_dump_instruction(spect_dpi_ctx_t *ctx, uint32_t address, char *buf)
     {
         DPI_CALL_LOG_ENTER
         spect::Instruction *i = spect::Instruction::DisAssemble(
-            model->GetParityType(),
-            model->GetMemory(((uint16_t)address) >> 2));
+            ctx->model->GetIsaVersion(),
+            ctx->model->GetParityType(),
+            ctx->model->GetMemory(((uint16_t)address) >> 2));
         // TODO: How to handle free here? System Verilog side needs to free the buffer!
         buf = new char[32];
         std::stringstream ss;
@@ -237,53 +276,53 @@ extern "C" {
         DPI_CALL_LOG_EXIT
     }
 
-    uint32_t spect_dpi_get_rar_value(uint32_t address)
+    uint32_t spect_dpi_ctx_get_rar_value(spect_dpi_ctx_t *ctx, uint32_t address)
     {
         DPI_CALL_LOG_ENTER
-        uint32_t rv = model->GetRarAt(address);
+        uint32_t rv = ctx->model->GetRarAt(address);
         DPI_CALL_LOG_EXIT
         return rv;
     }
 
-    uint32_t spect_dpi_get_rar_sp()
+    uint32_t spect_dpi_ctx_get_rar_sp(spect_dpi_ctx_t *ctx)
     {
         DPI_CALL_LOG_ENTER
-        uint32_t rv = model->GetRarSp();
+        uint32_t rv = ctx->model->GetRarSp();
         DPI_CALL_LOG_EXIT
         return rv;
     }
 
-    void spect_dpi_push_grv_queue(uint32_t data)
+    void spect_dpi_ctx_push_grv_queue(spect_dpi_ctx_t *ctx, uint32_t data)
     {
         DPI_CALL_LOG_ENTER
-        model->GrvQueuePush(data);
+        ctx->model->GrvQueuePush(data);
         DPI_CALL_LOG_EXIT
     }
 
-    void spect_dpi_push_ldk_queue(uint32_t data)
+    void spect_dpi_ctx_push_ldk_queue(spect_dpi_ctx_t *ctx, uint32_t data)
     {
         DPI_CALL_LOG_ENTER
-        model->LdkQueuePush(data);
+        ctx->model->LdkQueuePush(data);
         DPI_CALL_LOG_EXIT
     }
 
-    void spect_dpi_push_kbus_error_queue(uint8_t error)
+    void spect_dpi_ctx_push_kbus_error_queue(spect_dpi_ctx_t *ctx, uint8_t error)
     {
         DPI_CALL_LOG_ENTER
-        model->KbusErrorQueuePush(error);
+        ctx->model->KbusErrorQueuePush(error);
         DPI_CALL_LOG_EXIT
     }
 
-    uint32_t spect_dpi_get_interrupt(dpi_int_type_t int_type)
+    uint32_t spect_dpi_ctx_get_interrupt(spect_dpi_ctx_t *ctx, dpi_int_type_t int_type)
     {
         DPI_CALL_LOG_ENTER
         uint32_t rv = 0;
         switch (int_type) {
         case DPI_SPECT_INT_DONE :
-            rv = model->GetInterrrupt(spect::CpuIntType::INT_DONE);
+            rv = ctx->model->GetInterrrupt(spect::CpuIntType::INT_DONE);
             break;
         case DPI_SPECT_INT_ERR :
-            rv = model->GetInterrrupt(spect::CpuIntType::INT_ERR);
+            rv = ctx->model->GetInterrrupt(spect::CpuIntType::INT_ERR);
             break;
         default:
             rv = 0;
@@ -292,17 +331,17 @@ extern "C" {
         return rv;
     }
 
-    uint32_t spect_dpi_compile_program(const char *program_path, const char* hex_path,
-                                       const dpi_hex_file_type_t hex_format,
-                                       const dpi_parity_type_t parity_type,
-                                       uint32_t first_addr)
+    uint32_t spect_dpi_ctx_compile_program(spect_dpi_ctx_t *ctx, const char *program_path,
+                                           const char* hex_path,
+                                           const dpi_hex_file_type_t hex_format,
+                                           const dpi_parity_type_t parity_type, uint32_t first_addr)
     {
         DPI_CALL_LOG_ENTER
         uint32_t err;
 
         try {
-            compiler->CompileInit(first_addr);
-            compiler->Compile(std::string(program_path));
+            ctx->compiler->CompileInit(first_addr);
+            ctx->compiler->Compile(std::string(program_path));
 
             spect::HexFileType internal_hex_type;
             switch (hex_format) {
@@ -329,9 +368,9 @@ extern "C" {
                 internal_parity_type = spect::ParityType::NONE;
                 break;
             }
-            err = compiler->CompileFinish();
+            err = ctx->compiler->CompileFinish();
             if (!err)
-                compiler->program_->Assemble(
+                ctx->compiler->program_->Assemble(
                     std::string(hex_path),
                     (spect::HexFileType) internal_hex_type,
                     internal_parity_type);
@@ -346,10 +385,10 @@ extern "C" {
         return err;
     }
 
-    uint32_t spect_dpi_get_compiled_program_start_address()
+    uint32_t spect_dpi_ctx_get_compiled_program_start_address(spect_dpi_ctx_t *ctx)
     {
         DPI_CALL_LOG_ENTER
-        spect::Symbol* s_start_addr = compiler->symbols_->GetSymbol(START_SYMBOL);
+        spect::Symbol* s_start_addr = ctx->compiler->symbols_->GetSymbol(START_SYMBOL);
         uint32_t rv = 0;
         if (s_start_addr)
             rv = s_start_addr->val_;
@@ -359,79 +398,136 @@ extern "C" {
         return rv;
     }
 
-    void spect_dpi_set_model_start_pc(uint32_t start_pc)
+    void spect_dpi_ctx_set_model_start_pc(spect_dpi_ctx_t *ctx, uint32_t start_pc)
     {
         DPI_CALL_LOG_ENTER
-        model->SetStartPc(start_pc);
+        ctx->model->SetStartPc(start_pc);
         DPI_CALL_LOG_EXIT
     }
 
-    uint32_t spect_dpi_load_hex_file(const char *path, const uint32_t offset)
+    uint32_t spect_dpi_ctx_load_hex_file(spect_dpi_ctx_t *ctx, const char *path,
+                                         const uint32_t offset)
     {
         DPI_CALL_LOG_ENTER
-        spect::HexHandler::LoadHexFile(std::string(path), model->GetMemoryPtr(), offset);
+        ctx->model->LoadHexFile(std::string(path), offset);
         // TODO: Here it might be good to check that hex file spans out of
         //       memory.
         DPI_CALL_LOG_EXIT
         return 0;
     }
 
-    uint32_t spect_dpi_program_step(uint32_t cycle_count)
+    uint32_t spect_dpi_ctx_program_step(spect_dpi_ctx_t *ctx, uint32_t cycle_count)
     {
         DPI_CALL_LOG_ENTER
-        uint32_t rv = model->StepSingle(cycle_count);
+        uint32_t rv;
+        try {
+            rv = ctx->model->StepSingle(cycle_count);
+        } catch (const std::exception &e) {
+            rv = exec_error(e);
+        }
         DPI_CALL_LOG_EXIT
         return rv;
     }
 
-    void spect_dpi_get_last_instr(dpi_instruction_t *dpi_instruction)
+    void spect_dpi_ctx_get_last_instr(spect_dpi_ctx_t *ctx, dpi_instruction_t *dpi_instruction)
     {
         DPI_CALL_LOG_ENTER
-        model->GetLastInstruction(dpi_instruction);
+        ctx->model->GetLastInstruction(dpi_instruction);
         DPI_CALL_LOG_EXIT
     }
 
-    void spect_dpi_set_change_reporting(uint32_t enable)
+    void spect_dpi_ctx_set_instr_sampling(spect_dpi_ctx_t *ctx, uint32_t enable)
     {
         DPI_CALL_LOG_ENTER
-        model->change_reporting_ = enable;
+        ctx->model->instr_sampling_ = enable;
         DPI_CALL_LOG_EXIT
     }
 
-    uint32_t spect_dpi_get_model_change(dpi_state_change_t *change)
+    void spect_dpi_ctx_set_change_reporting(spect_dpi_ctx_t *ctx, uint32_t enable)
+    {
+        DPI_CALL_LOG_ENTER
+        ctx->model->change_reporting_ = enable;
+        DPI_CALL_LOG_EXIT
+    }
+
+    uint32_t spect_dpi_ctx_set_change_queue(spect_dpi_ctx_t *ctx, uint32_t capacity,
+                                            uint32_t overflow)
+    {
+        DPI_CALL_LOG_ENTER
+        uint32_t rv = 1;
+        if (overflow <= static_cast<uint32_t>(spect::ChangeQueueOverflow::GROW)) {
+            ctx->model->ConfigureChangeQueue(capacity, static_cast<spect::ChangeQueueOverflow>(overflow));
+            rv = 0;
+        }
+        DPI_CALL_LOG_EXIT
+        return rv;
+    }
+
+    uint32_t spect_dpi_ctx_get_model_change(spect_dpi_ctx_t *ctx, dpi_state_change_t *change)
     {
         DPI_CALL_LOG_ENTER
         uint32_t rv;
-        if (!model->HasChange()) {
+        if (!ctx->model->HasChange()) {
             rv = 1;
         } else {
-            *change = model->ConsumeChange();
+            *change = ctx->model->ConsumeChange();
             rv = 0;
         }
         DPI_CALL_LOG_EXIT
         return rv;
     }
 
-    uint32_t spect_dpi_program_run(uint32_t instructions)
+    uint32_t spect_dpi_ctx_get_model_changes(spect_dpi_ctx_t *ctx, dpi_state_change_t *buf,
+                                             uint32_t max, uint32_t *count)
     {
         DPI_CALL_LOG_ENTER
-        uint32_t rv = model->Step(instructions);
+        *count = ctx->model->ConsumeChanges(buf, std::min<uint32_t>(max, SPECT_DPI_CHANGE_BATCH));
+        uint32_t rv = ctx->model->HasChange() ? 1 : 0;
         DPI_CALL_LOG_EXIT
         return rv;
     }
 
-    void spect_dpi_set_verbosity(uint32_t level)
+    uint32_t spect_dpi_ctx_program_step_collect(spect_dpi_ctx_t *ctx, uint32_t cycle_count,
+                                                dpi_state_change_t *buf, uint32_t max,
+                                                uint32_t *count)
     {
         DPI_CALL_LOG_ENTER
-        model->verbosity_ = level;
+        uint32_t rv;
+        try {
+            rv = ctx->model->StepSingle(cycle_count);
+        } catch (const std::exception &e) {
+            rv = exec_error(e);
+        }
+        *count = ctx->model->ConsumeChanges(buf, std::min<uint32_t>(max, SPECT_DPI_CHANGE_BATCH));
         DPI_CALL_LOG_EXIT
+        return rv;
     }
 
-    dpi_parity_type_t spect_dpi_get_parity_type()
+    uint32_t spect_dpi_ctx_program_run(spect_dpi_ctx_t *ctx, uint32_t instructions)
+    {
+        DPI_CALL_LOG_ENTER
+        uint32_t rv;
+        try {
+            rv = ctx->model->Step(instructions);
+        } catch (const std::exception &e) {
+            rv = exec_error(e);
+        }
+        DPI_CALL_LOG_EXIT
+        return rv;
+    }
+
+    void spect_dpi_ctx_set_verbosity(spect_dpi_ctx_t *ctx, uint32_t level)
+    {
+        DPI_CALL_LOG_ENTER
+        ctx->model->verbosity_ = level;
+        DPI_CALL_LOG_EXIT
+    }
+
+    dpi_parity_type_t spect_dpi_ctx_get_parity_type(spect_dpi_ctx_t *ctx)
     {
         DPI_CALL_LOG_ENTER
         dpi_parity_type_t rv;
-        switch (model->GetParityType()) {
+        switch (ctx->model->GetParityType()) {
         case spect::ParityType::ODD:
             rv = DPI_PARITY_ODD;
             break;
@@ -446,20 +542,224 @@ extern "C" {
         return rv;
     }
 
-    void spect_dpi_set_parity_type(dpi_parity_type_t parity_type)
+    void spect_dpi_ctx_set_parity_type(spect_dpi_ctx_t *ctx, dpi_parity_type_t parity_type)
     {
         DPI_CALL_LOG_ENTER
         switch (parity_type) {
         case DPI_PARITY_ODD:
-            model->SetParityType(spect::ParityType::ODD);
+            ctx->model->SetParityType(spect::ParityType::ODD);
             break;
         case DPI_PARITY_EVEN:
-            model->SetParityType(spect::ParityType::EVEN);
+            ctx->model->SetParityType(spect::ParityType::EVEN);
             break;
         default:
-            model->SetParityType(spect::ParityType::NONE);
+            ctx->model->SetParityType(spect::ParityType::NONE);
             break;
         }
         DPI_CALL_LOG_EXIT
     }
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Functions operating on default instance
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+
+    uint32_t spect_dpi_init()
+    {
+        default_ctx = spect_dpi_create(DEFAULT_ISA_VERSION);
+        return (default_ctx == nullptr) ? 1 : 0;
+    }
+
+    void spect_dpi_exit()
+    {
+        spect_dpi_destroy(default_ctx);
+        default_ctx = nullptr;
+    }
+
+    void spect_dpi_reset()
+    {
+        spect_dpi_ctx_reset(default_ctx);
+    }
+
+    void spect_dpi_start()
+    {
+        spect_dpi_ctx_start(default_ctx);
+    }
+
+    uint32_t spect_dpi_is_program_finished()
+    {
+        return spect_dpi_ctx_is_program_finished(default_ctx);
+    }
+
+    uint32_t spect_dpi_get_memory(uint32_t addr)
+    {
+        return spect_dpi_ctx_get_memory(default_ctx, addr);
+    }
+
+    void spect_dpi_set_memory(uint32_t addr, uint32_t data)
+    {
+        spect_dpi_ctx_set_memory(default_ctx, addr, data);
+    }
+
+    uint32_t spect_dpi_ahb_read(uint32_t addr)
+    {
+        return spect_dpi_ctx_ahb_read(default_ctx, addr);
+    }
+
+    void spect_dpi_ahb_write(uint32_t addr, uint32_t data)
+    {
+        spect_dpi_ctx_ahb_write(default_ctx, addr, data);
+    }
+
+    uint32_t spect_dpi_get_mem_base(dpi_mem_type_t mem_type)
+    {
+        return spect_dpi_ctx_get_mem_base(default_ctx, mem_type);
+    }
+
+    uint32_t spect_dpi_get_mem_size(dpi_mem_type_t mem_type)
+    {
+        return spect_dpi_ctx_get_mem_size(default_ctx, mem_type);
+    }
+
+    uint32_t spect_dpi_get_gpr_part(uint32_t gpr, uint32_t part)
+    {
+        return spect_dpi_ctx_get_gpr_part(default_ctx, gpr, part);
+    }
+
+    void spect_dpi_set_gpr_part(uint32_t gpr, uint32_t part, uint32_t data)
+    {
+        spect_dpi_ctx_set_gpr_part(default_ctx, gpr, part, data);
+    }
+
+    uint32_t spect_dpi_get_flag(dpi_flag_type_t flag_type)
+    {
+        return spect_dpi_ctx_get_flag(default_ctx, flag_type);
+    }
+
+    uint32_t spect_dpi_get_pc()
+    {
+        return spect_dpi_ctx_get_pc(default_ctx);
+    }
+
+    void spect_dpi_set_pc(uint32_t value)
+    {
+        spect_dpi_ctx_set_pc(default_ctx, value);
+    }
+
+    void spect_dpi_dump_instruction(uint32_t address, char *buf)
+    {
+        spect_dpi_ctx_dump_instruction(default_ctx, address, buf);
+    }
+
+    uint32_t spect_dpi_get_rar_value(uint32_t address)
+    {
+        return spect_dpi_ctx_get_rar_value(default_ctx, address);
+    }
+
+    uint32_t spect_dpi_get_rar_sp()
+    {
+        return spect_dpi_ctx_get_rar_sp(default_ctx);
+    }
+
+    void spect_dpi_push_grv_queue(uint32_t data)
+    {
+        spect_dpi_ctx_push_grv_queue(default_ctx, data);
+    }
+
+    void spect_dpi_push_ldk_queue(uint32_t data)
+    {
+        spect_dpi_ctx_push_ldk_queue(default_ctx, data);
+    }
+
+    void spect_dpi_push_kbus_error_queue(uint8_t error)
+    {
+        spect_dpi_ctx_push_kbus_error_queue(default_ctx, error);
+    }
+
+    uint32_t spect_dpi_get_interrupt(dpi_int_type_t int_type)
+    {
+        return spect_dpi_ctx_get_interrupt(default_ctx, int_type);
+    }
+
+    uint32_t spect_dpi_compile_program(const char *program_path, const char* hex_path,
+                                       const dpi_hex_file_type_t hex_format,
+                                       const dpi_parity_type_t parity_type, uint32_t first_addr)
+    {
+        return spect_dpi_ctx_compile_program(default_ctx, program_path, hex_path, hex_format, parity_type, first_addr);
+    }
+
+    uint32_t spect_dpi_get_compiled_program_start_address()
+    {
+        return spect_dpi_ctx_get_compiled_program_start_address(default_ctx);
+    }
+
+    void spect_dpi_set_model_start_pc(uint32_t start_pc)
+    {
+        spect_dpi_ctx_set_model_start_pc(default_ctx, start_pc);
+    }
+
+    uint32_t spect_dpi_load_hex_file(const char *path, const uint32_t offset)
+    {
+        return spect_dpi_ctx_load_hex_file(default_ctx, path, offset);
+    }
+
+    uint32_t spect_dpi_program_step(uint32_t cycle_count)
+    {
+        return spect_dpi_ctx_program_step(default_ctx, cycle_count);
+    }
+
+    void spect_dpi_get_last_instr(dpi_instruction_t *dpi_instruction)
+    {
+        spect_dpi_ctx_get_last_instr(default_ctx, dpi_instruction);
+    }
+
+    void spect_dpi_set_instr_sampling(uint32_t enable)
+    {
+        spect_dpi_ctx_set_instr_sampling(default_ctx, enable);
+    }
+
+    void spect_dpi_set_change_reporting(uint32_t enable)
+    {
+        spect_dpi_ctx_set_change_reporting(default_ctx, enable);
+    }
+
+    uint32_t spect_dpi_set_change_queue(uint32_t capacity, uint32_t overflow)
+    {
+        return spect_dpi_ctx_set_change_queue(default_ctx, capacity, overflow);
+    }
+
+    uint32_t spect_dpi_get_model_change(dpi_state_change_t *change)
+    {
+        return spect_dpi_ctx_get_model_change(default_ctx, change);
+    }
+
+    uint32_t spect_dpi_get_model_changes(dpi_state_change_t *buf, uint32_t max, uint32_t *count)
+    {
+        return spect_dpi_ctx_get_model_changes(default_ctx, buf, max, count);
+    }
+
+    uint32_t spect_dpi_program_step_collect(uint32_t cycle_count, dpi_state_change_t *buf,
+                                            uint32_t max, uint32_t *count)
+    {
+        return spect_dpi_ctx_program_step_collect(default_ctx, cycle_count, buf, max, count);
+    }
+
+    uint32_t spect_dpi_program_run(uint32_t instructions)
+    {
+        return spect_dpi_ctx_program_run(default_ctx, instructions);
+    }
+
+    void spect_dpi_set_verbosity(uint32_t level)
+    {
+        spect_dpi_ctx_set_verbosity(default_ctx, level);
+    }
+
+    dpi_parity_type_t spect_dpi_get_parity_type()
+    {
+        return spect_dpi_ctx_get_parity_type(default_ctx);
+    }
+
+    void spect_dpi_set_parity_type(dpi_parity_type_t parity_type)
+    {
+        spect_dpi_ctx_set_parity_type(default_ctx, parity_type);
+    }
 }
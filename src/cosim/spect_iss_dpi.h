@@ -23,6 +23,13 @@
 **          spect_dpi_program_step(<NUMBER_OF_CYCLES_EXECUTION_OF_LAST_INSTRUCTION_TOOK_ON_RTL>)
 **      }
 **
+**      // With change reporting enabled, step and read changes caused by the instruction in
+**      // single call:
+**      while (!spect_dpi_is_program_finished()) {
+**          spect_dpi_program_step_collect(<CYCLES>, buf, BUF_SIZE, &count);
+**          // Process 'count' changes in 'buf', drain rest by spect_dpi_get_model_changes()
+**      }
+**
 **      spect_dpi_exit();
 **
 ** TODO: License
@@ -35,10 +42,13 @@
 
 #include "spect_iss_dpi_types.h"
 
+// Handle of SPECT model instance
+typedef struct spect_dpi_ctx spect_dpi_ctx_t;
+
 extern "C" {
 
     /**
-     *  @brief Initialize Simulation model.
+     *  @brief Initialize Simulation model of default ISA version (DEFAULT_ISA_VERSION).
      *  @returns 0 - Initialization succefull,
      *           1 - Initialization failed.
      */
@@ -293,6 +303,7 @@ extern "C" {
      *                  3. Instruction shall not be executed in constant time.
      *           N - Number of instructions previous execution of instruction with the same
      *               took.
+     *           SPECT_DPI_EXEC_ERROR - Model failed to execute the instruction. Error is printed.
      */
     uint32_t spect_dpi_program_step(uint32_t cycle_count);
 
@@ -317,6 +328,15 @@ extern "C" {
      */
     void spect_dpi_get_last_instr(dpi_instruction_t *dpi_instruction);
 
+    /**
+     *  @brief Set sampling of last executed instruction by model.
+     *  @param enable 0 - Disable instruction sampling
+     *                1 - Enable instruction sampling
+     *  @note Sampling is enabled by default. Disable it when last executed instruction is not
+     *        read, execution of the model is then faster.
+     */
+    void spect_dpi_set_instr_sampling(uint32_t enable);
+
     /**
      *  @brief Set Change reporting by model (pushing change events to SCHF - State Change FIFO)
      *  @param enable 0 - Disable change reporting
@@ -324,6 +344,23 @@ extern "C" {
      */
     void spect_dpi_set_change_reporting(uint32_t enable);
 
+    /**
+     *  @brief Configure SCHF (State Change FIFO). Changes which were not popped yet are dropped.
+     *  @param capacity Maximal number of changes in SCHF (rounded up to power of two)
+     *  @param overflow What happens when model reports change while SCHF is full:
+     *                      0 - Model waits till SCHF is popped from other thread
+     *                      1 - Oldest change in SCHF is dropped
+     *                      2 - Model reports error, executing function returns
+     *                          SPECT_DPI_EXEC_ERROR
+     *                      3 - Capacity of SCHF is doubled
+     *  @returns 0 - SCHF configured
+     *           1 - Invalid overflow policy, SCHF not changed
+     *  @note By default, SCHF starts with SPECT_CHANGE_Q_SIZE changes and its capacity is
+     *        doubled when it is full (overflow = 3). Growing SCHF shall be popped from the
+     *        thread which executes the model.
+     */
+    uint32_t spect_dpi_set_change_queue(uint32_t capacity, uint32_t overflow);
+
     /**
      *  @brief Pop state change event from SCHF (State Change FIFO).
      *  @param handle Pointer to state change event
@@ -335,11 +372,40 @@ extern "C" {
      */
     uint32_t spect_dpi_get_model_change(dpi_state_change_t *change);
 
+    /**
+     *  @brief Pop multiple state change events from SCHF (State Change FIFO) at once.
+     *  @param buf Buffer for popped state change events, at least 'max' elements long.
+     *  @param max Maximal number of events to pop, at most SPECT_DPI_CHANGE_BATCH
+     *             (larger value is clamped).
+     *  @param count Number of events popped to 'buf'.
+     *  @returns 0 - SCHF drained, all events were popped.
+     *           1 - SCHF not drained, more events are available.
+     *  @note Has the same effect as up to 'max' calls of 'spect_dpi_get_model_change', but
+     *        crosses DPI boundary only once.
+     */
+    uint32_t spect_dpi_get_model_changes(dpi_state_change_t *buf, uint32_t max, uint32_t *count);
+
+    /**
+     *  @brief Execute single instruction of program and pop state change events it caused.
+     *  @param cycle_count Same as in 'spect_dpi_program_step'.
+     *  @param buf Buffer for popped state change events, at least 'max' elements long.
+     *  @param max Maximal number of events to pop, at most SPECT_DPI_CHANGE_BATCH
+     *             (larger value is clamped).
+     *  @param count Number of events popped to 'buf'.
+     *  @returns Same as 'spect_dpi_program_step'.
+     *  @note Has the same effect as 'spect_dpi_program_step' followed by
+     *        'spect_dpi_get_model_changes'. If instruction caused more than 'max' events,
+     *        remaining events stay in SCHF and can be popped by 'spect_dpi_get_model_changes'.
+     */
+    uint32_t spect_dpi_program_step_collect(uint32_t cycle_count, dpi_state_change_t *buf,
+                                            uint32_t max, uint32_t *count);
+
     /**
      *  @brief Execute SPECT instruction(s).
      *  @param instructions Number of instructions to execute. If 0, execute until END
      *                      instruction is executed.
      *  @returns Number of instructions actually executed by this call.
+     *           SPECT_DPI_EXEC_ERROR - Model failed to execute an instruction. Error is printed.
      *  @note Does not check execution time of the instruction.
      */
     uint32_t spect_dpi_program_run(uint32_t instructions);
@@ -370,6 +436,76 @@ extern "C" {
      */
     void spect_dpi_set_parity_type(dpi_parity_type_t parity_type);
 
+    /**********************************************************************************************
+     * Multi-instance API
+     *
+     *  Each 'spect_dpi_ctx_<name>(ctx, ...)' function behaves as 'spect_dpi_<name>(...)' above,
+     *  but operates on SPECT model instance 'ctx' instead of default instance. Instances are
+     *  independent (own model, own compiler), any number of them can exist in one process.
+     *********************************************************************************************/
+
+    /**
+     *  @brief Create new instance of simulation model.
+     *  @param isa_version SPECT Instruction Set version of the model and compiler:
+     *                      1 - For SPECT design spec version <= 1.0 (TROPIC01 MPW1)
+     *                      2 - For SPECT design spec version > 1.0
+     *  @returns Handle of the new instance, NULL if creation failed (e.g. invalid ISA version).
+     */
+    spect_dpi_ctx_t* spect_dpi_create(int isa_version);
+
+    /**
+     *  @brief Destroy instance of simulation model (performs memory clean-up).
+     *  @param ctx Handle of the instance returned by 'spect_dpi_create'.
+     */
+    void spect_dpi_destroy(spect_dpi_ctx_t *ctx);
+
+    void spect_dpi_ctx_reset(spect_dpi_ctx_t *ctx);
+    void spect_dpi_ctx_start(spect_dpi_ctx_t *ctx);
+    uint32_t spect_dpi_ctx_is_program_finished(spect_dpi_ctx_t *ctx);
+    uint32_t spect_dpi_ctx_get_memory(spect_dpi_ctx_t *ctx, uint32_t addr);
+    void spect_dpi_ctx_set_memory(spect_dpi_ctx_t *ctx, uint32_t addr, uint32_t data);
+    uint32_t spect_dpi_ctx_ahb_read(spect_dpi_ctx_t *ctx, uint32_t addr);
+    void spect_dpi_ctx_ahb_write(spect_dpi_ctx_t *ctx, uint32_t addr, uint32_t data);
+    uint32_t spect_dpi_ctx_get_mem_base(spect_dpi_ctx_t *ctx, dpi_mem_type_t mem_type);
+    uint32_t spect_dpi_ctx_get_mem_size(spect_dpi_ctx_t *ctx, dpi_mem_type_t mem_type);
+    uint32_t spect_dpi_ctx_get_gpr_part(spect_dpi_ctx_t *ctx, uint32_t gpr, uint32_t part);
+    void spect_dpi_ctx_set_gpr_part(spect_dpi_ctx_t *ctx, uint32_t gpr, uint32_t part,
+                                    uint32_t data);
+    uint32_t spect_dpi_ctx_get_flag(spect_dpi_ctx_t *ctx, dpi_flag_type_t flag_type);
+    uint32_t spect_dpi_ctx_get_pc(spect_dpi_ctx_t *ctx);
+    void spect_dpi_ctx_set_pc(spect_dpi_ctx_t *ctx, uint32_t value);
+    void spect_dpi_ctx_dump_instruction(spect_dpi_ctx_t *ctx, uint32_t address, char *buf);
+    uint32_t spect_dpi_ctx_get_rar_value(spect_dpi_ctx_t *ctx, uint32_t address);
+    uint32_t spect_dpi_ctx_get_rar_sp(spect_dpi_ctx_t *ctx);
+    void spect_dpi_ctx_push_grv_queue(spect_dpi_ctx_t *ctx, uint32_t data);
+    void spect_dpi_ctx_push_ldk_queue(spect_dpi_ctx_t *ctx, uint32_t data);
+    void spect_dpi_ctx_push_kbus_error_queue(spect_dpi_ctx_t *ctx, uint8_t error);
+    uint32_t spect_dpi_ctx_get_interrupt(spect_dpi_ctx_t *ctx, dpi_int_type_t int_type);
+    uint32_t spect_dpi_ctx_compile_program(spect_dpi_ctx_t *ctx, const char *program_path,
+                                           const char* hex_path,
+                                           const dpi_hex_file_type_t hex_format,
+                                           const dpi_parity_type_t parity_type, uint32_t first_addr);
+    uint32_t spect_dpi_ctx_get_compiled_program_start_address(spect_dpi_ctx_t *ctx);
+    void spect_dpi_ctx_set_model_start_pc(spect_dpi_ctx_t *ctx, uint32_t start_pc);
+    uint32_t spect_dpi_ctx_load_hex_file(spect_dpi_ctx_t *ctx, const char *path,
+                                         const uint32_t offset);
+    uint32_t spect_dpi_ctx_program_step(spect_dpi_ctx_t *ctx, uint32_t cycle_count);
+    void spect_dpi_ctx_get_last_instr(spect_dpi_ctx_t *ctx, dpi_instruction_t *dpi_instruction);
+    void spect_dpi_ctx_set_instr_sampling(spect_dpi_ctx_t *ctx, uint32_t enable);
+    void spect_dpi_ctx_set_change_reporting(spect_dpi_ctx_t *ctx, uint32_t enable);
+    uint32_t spect_dpi_ctx_set_change_queue(spect_dpi_ctx_t *ctx, uint32_t capacity,
+                                            uint32_t overflow);
+    uint32_t spect_dpi_ctx_get_model_change(spect_dpi_ctx_t *ctx, dpi_state_change_t *change);
+    uint32_t spect_dpi_ctx_get_model_changes(spect_dpi_ctx_t *ctx, dpi_state_change_t *buf,
+                                             uint32_t max, uint32_t *count);
+    uint32_t spect_dpi_ctx_program_step_collect(spect_dpi_ctx_t *ctx, uint32_t cycle_count,
+                                                dpi_state_change_t *buf, uint32_t max,
+                                                uint32_t *count);
+    uint32_t spect_dpi_ctx_program_run(spect_dpi_ctx_t *ctx, uint32_t instructions);
+    void spect_dpi_ctx_set_verbosity(spect_dpi_ctx_t *ctx, uint32_t level);
+    dpi_parity_type_t spect_dpi_ctx_get_parity_type(spect_dpi_ctx_t *ctx);
+    void spect_dpi_ctx_set_parity_type(spect_dpi_ctx_t *ctx, dpi_parity_type_t parity_type);
+
 }
 
 #endif
@@ -162,6 +162,13 @@ typedef enum {
     int unsigned r31_v[8] = '{default: 0};
   } dpi_instruction_t;
 
+  // Size of buffer for batched readout of state change events. Shall match
+  // SPECT_DPI_CHANGE_BATCH in spect_iss_dpi_types.h.
+  parameter int unsigned SPECT_DPI_CHANGE_BATCH = 64;
+
+  // Returned by functions executing the program when the model fails (e.g. SCHF overflow)
+  parameter int unsigned SPECT_DPI_EXEC_ERROR = 32'hFFFFFFFF;
+
   /////////////////////////////////////////////////////////////////////////////
   // Imports section
   /////////////////////////////////////////////////////////////////////////////
@@ -169,7 +176,7 @@ typedef enum {
   import uvm_pkg::*;
 
   /**
-   *  @brief Initialize Simulation model.
+   *  @brief Initialize Simulation model of default ISA version.
    *  @returns 0 - Initialization succefull,
    *           1 - Initialization failed.
    */
@@ -411,6 +418,7 @@ typedef enum {
    *                  3. Instruction shall not be executed in constant time.
    *           N - Number of instructions previous execution of instruction with the same
    *               took.
+   *           SPECT_DPI_EXEC_ERROR - Model failed to execute the instruction. Error is printed.
    */
   import "DPI-C" function int unsigned spect_dpi_program_step(int unsigned cycle_count);
 
@@ -435,6 +443,15 @@ typedef enum {
    */
   import "DPI-C" function void spect_dpi_get_last_instr(output dpi_instruction_t dpi_instruction);
 
+  /**
+   *  @brief Set sampling of last executed instruction by model.
+   *  @param enable 0 - Disable instruction sampling
+   *                1 - Enable instruction sampling
+   *  @note Sampling is enabled by default. Disable it when last executed instruction is not
+   *        read, execution of the model is then faster.
+   */
+  import "DPI-C" function void spect_dpi_set_instr_sampling(int unsigned enable);
+
   /**
    *  @brief Set Change reporting by model (pushing change events to SCHF - State Change FIFO)
    *  @param enable 0 - Disable change reporting
@@ -442,6 +459,24 @@ typedef enum {
    */
   import "DPI-C" function void spect_dpi_set_change_reporting(int unsigned enable);
 
+  /**
+   *  @brief Configure SCHF (State Change FIFO). Changes which were not popped yet are dropped.
+   *  @param capacity Maximal number of changes in SCHF (rounded up to power of two)
+   *  @param overflow What happens when model reports change while SCHF is full:
+   *                      0 - Model waits till SCHF is popped from other thread
+   *                      1 - Oldest change in SCHF is dropped
+   *                      2 - Model reports error, executing function returns
+   *                          SPECT_DPI_EXEC_ERROR
+   *                      3 - Capacity of SCHF is doubled
+   *  @returns 0 - SCHF configured
+   *           1 - Invalid overflow policy, SCHF not changed
+   *  @note By default, SCHF starts with SPECT_CHANGE_Q_SIZE changes and its capacity is
+   *        doubled when it is full (overflow = 3). Growing SCHF shall be popped from the
+   *        thread which executes the model.
+   */
+  import "DPI-C" function int unsigned spect_dpi_set_change_queue(int unsigned capacity,
+                                                                  int unsigned overflow);
+
   /**
    *  @brief Pop state change event from SCHF (State Change FIFO).
    *  @param handle Pointer to state change event
@@ -453,11 +488,46 @@ typedef enum {
    */
   import "DPI-C" function int unsigned spect_dpi_get_model_change(output dpi_state_change_t change);
 
+  /**
+   *  @brief Pop multiple state change events from SCHF (State Change FIFO) at once.
+   *  @param buf Buffer for popped state change events.
+   *  @param max Maximal number of events to pop (larger value is clamped to
+   *             SPECT_DPI_CHANGE_BATCH).
+   *  @param count Number of events popped to 'buf'.
+   *  @returns 0 - SCHF drained, all events were popped.
+   *           1 - SCHF not drained, more events are available.
+   *  @note Has the same effect as up to 'max' calls of 'spect_dpi_get_model_change', but
+   *        crosses DPI boundary only once.
+   */
+  import "DPI-C" function int unsigned spect_dpi_get_model_changes(
+    output dpi_state_change_t buf[SPECT_DPI_CHANGE_BATCH],
+    input  int unsigned       max,
+    output int unsigned       count);
+
+  /**
+   *  @brief Execute single instruction of program and pop state change events it caused.
+   *  @param cycle_count Same as in 'spect_dpi_program_step'.
+   *  @param buf Buffer for popped state change events.
+   *  @param max Maximal number of events to pop (larger value is clamped to
+   *             SPECT_DPI_CHANGE_BATCH).
+   *  @param count Number of events popped to 'buf'.
+   *  @returns Same as 'spect_dpi_program_step'.
+   *  @note Has the same effect as 'spect_dpi_program_step' followed by
+   *        'spect_dpi_get_model_changes'. If instruction caused more than 'max' events,
+   *        remaining events stay in SCHF and can be popped by 'spect_dpi_get_model_changes'.
+   */
+  import "DPI-C" function int unsigned spect_dpi_program_step_collect(
+    input  int unsigned       cycle_count,
+    output dpi_state_change_t buf[SPECT_DPI_CHANGE_BATCH],
+    input  int unsigned       max,
+    output int unsigned       count);
+
   /**
    *  @brief Execute SPECT instruction(s).
    *  @param instructions Number of instructions to execute. If 0, execute until END
    *                      instruction is executed.
    *  @returns Number of instructions actually executed by this call.
+   *           SPECT_DPI_EXEC_ERROR - Model failed to execute an instruction. Error is printed.
    *  @note Does not check execution time of the instruction.
    */
   import "DPI-C" function int unsigned spect_dpi_program_run(int unsigned instructions);
@@ -488,6 +558,128 @@ typedef enum {
    */
   import "DPI-C" function void spect_dpi_set_parity_type(dpi_parity_type_t parity_type);
 
+  /////////////////////////////////////////////////////////////////////////////
+  // Multi-instance API
+  //
+  //  Each 'spect_dpi_ctx_<name>(ctx, ...)' function behaves as
+  //  'spect_dpi_<name>(...)' above, but operates on SPECT model instance 'ctx'
+  //  instead of default instance. Instances are independent (own model, own
+  //  compiler), any number of them can exist in one simulation.
+  /////////////////////////////////////////////////////////////////////////////
+
+  /**
+   *  @brief Create new instance of simulation model.
+   *  @param isa_version SPECT Instruction Set version of the model and compiler:
+   *                      1 - For SPECT design spec version <= 1.0 (TROPIC01 MPW1)
+   *                      2 - For SPECT design spec version > 1.0
+   *  @returns Handle of the new instance, null if creation failed (e.g. invalid
+   *           ISA version).
+   */
+  import "DPI-C" function chandle spect_dpi_create(input int isa_version);
+
+  /**
+   *  @brief Destroy instance of simulation model (performs memory clean-up).
+   *  @param ctx Handle of the instance returned by 'spect_dpi_create'.
+   */
+  import "DPI-C" function void spect_dpi_destroy(chandle ctx);
+
+  import "DPI-C" function void spect_dpi_ctx_reset(chandle ctx);
+  import "DPI-C" function int unsigned spect_dpi_ctx_is_program_finished(chandle ctx);
+  import "DPI-C" function int unsigned spect_dpi_ctx_get_memory(chandle ctx, int unsigned addr);
+  import "DPI-C" function void spect_dpi_ctx_set_memory(
+    chandle ctx,
+    int unsigned addr,
+    int unsigned data);
+  import "DPI-C" function int unsigned spect_dpi_ctx_ahb_read(chandle ctx, int unsigned addr);
+  import "DPI-C" function void spect_dpi_ctx_ahb_write(
+    chandle ctx,
+    int unsigned addr,
+    int unsigned data);
+  import "DPI-C" function int unsigned spect_dpi_ctx_get_mem_base(
+    chandle ctx,
+    dpi_mem_type_t mem_type);
+  import "DPI-C" function int unsigned spect_dpi_ctx_get_mem_size(
+    chandle ctx,
+    dpi_mem_type_t mem_type);
+  import "DPI-C" function int unsigned spect_dpi_ctx_get_gpr_part(
+    chandle ctx,
+    int unsigned gpr,
+    int unsigned part);
+  import "DPI-C" function void spect_dpi_ctx_set_gpr_part(
+    chandle ctx,
+    int unsigned gpr,
+    int unsigned part,
+    int unsigned data);
+  import "DPI-C" function int unsigned spect_dpi_ctx_get_flag(
+    chandle ctx,
+    dpi_flag_type_t flag_type);
+  import "DPI-C" function int unsigned spect_dpi_ctx_get_pc(chandle ctx);
+  import "DPI-C" function void spect_dpi_ctx_set_pc(chandle ctx, int unsigned value);
+  import "DPI-C" function void spect_dpi_ctx_dump_instruction(
+    chandle ctx,
+    int unsigned address,
+    string buffer);
+  import "DPI-C" function int unsigned spect_dpi_ctx_get_rar_value(
+    chandle ctx,
+    int unsigned address);
+  import "DPI-C" function int unsigned spect_dpi_ctx_get_rar_sp(chandle ctx);
+  import "DPI-C" function void spect_dpi_ctx_push_grv_queue(chandle ctx, int unsigned data);
+  import "DPI-C" function void spect_dpi_ctx_push_ldk_queue(chandle ctx, int unsigned data);
+  import "DPI-C" function void spect_dpi_ctx_push_kbus_error_queue(
+    chandle ctx,
+    byte unsigned error);
+  import "DPI-C" function int unsigned spect_dpi_ctx_get_interrupt(
+    chandle ctx,
+    dpi_int_type_t int_type);
+  import "DPI-C" function int unsigned spect_dpi_ctx_compile_program(
+    chandle ctx,
+    string program_path,
+    string hex_path,
+    dpi_hex_file_type_t hex_format,
+    dpi_parity_type_t parity_type,
+    int unsigned first_addr);
+  import "DPI-C" function int unsigned spect_dpi_ctx_get_compiled_program_start_address(
+    chandle ctx);
+  import "DPI-C" function void spect_dpi_ctx_set_model_start_pc(chandle ctx, int unsigned start_pc);
+  import "DPI-C" function int unsigned spect_dpi_ctx_load_hex_file(
+    chandle ctx,
+    string path,
+    int unsigned offset);
+  import "DPI-C" function int unsigned spect_dpi_ctx_program_step(
+    chandle ctx,
+    int unsigned cycle_count);
+  import "DPI-C" function void spect_dpi_ctx_get_last_instr(
+    input  chandle ctx,
+    output dpi_instruction_t dpi_instruction);
+  import "DPI-C" function void spect_dpi_ctx_set_instr_sampling(chandle ctx, int unsigned enable);
+  import "DPI-C" function void spect_dpi_ctx_set_change_reporting(chandle ctx, int unsigned enable);
+  import "DPI-C" function int unsigned spect_dpi_ctx_set_change_queue(
+    chandle ctx,
+    int unsigned capacity,
+    int unsigned overflow);
+  import "DPI-C" function int unsigned spect_dpi_ctx_get_model_change(
+    input  chandle ctx,
+    output dpi_state_change_t change);
+  import "DPI-C" function int unsigned spect_dpi_ctx_get_model_changes(
+    input  chandle ctx,
+    output dpi_state_change_t buf[SPECT_DPI_CHANGE_BATCH],
+    input int unsigned max,
+    output int unsigned count);
+  import "DPI-C" function int unsigned spect_dpi_ctx_program_step_collect(
+    input  chandle ctx,
+    input int unsigned cycle_count,
+    output dpi_state_change_t buf[SPECT_DPI_CHANGE_BATCH],
+    input int unsigned max,
+    output int unsigned count);
+  import "DPI-C" function int unsigned spect_dpi_ctx_program_run(
+    chandle ctx,
+    int unsigned instructions);
+  import "DPI-C" function void spect_dpi_ctx_set_verbosity(chandle ctx, int unsigned level);
+  import "DPI-C" function dpi_parity_type_t spect_dpi_ctx_get_parity_type(chandle ctx);
+  import "DPI-C" function void spect_dpi_ctx_set_parity_type(
+    chandle ctx,
+    dpi_parity_type_t parity_type);
+
 endpackage : spect_iss_dpi_pkg
 
 `endif // SPECT_ISS_DPI_PKG_SV
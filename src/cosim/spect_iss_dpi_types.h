@@ -25,6 +25,13 @@
 #define DPIENC_KBUS_SLOT_OFFSET    9
 #define DPIENC_KBUS_OFFSET_OFFSET  17
 
+// Returned by functions executing the program when the model fails (e.g. SCHF overflow)
+#define SPECT_DPI_EXEC_ERROR       0xFFFFFFFF
+
+// Size of buffer for batched readout of state change events. Shall match the parameter
+// of the same name in spect_iss_dpi_pkg.sv (size of 'buf' passed from SystemVerilog).
+#define SPECT_DPI_CHANGE_BATCH     64
+
 typedef enum {
     DPI_SPECT_DATA_RAM_IN       = (1 << 0),
     DPI_SPECT_DATA_RAM_OUT      = (1 << 1),
@@ -9,100 +9,189 @@
 #include "spect_iss_lib.h"
 
 
-spect::CpuSimulator *simulator;
+struct spect_iss_ctx {
+    spect::CpuSimulator *simulator = nullptr;
+    uint32_t first_addr = SPECT_INSTR_MEM_BASE;
+    spect::ParityType parity_type = spect::ParityType::NONE;
+};
 
-uint32_t first_addr_ = SPECT_INSTR_MEM_BASE;
-spect::ParityType parity_type_ = spect::ParityType::NONE;
+struct spect_iss_image {
+    std::shared_ptr<const spect::ProgramImage> image;
+};
 
+struct spect_iss_snapshot {
+    std::shared_ptr<const spect::CpuSnapshot> snapshot;
+};
 
-void spect_iss_init(int isa_version)
+// Instance used by functions without "ctx" argument
+spect_iss_ctx_t default_ctx;
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Functions operating on instance "ctx"
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+spect_iss_ctx_t* spect_iss_create(int isa_version)
 {
-    spect::InstructionFactory::SetActiveISAVersion(isa_version);
-    simulator = new spect::CpuSimulator();
-    simulator->model_->SetParityType(parity_type_);
+    spect_iss_ctx_t *ctx = new spect_iss_ctx_t();
+    ctx->simulator = new spect::CpuSimulator(isa_version);
+    return ctx;
 }
 
-void spect_iss_set_first_addr(int first_addr)
+void spect_iss_destroy(spect_iss_ctx_t *ctx)
 {
-    first_addr_ = first_addr;
+    delete ctx->simulator;
+    delete ctx;
 }
 
-void spect_iss_load_s_file(std::string s_file)
+static spect::ParityType parity_from_int(int parity_type)
+{
+    if (parity_type == 1)
+        return spect::ParityType::ODD;
+    if (parity_type == 2)
+        return spect::ParityType::EVEN;
+    return spect::ParityType::NONE;
+}
+
+spect_iss_image_t* spect_iss_image_create(int isa_version, std::string s_file, int first_addr,
+                                          int parity_type, std::string const_rom_hex_file)
+{
+    auto image = std::make_shared<spect::ProgramImage>(isa_version, parity_from_int(parity_type));
+    image->LoadProgram(s_file, first_addr);
+    if (!const_rom_hex_file.empty())
+        image->LoadConstRomHex(const_rom_hex_file);
+    return new spect_iss_image_t{image};
+}
+
+spect_iss_image_t* spect_iss_image_create_hex(int isa_version, std::string hex_file,
+                                              int parity_type, std::string const_rom_hex_file)
+{
+    auto image = std::make_shared<spect::ProgramImage>(isa_version, parity_from_int(parity_type));
+    image->LoadInstrMemHex(hex_file);
+    if (!const_rom_hex_file.empty())
+        image->LoadConstRomHex(const_rom_hex_file);
+    return new spect_iss_image_t{image};
+}
+
+void spect_iss_image_destroy(spect_iss_image_t *image)
+{
+    delete image;
+}
+
+void spect_iss_load_image(spect_iss_ctx_t *ctx, spect_iss_image_t *image)
+{
+    ctx->simulator->model_->SetProgramImage(image->image);
+}
+
+spect_iss_ctx_t* spect_iss_fork(spect_iss_ctx_t *ctx)
+{
+    spect_iss_ctx_t *fork = new spect_iss_ctx_t();
+    fork->simulator = ctx->simulator->Fork();
+    fork->first_addr = ctx->first_addr;
+    fork->parity_type = ctx->parity_type;
+    return fork;
+}
+
+spect_iss_snapshot_t* spect_iss_snapshot_take(spect_iss_ctx_t *ctx)
+{
+    return new spect_iss_snapshot_t{ctx->simulator->model_->Snapshot()};
+}
+
+void spect_iss_restore(spect_iss_ctx_t *ctx, spect_iss_snapshot_t *snapshot)
+{
+    ctx->simulator->model_->Restore(*snapshot->snapshot);
+}
+
+void spect_iss_snapshot_destroy(spect_iss_snapshot_t *snapshot)
+{
+    delete snapshot;
+}
+
+void spect_iss_set_first_addr(spect_iss_ctx_t *ctx, int first_addr)
+{
+    ctx->first_addr = first_addr;
+}
+
+void spect_iss_load_s_file(spect_iss_ctx_t *ctx, std::string s_file)
 {
-    simulator->compiler_->CompileInit(first_addr_);
-    simulator->compiler_->Compile(s_file);
-    simulator->compiler_->CompileFinish();
+    ctx->simulator->model_->SetProgramImage(nullptr);
+    ctx->simulator->compiler_->CompileInit(ctx->first_addr);
+    ctx->simulator->compiler_->Compile(s_file);
+    ctx->simulator->compiler_->CompileFinish();
 
-    uint32_t *p_start = simulator->model_->GetMemoryPtr();
-    p_start += (first_addr_ >> 2);
-    simulator->compiler_->program_->Assemble(p_start, parity_type_);
+    std::vector<uint32_t> mem(SPECT_TOTAL_MEM_SIZE / 4);
+    ctx->simulator->model_->ReadMemoryBlock(0, mem.data(), SPECT_TOTAL_MEM_SIZE);
+    ctx->simulator->compiler_->program_->Assemble(mem.data() + (ctx->first_addr >> 2),
+                                                  ctx->parity_type);
+    ctx->simulator->model_->WriteMemoryBlock(0, mem.data(), SPECT_TOTAL_MEM_SIZE);
 
     // Set address of first instruction to be fetched
-    uint32_t start_pc = simulator->compiler_->symbols_->GetSymbol(START_SYMBOL)->val_;
-    simulator->model_->SetStartPc(start_pc);
+    uint32_t start_pc = ctx->simulator->compiler_->symbols_->GetSymbol(START_SYMBOL)->val_;
+    ctx->simulator->model_->SetStartPc(start_pc);
 }
 
-void spect_iss_set_parity_type(int parity_type)
+void spect_iss_set_parity_type(spect_iss_ctx_t *ctx, int parity_type)
 {
     if (parity_type == 1)
-        parity_type_ = spect::ParityType::ODD;
+        ctx->parity_type = spect::ParityType::ODD;
     else if (parity_type == 2)
-        parity_type_ = spect::ParityType::EVEN;
+        ctx->parity_type = spect::ParityType::EVEN;
+
+    // Legacy API allows setting parity before spect_iss_init
+    if (ctx->simulator)
+        ctx->simulator->model_->SetParityType(ctx->parity_type);
 }
 
-void spect_iss_load_hex_file(std::string hex_file)
+void spect_iss_load_hex_file(spect_iss_ctx_t *ctx, std::string hex_file)
 {
-    spect::HexHandler::LoadHexFile(hex_file,
-        simulator->model_->GetMemoryPtr(), SPECT_INSTR_MEM_BASE);
+    ctx->simulator->model_->SetProgramImage(nullptr);
+    ctx->simulator->model_->LoadHexFile(hex_file, SPECT_INSTR_MEM_BASE);
 }
 
-void spect_iss_set_const_rom_hex_file(std::string const_rom_hex_file)
+void spect_iss_set_const_rom_hex_file(spect_iss_ctx_t *ctx, std::string const_rom_hex_file)
 {
-    spect::HexHandler::LoadHexFile(const_rom_hex_file,
-        simulator->model_->GetMemoryPtr(), SPECT_CONST_ROM_BASE);
+    ctx->simulator->model_->LoadHexFile(const_rom_hex_file, SPECT_CONST_ROM_BASE);
 }
 
-void spect_iss_set_data_ram_in_hex_file(std::string data_ram_out_hex_file)
+void spect_iss_set_data_ram_in_hex_file(spect_iss_ctx_t *ctx, std::string data_ram_out_hex_file)
 {
-    spect::HexHandler::LoadHexFile(data_ram_out_hex_file,
-        simulator->model_->GetMemoryPtr(), SPECT_DATA_RAM_IN_BASE);
+    ctx->simulator->model_->LoadHexFile(data_ram_out_hex_file, SPECT_DATA_RAM_IN_BASE);
 }
 
-void spect_iss_set_emem_in_hex_file(std::string emem_in_hex_file)
+void spect_iss_set_emem_in_hex_file(spect_iss_ctx_t *ctx, std::string emem_in_hex_file)
 {
-    spect::HexHandler::LoadHexFile(emem_in_hex_file,
-        simulator->model_->GetMemoryPtr(), SPECT_EMEM_IN_BASE);
+    ctx->simulator->model_->LoadHexFile(emem_in_hex_file, SPECT_EMEM_IN_BASE);
 }
 
-void spect_iss_set_timing_accurate(bool enable, int exec_time_step)
+void spect_iss_set_timing_accurate(spect_iss_ctx_t *ctx, bool enable, int exec_time_step)
 {
-    simulator->model_->timing_accurate_sim_ = enable;
-    simulator->model_->execution_time_step_ = exec_time_step;
+    ctx->simulator->model_->timing_accurate_sim_ = enable;
+    ctx->simulator->model_->execution_time_step_ = exec_time_step;
 }
 
-void spect_iss_set_grv_hex_file(std::string grv_hex_file)
+void spect_iss_set_grv_hex_file(spect_iss_ctx_t *ctx, std::string grv_hex_file)
 {
     std::vector<uint32_t> mem;
     spect::HexHandler::LoadHexFile(grv_hex_file, mem);
 
     for (const auto &wrd : mem)
-        simulator->model_->GrvQueuePush(wrd);
+        ctx->simulator->model_->GrvQueuePush(wrd);
 }
 
-void spect_iss_set_key_mem_hex_file(std::string key_mem_file)
+void spect_iss_set_key_mem_hex_file(spect_iss_ctx_t *ctx, std::string key_mem_file)
 {
-    simulator->key_memory_->Load(key_mem_file);
+    ctx->simulator->key_memory_->Load(key_mem_file);
 }
 
-void spect_iss_set_start_pc(int start_pc)
+void spect_iss_set_start_pc(spect_iss_ctx_t *ctx, int start_pc)
 {
-    simulator->model_->SetStartPc(start_pc);
+    ctx->simulator->model_->SetStartPc(start_pc);
 }
 
-void spect_iss_execute_cmd_file(std::string cmd_file)
+void spect_iss_execute_cmd_file(spect_iss_ctx_t *ctx, std::string cmd_file)
 {
     cli::LoopScheduler scheduler;
-    cli::CliLocalTerminalSession session(*(simulator->cli_), scheduler, std::cout);
+    cli::CliLocalTerminalSession session(*(ctx->simulator->cli_), scheduler, std::cout);
 
     session.ExitAction(
             [&scheduler](A_UNUSED auto& out)
@@ -111,79 +200,209 @@ void spect_iss_execute_cmd_file(std::string cmd_file)
             }
         );
 
-    simulator->cmd_file_ = cmd_file;
-    simulator->ExecCmdFile(session);
+    ctx->simulator->cmd_file_ = cmd_file;
+    ctx->simulator->ExecCmdFile(session);
 
     session.Feed("exit\n");
 }
 
+void spect_iss_cmd_start(spect_iss_ctx_t *ctx, std::ostream &out)
+{
+    ctx->simulator->CmdStart(out);
+}
+
+void spect_iss_cmd_info(spect_iss_ctx_t *ctx, std::ostream &out, std::string arg1)
+{
+    ctx->simulator->CmdInfo(out, arg1);
+}
+
+void spect_iss_cmd_run(spect_iss_ctx_t *ctx, std::ostream &out)
+{
+    ctx->simulator->CmdRun(out);
+}
+
+void spect_iss_cmd_delete(spect_iss_ctx_t *ctx, std::ostream &out, std::string arg1, bool all)
+{
+    ctx->simulator->CmdDelete(out, arg1, all);
+}
+
+void spect_iss_cmd_jump(spect_iss_ctx_t *ctx, std::ostream &out, std::string arg1)
+{
+    ctx->simulator->CmdJump(out, arg1);
+}
+
+void spect_iss_cmd_get(spect_iss_ctx_t *ctx, std::ostream &out, std::string arg1)
+{
+    ctx->simulator->CmdGet(out, arg1);
+}
+
+void spect_iss_cmd_load(spect_iss_ctx_t *ctx, std::ostream &out, std::string arg1, int offset)
+{
+    ctx->simulator->CmdLoad(out, arg1, offset);
+}
+
+void spect_iss_cmd_step(spect_iss_ctx_t *ctx, std::ostream &out, int n)
+{
+    ctx->simulator->CmdStep(out, n);
+}
+
+void spect_iss_cmd_dump(spect_iss_ctx_t *ctx, std::ostream &out, std::string arg1, uint32_t address, uint32_t size)
+{
+    ctx->simulator->CmdDump(out, arg1, address, size);
+}
+
+void spect_iss_dump_data_ram_out_hex(spect_iss_ctx_t *ctx, std::string data_ram_out_hex_file)
+{
+    ctx->simulator->model_->DumpHexFile(data_ram_out_hex_file, spect::HexFileType::ISS_WORD,
+            SPECT_DATA_RAM_OUT_BASE, SPECT_DATA_RAM_OUT_SIZE);
+}
+
+void spect_iss_dump_emem_out_hex(spect_iss_ctx_t *ctx, std::string emem_out_hex_file)
+{
+    ctx->simulator->model_->DumpHexFile(emem_out_hex_file, spect::HexFileType::ISS_WORD,
+            SPECT_EMEM_OUT_BASE, SPECT_EMEM_OUT_SIZE);
+}
+
+void spect_iss_dump_key_mem_out_hex(spect_iss_ctx_t *ctx, std::string kmem_hex_file)
+{
+    ctx->simulator->key_memory_->Dump(kmem_hex_file);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Functions operating on default instance
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void spect_iss_init(int isa_version)
+{
+    default_ctx.simulator = new spect::CpuSimulator(isa_version);
+    default_ctx.simulator->model_->SetParityType(default_ctx.parity_type);
+}
+
+void spect_iss_set_first_addr(int first_addr)
+{
+    spect_iss_set_first_addr(&default_ctx, first_addr);
+}
+
+void spect_iss_load_s_file(std::string s_file)
+{
+    spect_iss_load_s_file(&default_ctx, s_file);
+}
+
+void spect_iss_set_parity_type(int parity_type)
+{
+    spect_iss_set_parity_type(&default_ctx, parity_type);
+}
+
+void spect_iss_load_hex_file(std::string hex_file)
+{
+    spect_iss_load_hex_file(&default_ctx, hex_file);
+}
+
+void spect_iss_set_const_rom_hex_file(std::string const_rom_hex_file)
+{
+    spect_iss_set_const_rom_hex_file(&default_ctx, const_rom_hex_file);
+}
+
+void spect_iss_set_data_ram_in_hex_file(std::string data_ram_out_hex_file)
+{
+    spect_iss_set_data_ram_in_hex_file(&default_ctx, data_ram_out_hex_file);
+}
+
+void spect_iss_set_emem_in_hex_file(std::string emem_in_hex_file)
+{
+    spect_iss_set_emem_in_hex_file(&default_ctx, emem_in_hex_file);
+}
+
+void spect_iss_set_timing_accurate(bool enable, int exec_time_step)
+{
+    spect_iss_set_timing_accurate(&default_ctx, enable, exec_time_step);
+}
+
+void spect_iss_set_grv_hex_file(std::string grv_hex_file)
+{
+    spect_iss_set_grv_hex_file(&default_ctx, grv_hex_file);
+}
+
+void spect_iss_set_key_mem_hex_file(std::string key_mem_file)
+{
+    spect_iss_set_key_mem_hex_file(&default_ctx, key_mem_file);
+}
+
+void spect_iss_set_start_pc(int start_pc)
+{
+    spect_iss_set_start_pc(&default_ctx, start_pc);
+}
+
+void spect_iss_execute_cmd_file(std::string cmd_file)
+{
+    spect_iss_execute_cmd_file(&default_ctx, cmd_file);
+}
+
 void spect_iss_cmd_start(std::ostream &out)
 {
-    simulator->CmdStart(out);
+    spect_iss_cmd_start(&default_ctx, out);
 }
 
 void spect_iss_cmd_info(std::ostream &out, std::string arg1)
 {
-    simulator->CmdInfo(out, arg1);
+    spect_iss_cmd_info(&default_ctx, out, arg1);
 }
 
 void spect_iss_cmd_run(std::ostream &out)
 {
-    simulator->CmdRun(out);
+    spect_iss_cmd_run(&default_ctx, out);
 }
 
 void spect_iss_cmd_delete(std::ostream &out, std::string arg1, bool all)
 {
-    simulator->CmdDelete(out, arg1, all);
+    spect_iss_cmd_delete(&default_ctx, out, arg1, all);
 }
 
 void spect_iss_cmd_jump(std::ostream &out, std::string arg1)
 {
-    simulator->CmdJump(out, arg1);
+    spect_iss_cmd_jump(&default_ctx, out, arg1);
 }
 
 void spect_iss_cmd_get(std::ostream &out, std::string arg1)
 {
-    simulator->CmdGet(out, arg1);
+    spect_iss_cmd_get(&default_ctx, out, arg1);
 }
 
 void spect_iss_cmd_load(std::ostream &out, std::string arg1, int offset)
 {
-    simulator->CmdLoad(out, arg1, offset);
+    spect_iss_cmd_load(&default_ctx, out, arg1, offset);
 }
 
 void spect_iss_cmd_step(std::ostream &out, int n)
 {
-    simulator->CmdStep(out, n);
+    spect_iss_cmd_step(&default_ctx, out, n);
 }
 
 void spect_iss_cmd_dump(std::ostream &out, std::string arg1, uint32_t address, uint32_t size)
 {
-    simulator->CmdDump(out, arg1, address, size);
+    spect_iss_cmd_dump(&default_ctx, out, arg1, address, size);
 }
 
 void spect_iss_dump_data_ram_out_hex(std::string data_ram_out_hex_file)
 {
-    spect::HexHandler::DumpHexFile(data_ram_out_hex_file,
-            spect::HexFileType::ISS_WORD, simulator->model_->GetMemoryPtr(),
-            SPECT_DATA_RAM_OUT_BASE, SPECT_DATA_RAM_OUT_SIZE);
+    spect_iss_dump_data_ram_out_hex(&default_ctx, data_ram_out_hex_file);
 }
 
 void spect_iss_dump_emem_out_hex(std::string emem_out_hex_file)
 {
-    spect::HexHandler::DumpHexFile(emem_out_hex_file,
-            spect::HexFileType::ISS_WORD, simulator->model_->GetMemoryPtr(), SPECT_EMEM_OUT_BASE,
-            SPECT_EMEM_OUT_SIZE);
+    spect_iss_dump_emem_out_hex(&default_ctx, emem_out_hex_file);
 }
 
 void spect_iss_dump_key_mem_out_hex(std::string kmem_hex_file)
 {
-    simulator->key_memory_->Dump(kmem_hex_file);
+    spect_iss_dump_key_mem_out_hex(&default_ctx, kmem_hex_file);
 }
 
 void spect_iss_exit(void)
 {
-    delete simulator;
+    delete default_ctx.simulator;
+    default_ctx.simulator = nullptr;
 }
 
 int spect_iss_get_git_hash(void)
@@ -28,9 +28,26 @@
 #include "CpuModel.h"
 #include "CpuProgram.h"
 #include "CpuSimulator.h"
+#include "CpuSnapshot.h"
 #include "HexHandler.h"
 #include "InstructionFactory.h"
 #include "KeyMemory.h"
+#include "ProgramImage.h"
+
+/**
+ * @brief Instance of SPECT Instruction Set Simulator.
+ */
+typedef struct spect_iss_ctx spect_iss_ctx_t;
+
+/**
+ * @brief Program image shared read-only by instances of SPECT Instruction Set Simulator.
+ */
+typedef struct spect_iss_image spect_iss_image_t;
+
+/**
+ * @brief Snapshot of state of SPECT Instruction Set Simulator instance.
+ */
+typedef struct spect_iss_snapshot spect_iss_snapshot_t;
 
 
 /**************************************************************************************************
@@ -346,4 +363,141 @@ int spect_iss_get_git_hash(void);
  */
 std::string spect_iss_get_version(void);
 
-#endif SPECT_ISS_LIB_H_
\ No newline at end of file
+
+/**************************************************************************************************
+ **************************************************************************************************
+ * Multi-instance API
+ *
+ * Functions above operate on single default instance created by "spect_iss_init". Each of them
+ * has an overload with "ctx" as first argument that operates on an instance created by
+ * "spect_iss_create". Any number of instances can exist in the process at the same time.
+ **************************************************************************************************
+ *************************************************************************************************/
+
+/**
+ * @brief Create new instance of SPECT Instruction Set Simulator
+ *
+ * @param isa_version SPECT Instruction Set version (see "spect_iss_init").
+ * @returns Instance handle, pass it to "spect_iss_destroy" when no longer needed.
+ */
+spect_iss_ctx_t* spect_iss_create(int isa_version);
+
+/**
+ * @brief Destroy instance of SPECT Instruction Set Simulator
+ *
+ * @param ctx Instance created by "spect_iss_create".
+ */
+void spect_iss_destroy(spect_iss_ctx_t *ctx);
+
+/**
+ * @brief Compile ".s" SPECT FW file to program image
+ *
+ * @param isa_version SPECT Instruction Set version (see "spect_iss_init").
+ * @param s_file Path to ".s" file to be compiled.
+ * @param first_addr Address where first instruction of the program will be placed.
+ * @param parity_type Parity type of Instruction memory (see "spect_iss_set_parity_type").
+ * @param const_rom_hex_file Path to ".hex" file with content of Constant ROM, empty - Constant ROM
+ *                           is all zeros.
+ * @returns Image handle, pass it to "spect_iss_image_destroy" when no longer needed.
+ * @note Program is compiled and decoded only once. Loading the image to an instance by
+ *       "spect_iss_load_image" costs only copy of Instruction memory and Constant ROM.
+ */
+spect_iss_image_t* spect_iss_image_create(int isa_version, std::string s_file, int first_addr,
+                                          int parity_type, std::string const_rom_hex_file = "");
+
+/**
+ * @brief Load ".hex" SPECT FW file to program image
+ *
+ * @param isa_version SPECT Instruction Set version (see "spect_iss_init").
+ * @param hex_file Path to ".hex" file with content of Instruction memory.
+ * @param parity_type Parity type of Instruction memory (see "spect_iss_set_parity_type").
+ * @param const_rom_hex_file Path to ".hex" file with content of Constant ROM, empty - Constant ROM
+ *                           is all zeros.
+ * @returns Image handle, pass it to "spect_iss_image_destroy" when no longer needed.
+ */
+spect_iss_image_t* spect_iss_image_create_hex(int isa_version, std::string hex_file,
+                                              int parity_type, std::string const_rom_hex_file = "");
+
+/**
+ * @brief Destroy program image handle
+ *
+ * @param image Image created by "spect_iss_image_create" or "spect_iss_image_create_hex".
+ * @note Instances which loaded the image keep it until they load other program or are destroyed.
+ */
+void spect_iss_image_destroy(spect_iss_image_t *image);
+
+/**
+ * @brief Load program image to an instance
+ *
+ * Loads Instruction memory, Constant ROM and address of first instruction from the image.
+ * Image must have the same ISA version as the instance.
+ *
+ * @param ctx Instance created by "spect_iss_create".
+ * @param image Program image.
+ */
+void spect_iss_load_image(spect_iss_ctx_t *ctx, spect_iss_image_t *image);
+
+/**
+ * @brief Fork an instance
+ *
+ * Creates new instance with the same state as "ctx": model state, memories, Key Memory,
+ * loaded program and settings. Memories are shared copy-on-write, so the fork is cheap even
+ * for large Key Memory. Both instances are independent afterwards and can run in parallel.
+ *
+ * @param ctx Instance created by "spect_iss_create" or "spect_iss_fork".
+ * @returns Instance handle, pass it to "spect_iss_destroy" when no longer needed.
+ */
+spect_iss_ctx_t* spect_iss_fork(spect_iss_ctx_t *ctx);
+
+/**
+ * @brief Take snapshot of state of an instance
+ *
+ * @param ctx Instance created by "spect_iss_create" or "spect_iss_fork".
+ * @returns Snapshot handle, pass it to "spect_iss_snapshot_destroy" when no longer needed.
+ * @note Memory pages not modified since previous snapshot of the instance are not copied.
+ */
+spect_iss_snapshot_t* spect_iss_snapshot_take(spect_iss_ctx_t *ctx);
+
+/**
+ * @brief Restore state of an instance from snapshot
+ *
+ * Snapshot can be restored to any instance with the same ISA version, any number of times.
+ *
+ * @param ctx Instance created by "spect_iss_create" or "spect_iss_fork".
+ * @param snapshot Snapshot taken by "spect_iss_snapshot_take".
+ */
+void spect_iss_restore(spect_iss_ctx_t *ctx, spect_iss_snapshot_t *snapshot);
+
+/**
+ * @brief Destroy snapshot handle
+ *
+ * @param snapshot Snapshot taken by "spect_iss_snapshot_take".
+ */
+void spect_iss_snapshot_destroy(spect_iss_snapshot_t *snapshot);
+
+void spect_iss_set_first_addr(spect_iss_ctx_t *ctx, int first_addr);
+void spect_iss_load_s_file(spect_iss_ctx_t *ctx, std::string s_file);
+void spect_iss_set_parity_type(spect_iss_ctx_t *ctx, int parity_type);
+void spect_iss_load_hex_file(spect_iss_ctx_t *ctx, std::string hex_file);
+void spect_iss_set_const_rom_hex_file(spect_iss_ctx_t *ctx, std::string const_rom_hex_file);
+void spect_iss_set_data_ram_in_hex_file(spect_iss_ctx_t *ctx, std::string data_ram_out_hex_file);
+void spect_iss_set_emem_in_hex_file(spect_iss_ctx_t *ctx, std::string emem_in_hex_file);
+void spect_iss_set_timing_accurate(spect_iss_ctx_t *ctx, bool enable, int exec_time_step);
+void spect_iss_set_grv_hex_file(spect_iss_ctx_t *ctx, std::string grv_hex_file);
+void spect_iss_set_key_mem_hex_file(spect_iss_ctx_t *ctx, std::string key_mem_file);
+void spect_iss_set_start_pc(spect_iss_ctx_t *ctx, int start_pc);
+void spect_iss_execute_cmd_file(spect_iss_ctx_t *ctx, std::string cmd_file);
+void spect_iss_cmd_start(spect_iss_ctx_t *ctx, std::ostream &out);
+void spect_iss_cmd_info(spect_iss_ctx_t *ctx, std::ostream &out, std::string arg1);
+void spect_iss_cmd_run(spect_iss_ctx_t *ctx, std::ostream &out);
+void spect_iss_cmd_delete(spect_iss_ctx_t *ctx, std::ostream &out, std::string arg1, bool all);
+void spect_iss_cmd_jump(spect_iss_ctx_t *ctx, std::ostream &out, std::string arg1);
+void spect_iss_cmd_get(spect_iss_ctx_t *ctx, std::ostream &out, std::string arg1);
+void spect_iss_cmd_load(spect_iss_ctx_t *ctx, std::ostream &out, std::string arg1, int offset);
+void spect_iss_cmd_step(spect_iss_ctx_t *ctx, std::ostream &out, int n);
+void spect_iss_cmd_dump(spect_iss_ctx_t *ctx, std::ostream &out, std::string arg1, uint32_t address, uint32_t size);
+void spect_iss_dump_data_ram_out_hex(spect_iss_ctx_t *ctx, std::string data_ram_out_hex_file);
+void spect_iss_dump_emem_out_hex(spect_iss_ctx_t *ctx, std::string emem_out_hex_file);
+void spect_iss_dump_key_mem_out_hex(spect_iss_ctx_t *ctx, std::string kmem_hex_file);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,164 @@
+/**************************************************************************************************
+*
+* SPECT Compiler
+* Copyright (C) 2022-present Tropic Square
+*
+* @todo: License
+*
+**************************************************************************************************/
+
+#include <cstring>
+#include <thread>
+
+#include "ChangeQueue.h"
+
+spect::ChangeQueue::ChangeQueue(size_t capacity, ChangeQueueOverflow overflow)
+{
+    Configure(capacity, overflow);
+}
+
+spect::ChangeQueue::~ChangeQueue()
+{
+    delete [] buf_;
+}
+
+void spect::ChangeQueue::Configure(size_t capacity, ChangeQueueOverflow overflow)
+{
+    uint64_t size = 1;
+    while (size < capacity)
+        size <<= 1;
+
+    delete [] buf_;
+    buf_ = nullptr;
+    mask_ = size - 1;
+    overflow_ = overflow;
+    head_ = 0;
+    tail_ = 0;
+    drop_cnt_ = 0;
+}
+
+spect::ChangeQueue::Slot* spect::ChangeQueue::Allocate(uint64_t size)
+{
+    Slot *buf = new Slot[size];
+    for (uint64_t i = 0; i < size; i++)
+        buf[i].seq.store(SLOT_BUSY, std::memory_order_relaxed);
+    return buf;
+}
+
+void spect::ChangeQueue::Write(Slot &slot, uint64_t index, const uint64_t *data)
+{
+    // Consumer copying the slot meanwhile sees sequence number change and discards the copy
+    slot.seq.store(SLOT_BUSY, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (size_t i = 0; i < CHANGE_WORDS; i++)
+        slot.data[i].store(data[i], std::memory_order_relaxed);
+
+    slot.seq.store(index, std::memory_order_release);
+}
+
+void spect::ChangeQueue::Push(const dpi_state_change_t &change)
+{
+    if (buf_ == nullptr)
+        buf_ = Allocate(mask_ + 1);
+
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+
+    while (tail - head_.load(std::memory_order_acquire) > mask_) {
+        switch (overflow_) {
+        case ChangeQueueOverflow::BLOCK:
+            std::this_thread::yield();
+            break;
+
+        case ChangeQueueOverflow::DROP_OLDEST: {
+            // Consumer may pop the oldest change at the same time, only one of us moves head.
+            uint64_t head = tail - mask_ - 1;
+            if (head_.compare_exchange_strong(head, head + 1, std::memory_order_acq_rel))
+                drop_cnt_.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+
+        case ChangeQueueOverflow::GROW:
+            Grow();
+            break;
+
+        default:
+            throw std::runtime_error("Processor state change queue overflow, capacity: " +
+                                     std::to_string(mask_ + 1) + " changes");
+        }
+    }
+
+    uint64_t data[CHANGE_WORDS] = {};
+    std::memcpy(data, &change, sizeof(change));
+    Write(buf_[tail & mask_], tail, data);
+    tail_.store(tail + 1, std::memory_order_release);
+}
+
+void spect::ChangeQueue::Grow()
+{
+    uint64_t size = (mask_ + 1) << 1;
+    Slot *buf = Allocate(size);
+
+    // Changes keep their indices, only position in the buffer changes with the mask
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    for (uint64_t i = head_.load(std::memory_order_relaxed); i != tail; i++) {
+        uint64_t data[CHANGE_WORDS];
+        for (size_t j = 0; j < CHANGE_WORDS; j++)
+            data[j] = buf_[i & mask_].data[j].load(std::memory_order_relaxed);
+        Write(buf[i & (size - 1)], i, data);
+    }
+
+    delete [] buf_;
+    buf_ = buf;
+    mask_ = size - 1;
+}
+
+bool spect::ChangeQueue::Pop(dpi_state_change_t &change)
+{
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t data[CHANGE_WORDS];
+
+    while (head != tail_.load(std::memory_order_acquire)) {
+        Slot &slot = buf_[head & mask_];
+
+        uint64_t seq = slot.seq.load(std::memory_order_acquire);
+        for (size_t i = 0; i < CHANGE_WORDS; i++)
+            data[i] = slot.data[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        // Producer might have dropped (and overwritten) the change while it was copied. In
+        // such case head has moved, copy is discarded and next oldest change is read.
+        if (seq != head || slot.seq.load(std::memory_order_relaxed) != head) {
+            head = head_.load(std::memory_order_acquire);
+            continue;
+        }
+
+        if (head_.compare_exchange_weak(head, head + 1, std::memory_order_acq_rel,
+                                        std::memory_order_acquire)) {
+            std::memcpy(&change, data, sizeof(change));
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool spect::ChangeQueue::Empty() const
+{
+    return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+}
+
+size_t spect::ChangeQueue::GetCapacity() const
+{
+    return mask_ + 1;
+}
+
+spect::ChangeQueueOverflow spect::ChangeQueue::GetOverflow() const
+{
+    return overflow_;
+}
+
+uint64_t spect::ChangeQueue::GetDropCount() const
+{
+    return drop_cnt_.load(std::memory_order_relaxed);
+}
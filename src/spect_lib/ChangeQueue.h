@@ -0,0 +1,129 @@
+/**************************************************************************************************
+*
+* SPECT Compiler
+* Copyright (C) 2022-present Tropic Square
+*
+* @todo: License
+*
+**************************************************************************************************/
+
+#ifndef SPECT_LIB_CHANGE_QUEUE_H_
+#define SPECT_LIB_CHANGE_QUEUE_H_
+
+#include <atomic>
+
+#include "spect.h"
+#include "spect_iss_dpi_types.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Processor state change queue
+//  Fixed capacity single-producer / single-consumer ring buffer. Model (producer) pushes changes
+//  and testbench (consumer) pops them. Producer and consumer may run on different threads,
+//  neither of them takes a lock. Capacity is rounded up to power of two, buffer is allocated
+//  on first push.
+//
+//  With ChangeQueueOverflow::DROP_OLDEST, producer may overwrite the slot which consumer is just
+//  copying. Therefore each slot holds the change as atomic words together with sequence number
+//  (index of the change in the slot). Consumer accepts the copy only if sequence number of the
+//  slot did not change while copying (seqlock).
+//
+//  With ChangeQueueOverflow::GROW, producer reallocates the buffer when the queue is full. Such
+//  queue is unbounded, but producer and consumer shall then run on the same thread.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+class spect::ChangeQueue
+{
+    public:
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Change queue constructor
+        /// @param capacity Maximal number of changes held by the queue
+        /// @param overflow What happens when change is pushed to full queue
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        ChangeQueue(size_t capacity, ChangeQueueOverflow overflow);
+
+        ~ChangeQueue();
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Change capacity and overflow policy of the queue. Queued changes are dropped.
+        /// @param capacity Maximal number of changes held by the queue
+        /// @param overflow What happens when change is pushed to full queue
+        /// @note Neither producer nor consumer shall access the queue during this call.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void Configure(size_t capacity, ChangeQueueOverflow overflow);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Push change to the queue (producer side)
+        /// @param change Change to push
+        /// @throw std::runtime_error if the queue is full and overflow policy is ERROR
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void Push(const dpi_state_change_t &change);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Pop oldest change from the queue (consumer side)
+        /// @param change Popped change
+        /// @returns True if change was popped, False if the queue is empty
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        bool Pop(dpi_state_change_t &change);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @returns True when there are no changes in the queue, False otherwise
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        bool Empty() const;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @returns Capacity of the queue
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        size_t GetCapacity() const;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @returns Overflow policy of the queue
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        ChangeQueueOverflow GetOverflow() const;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @returns Number of changes dropped due to DROP_OLDEST overflow policy
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        uint64_t GetDropCount() const;
+
+    private:
+        // Number of 64-bit words holding single change
+        static constexpr size_t CHANGE_WORDS = (sizeof(dpi_state_change_t) + 7) / 8;
+
+        // Sequence number of slot which is being written
+        static constexpr uint64_t SLOT_BUSY = ~0ULL;
+
+        // Ring buffer slot
+        struct Slot {
+            std::atomic<uint64_t> seq;
+            std::atomic<uint64_t> data[CHANGE_WORDS];
+        };
+
+        // Allocate ring buffer of given size, all slots are busy (hold no change)
+        static Slot* Allocate(uint64_t size);
+
+        // Store change with given index to slot (producer side)
+        static void Write(Slot &slot, uint64_t index, const uint64_t *data);
+
+        // Double capacity of the queue, queued changes are kept
+        void Grow();
+
+        // Ring buffer, nullptr till first push
+        Slot *buf_ = nullptr;
+
+        // Capacity - 1, capacity is power of two
+        uint64_t mask_;
+
+        // Overflow policy
+        ChangeQueueOverflow overflow_;
+
+        // Index of oldest change (consumer side, producer moves it only when dropping)
+        std::atomic<uint64_t> head_;
+
+        // Index of next pushed change (producer side)
+        std::atomic<uint64_t> tail_;
+
+        // Number of dropped changes
+        std::atomic<uint64_t> drop_cnt_;
+};
+
+#endif
@@ -6,8 +6,8 @@
 ** Author: Ondrej Ille
 **************************************************************************************************/
 
+#include <algorithm>
 #include <fstream>
-#include <regex>
 #include <iostream>
 #include <cassert>
 #include <exception>
@@ -21,20 +21,24 @@
 #include "InstructionJ.h"
 #include "InstructionM.h"
 #include "InstructionR.h"
+#include "ThreadPool.h"
 
 
-spect::Compiler::Compiler(void)
+spect::Compiler::Compiler(int isa_version) :
+    isa_version_(isa_version)
 {
+    assert(isa_version > 0 && isa_version <= NUM_ISA_VERSIONS);
+
     symbols_ = new spect::SymbolTable();
     print_fnc = &(printf);
 
-    CondDefAdd(std::string("SPECT_ISA_VERSION_") + std::to_string(InstructionFactory::GetActiveISAVersion()));
+    CondDefAdd(std::string("SPECT_ISA_VERSION_") + std::to_string(isa_version_));
 }
 
 spect::Compiler::~Compiler()
 {
-    for (const auto &f : files_)
-        delete f.second;
+    for (const auto &sf : sources_)
+        delete sf;
     delete symbols_;
     delete program_;
 }
@@ -68,14 +72,14 @@ uint32_t spect::Compiler::ParseValue(spect::SourceFile *sf, int line_nr, const s
     uint32_t rv = 0;
 
     // Check that it is not matching operand
-    if (std::regex_match(val, std::regex("^" OP_REGEX))) {
+    if (spect::Lexer::IsRegister(val)) {
         char buf[128];
         std::sprintf(buf, "Found operand: '%s' when expecting value or symbol.", val.c_str());
         ErrorAt(std::string(buf), sf, line_nr, spect::ErrCode::SYNTAX);
     }
 
     // Number
-    if (std::regex_match(val, std::regex("^" NUM_REGEX))) {
+    if (spect::Lexer::IsNumber(val)) {
         if (val.size() < 2) {
             rv = std::stoi (val, nullptr);
         } else if (val[0] == '0') {
@@ -97,9 +101,9 @@ uint32_t spect::Compiler::ParseValue(spect::SourceFile *sf, int line_nr, const s
 
     // Symbol
     } else {
-        if (!symbols_->IsDefined(val))
-            symbols_->AddSymbol(val, SymbolType::UNKNOWN, line_nr);
         s = symbols_->GetSymbol(val);
+        if (!s)
+            s = symbols_->AddSymbol(val, SymbolType::UNKNOWN, line_nr);
         rv = 0;
     }
 
@@ -107,11 +111,12 @@ uint32_t spect::Compiler::ParseValue(spect::SourceFile *sf, int line_nr, const s
     return rv;
 }
 
-spect::CpuGpr spect::Compiler::ParseOp(spect::SourceFile *sf, int line_nr, std::string &arg)
+spect::CpuGpr spect::Compiler::ParseOp(spect::SourceFile *sf, int line_nr,
+                                       const std::string &arg)
 {
-    if (std::regex_match(arg, std::regex("^" OP_REGEX))) {
-        arg.erase(0, 1);
-        return static_cast<spect::CpuGpr>(stoint(arg));
+    int gpr = stogpr(arg);
+    if (gpr >= 0) {
+        return static_cast<spect::CpuGpr>(gpr);
     } else {
         char buf[128];
         std::sprintf(buf, "Invalid operand: '%s'. Valid operands: R0, R1 ... R31", arg.c_str());
@@ -121,7 +126,7 @@ spect::CpuGpr spect::Compiler::ParseOp(spect::SourceFile *sf, int line_nr, std::
 }
 
 void spect::Compiler::ParseArgument(spect::SourceFile *sf, int line_nr, spect::Instruction* instr,
-                                    std::string &arg, int arg_index)
+                                    const std::string &arg, int arg_index)
 {
     assert(!(arg_index == 2 && instr->itype_ == InstructionType::J));
     assert(!(arg_index == 3 && ((instr->itype_ == InstructionType::J) ||
@@ -204,176 +209,139 @@ bool spect::Compiler::ShouldParse(void)
     return true;
 }
 
-bool spect::Compiler::ParseCondCompile(spect::SourceFile *sf, std::string &line_buf, int line_nr)
+bool spect::Compiler::ParseCondCompile(spect::Lexer &lex, int line_nr, Records &records)
 {
-    if (ShouldParse()) {
-        if (std::regex_match(line_buf, std::regex("^" DEFINE_KEYWORD "[ ]+" IDENT_REGEX))) {
-            std::string ident = line_buf.substr(line_buf.find_last_of(' ') + 1, line_buf.size() - 1);
-            CondDefAdd(ident);
-            return true;
-        }
+    typedef spect::Lexer::TokenType T;
+    typedef RecordType R;
+
+    // <keyword> <ident>
+    bool has_ident = lex.Remaining() == 3 && lex.Match(1, T::SPACE) && lex.MatchIdent(2);
+
+    if (has_ident && lex.Match(0, T::DIRECTIVE, DEFINE_KEYWORD)) {
+        records.emplace_back(R::DEFINE, line_nr, lex.Text(2));
+        return true;
     }
 
-    if (std::regex_match(line_buf, std::regex("^" IFDEF_KEYWORD "[ ]+" IDENT_REGEX))) {
-        std::string ident = line_buf.substr(line_buf.find_last_of(' ') + 1, line_buf.size() - 1);
-        cond_stack_.push_front(!CondDefExists(ident));
+    if (has_ident && lex.Match(0, T::DIRECTIVE, IFDEF_KEYWORD)) {
+        records.emplace_back(R::IFDEF, line_nr, lex.Text(2));
         return true;
     }
 
-    if (std::regex_match(line_buf, std::regex("^" ELSE_KEYWORD))) {
-        if (cond_stack_.empty())
-            ErrorAt("No previous 'ifdef' defined!", sf, line_nr, spect::ErrCode::SYNTAX);
-        bool top = cond_stack_.front();
-        cond_stack_.pop_front();
-        cond_stack_.push_front(!top);
+    if (lex.Remaining() == 1 && lex.Match(0, T::DIRECTIVE, ELSE_KEYWORD)) {
+        records.emplace_back(R::ELSE, line_nr);
         return true;
     }
 
-    if (std::regex_match(line_buf, std::regex("^" ENDIF_KEYWORD))) {
-        if (cond_stack_.empty())
-            ErrorAt("No previous 'ifdef' defined!", sf, line_nr, spect::ErrCode::SYNTAX);
-        cond_stack_.pop_front();
+    if (lex.Remaining() == 1 && lex.Match(0, T::DIRECTIVE, ENDIF_KEYWORD)) {
+        records.emplace_back(R::ENDIF, line_nr);
         return true;
     }
 
     return false;
 }
 
-spect::Symbol* spect::Compiler::ParseLabel(spect::SourceFile *sf, std::string &line_buf,
-                                           int line_nr)
+void spect::Compiler::ParseLabel(spect::Lexer &lex, int line_nr, Records &records)
 {
-    if (std::regex_match(line_buf, std::regex("^" IDENT_REGEX ":.*"))) {
-        std::string ident = line_buf.substr(0, line_buf.find(':'));
-        line_buf = std::regex_replace(line_buf, std::regex("^" IDENT_REGEX ":"), "");
-
-        if (symbols_->IsDefined(ident)) {
-            Symbol *s = symbols_->GetSymbol(ident);
-
-            if (s->resolved_) {
-                char buf[128];
-                std::sprintf(buf, "Symbol: '%s' previously defined at: %s:%d",
-                                ident.c_str(), s->f_->path_.c_str(), s->line_nr_);
-                ErrorAt(std::string(buf), sf, line_nr, spect::ErrCode::SYMBOL);
-            } else {
-                symbols_->ResolveSymbol(s, SymbolType::LABEL, curr_addr_);
-                return s;
-            }
-        }
+    typedef spect::Lexer::TokenType T;
 
-        return symbols_->AddSymbol(ident, SymbolType::LABEL, curr_addr_, line_nr);
+    // <ident>: <anything>
+    if (lex.MatchIdent(0) && lex.Match(1, T::COLON) && !lex.HasLineTerminator(2)) {
+        records.emplace_back(RecordType::LABEL, line_nr, lex.Text(0));
+        lex.Advance(2);
+        lex.SkipSpaces();
     }
-    return nullptr;
 }
 
-bool spect::Compiler::ParseConstant(spect::SourceFile *sf, std::string &line_buf, int line_nr)
+bool spect::Compiler::ParseConstant(spect::Lexer &lex, int line_nr, Records &records)
 {
-    if (std::regex_match(line_buf, std::regex("^" IDENT_REGEX "[ ]+" EQ_KEYWORD "[ ]+" VAL_REGEX))) {
-        std::string ident = line_buf.substr(0, line_buf.find(' '));
-        std::string val = line_buf.substr(line_buf.find_last_of(' ') + 1, line_buf.size() - 1);
-        Symbol *s;
-        Symbol *s_dummy;
-
-        if (symbols_->IsDefined(ident)) {
-            s = symbols_->GetSymbol(ident);
-            if (s->resolved_) {
-                char buf[128];
-                std::sprintf(buf, "Symbol: '%s' previously defined at: %s:%d",
-                                ident.c_str(), s->f_->path_.c_str(), s->line_nr_);
-                ErrorAt(std::string(buf), sf, line_nr, spect::ErrCode::SYMBOL);
-            } else {
-                symbols_->ResolveSymbol(s, SymbolType::CONSTANT,
-                                        ParseValue(sf, line_nr, val, s_dummy));
-            }
-        } else {
-            symbols_->AddSymbol(ident, SymbolType::CONSTANT,
-                                ParseValue(sf, line_nr, val, s_dummy), line_nr);
-        }
-
-        // TODO: Check s_dummy ??
+    typedef spect::Lexer::TokenType T;
 
+    // <ident> .eq <value>
+    if (lex.Remaining() == 5 && lex.MatchIdent(0) && lex.Match(1, T::SPACE) &&
+        lex.Match(2, T::DIRECTIVE, EQ_KEYWORD) && lex.Match(3, T::SPACE) &&
+        lex.Match(4, T::WORD) && spect::Lexer::IsValue(lex.Text(4))) {
+        records.emplace_back(RecordType::CONSTANT, line_nr, lex.Text(0), lex.Text(4));
         return true;
     }
     return false;
 }
 
-bool spect::Compiler::ParseIncludeFile(spect::SourceFile *sf, std::string &line_buf)
+bool spect::Compiler::ParseIncludeFile(const spect::SourceFile *sf, spect::Lexer &lex,
+                                       int line_nr, Records &records)
 {
-    if (std::regex_match(line_buf, std::regex("^" INCLUDE_KEYWORD "[ ]+" FILE_REGEX))) {
-        // Store parent file handler
-        SourceFile *parent_file = symbols_->curr_file_;
+    typedef spect::Lexer::TokenType T;
+
+    // .include <file>
+    if (lex.Remaining() >= 3 && lex.Match(0, T::DIRECTIVE, INCLUDE_KEYWORD) &&
+        lex.Match(1, T::SPACE) && !lex.HasLineTerminator(2)) {
+        // File name follows last space
+        size_t first = lex.Remaining();
+        while (!lex.Match(first - 1, T::SPACE))
+            first--;
 
         // TODO: Make this universal across OS type!
         std::string new_file = sf->path_.substr(0, sf->path_.find_last_of("/")) + "/" +
-                                                   line_buf.substr(line_buf.find_last_of(' ') + 1,
-                                                line_buf.size() - 1);
-        print_fnc("Loading included file: %s\n", new_file.c_str());
-        Compile(new_file);
-        // Restore parent file handler
-        print_fnc("Back to file: %s\n", parent_file->path_.c_str());
-        symbols_->curr_file_ = parent_file;
+                               lex.Text(first, lex.Remaining() - first);
+        records.emplace_back(RecordType::INCLUDE, line_nr, new_file);
         return true;
     }
     return false;
 }
 
-spect::Instruction* spect::Compiler::ParseInstruction(spect::SourceFile *sf, std::string &line_buf,
-                                                      int line_nr, spect::Symbol *label)
+void spect::Compiler::ParseInstruction(spect::Lexer &lex, int line_nr, Records &records)
 {
+    typedef spect::Lexer::TokenType T;
+
     // Parse mnemonic and find instruction
-    int space_pos = line_buf.find(' ');
-    std::string mnemonic = line_buf.substr(0, space_pos);
-    line_buf.erase(0, space_pos);
-    TrimSpaces(line_buf);
-    spect::Instruction *gold_instr = InstructionFactory::GetInstruction(mnemonic);
+    size_t mnemonic_len = lex.Find(T::SPACE);
+    std::string mnemonic = lex.Text(0, mnemonic_len);
+    lex.Advance(mnemonic_len);
+    lex.SkipSpaces();
+    const spect::Instruction *gold_instr =
+        InstructionFactory::GetInstruction(isa_version_, mnemonic);
 
     if (gold_instr == nullptr) {
         char buf[128];
         std::sprintf(buf, "Unknown instruction: %s", mnemonic.c_str());
-        ErrorAt(std::string(buf), sf, line_nr, spect::ErrCode::SYNTAX);
+        records.emplace_back(RecordType::ERROR, line_nr, "", buf);
+        return;
     }
 
-    spect::Instruction *new_instr = gold_instr->Clone();
-    //std::cout << label << "\n";
-    new_instr->s_label_ = label;
-
     // Calculate number of expected arguments (number of bitsin 1 in op_mask)
     int exp_argc = 0;
     for (int i = 2; i >= 0; i--)
-        if ((new_instr->op_mask_ >> i) & 0x1)
+        if ((gold_instr->op_mask_ >> i) & 0x1)
             exp_argc++;
 
     // Parse arguments
     int arg_index = 1;
     int skipped_args = 0;
+    std::vector<Argument> args;
 
-    while (!line_buf.empty()) {
+    while (!lex.Empty()) {
 
         if (arg_index > exp_argc + skipped_args) {
             char buf[128];
             std::sprintf(buf, "Too many arguments to instruction: %s. Expected only %d arguments.",
                             mnemonic.c_str(), exp_argc);
-            ErrorAt(std::string(buf), sf, line_nr, spect::ErrCode::SYNTAX);
+            records.emplace_back(RecordType::INSTRUCTION, line_nr, mnemonic, buf, args);
+            return;
         }
 
         // Skip un-implemented arguments for given unstruction
-        while (((new_instr->op_mask_ >> (3 - arg_index)) & 0x1) == 0) {
+        while (((gold_instr->op_mask_ >> (3 - arg_index)) & 0x1) == 0) {
             arg_index++;
             skipped_args++;
         }
 
-        size_t pos = line_buf.find(',');
-        std::string arg;
-        if (pos != std::string::npos) {
-            arg = line_buf.substr(0, pos);
-            line_buf.erase(0, pos + 1);
-        } else {
-            arg = line_buf;
-            line_buf = std::string("");
-        }
+        size_t arg_len = lex.Find(T::COMMA);
+        args.push_back({arg_index, lex.Text(0, arg_len)});
+        if (arg_len < lex.Remaining())
+            lex.Advance(arg_len + 1);
+        else
+            lex.Advance(arg_len);
 
-        ParseArgument(sf, line_nr, new_instr, arg, arg_index);
-
-        TrimSpaces(line_buf);
+        lex.SkipSpaces();
         arg_index++;
     }
 
@@ -382,78 +350,269 @@ spect::Instruction* spect::Compiler::ParseInstruction(spect::SourceFile *sf, std
         std::sprintf(buf, "Missing arguments to instruction: %s. "
                           "Expected %d arguments found only %d!",
                           mnemonic.c_str(), exp_argc, arg_index - 1);
-        ErrorAt(std::string(buf), sf, line_nr, spect::ErrCode::SYNTAX);
+        records.emplace_back(RecordType::INSTRUCTION, line_nr, mnemonic, buf, args);
+        return;
     }
 
-    num_instr_++;
+    records.emplace_back(RecordType::INSTRUCTION, line_nr, mnemonic, "", args);
+}
+
+void spect::Compiler::ParseSource(const spect::SourceFile *sf, Records &records)
+{
+    records.reserve(sf->lines_.size());
 
-    return new_instr;
+    for (unsigned int line_nr = 1; line_nr <= sf->lines_.size(); line_nr++) {
+        // Split line to tokens (removes comments, leading and trailing spaces)
+        spect::Lexer lex(sf->lines_[line_nr - 1]);
+
+        // Check for conditional compilation keywords
+        if (ParseCondCompile(lex, line_nr, records))
+            continue;
+
+        // Parse Label
+        ParseLabel(lex, line_nr, records);
+
+        if (lex.Empty())
+            continue;
+
+        // Check for definitions of constants
+        if (ParseConstant(lex, line_nr, records))
+            continue;
+
+        // Check for include of another file
+        if (ParseIncludeFile(sf, lex, line_nr, records))
+            continue;
+
+        ParseInstruction(lex, line_nr, records);
+    }
+}
+
+void spect::Compiler::ParseFile(const std::string &path, ParsedFile &pf)
+{
+    // Runs in worker thread, errors are reported when the file is loaded
+    try {
+        pf.sf = new spect::SourceFile(path, 0);
+        ParseSource(pf.sf, pf.records);
+    } catch (std::exception &err) {
+        pf.error = err.what();
+    }
 }
 
+void spect::Compiler::ParseFiles(const std::vector<std::string> &paths)
+{
+    spect::ThreadPool pool(num_threads_);
+    std::vector<std::string> round;
+
+    for (const auto &path : paths)
+        if (std::find(round.begin(), round.end(), path) == round.end())
+            round.push_back(path);
+
+    // Included files are known only after the including file is parsed, so they are parsed in
+    // next round. All included files are parsed, also those in code skipped by '.ifdef'.
+    while (!round.empty()) {
+        std::vector<ParsedFile> parsed(round.size());
+        pool.Run(round.size(), [&](unsigned, size_t task) {
+            ParseFile(round[task], parsed[task]);
+        });
+
+        for (size_t i = 0; i < round.size(); i++) {
+            if (parsed[i].sf)
+                sources_.push_back(parsed[i].sf);
+            parsed_[round[i]] = std::move(parsed[i]);
+        }
 
-void spect::Compiler::Compile(std::string path)
+        std::vector<std::string> next;
+        for (const auto &path : round) {
+            for (const auto &rec : parsed_[path].records)
+                if (rec.type == RecordType::INCLUDE &&
+                    parsed_.find(rec.name) == parsed_.end() &&
+                    std::find(next.begin(), next.end(), rec.name) == next.end())
+                    next.push_back(rec.name);
+        }
+        round = std::move(next);
+    }
+}
+
+spect::Symbol* spect::Compiler::AddLabel(spect::SourceFile *sf, const std::string &ident,
+                                         int line_nr)
+{
+    Symbol *s = symbols_->GetSymbol(ident);
+    if (s) {
+        if (s->resolved_) {
+            char buf[128];
+            std::sprintf(buf, "Symbol: '%s' previously defined at: %s:%d",
+                            ident.c_str(), s->f_->path_.c_str(), s->line_nr_);
+            ErrorAt(std::string(buf), sf, line_nr, spect::ErrCode::SYMBOL);
+        } else {
+            symbols_->ResolveSymbol(s, SymbolType::LABEL, curr_addr_);
+            return s;
+        }
+    }
+
+    return symbols_->AddSymbol(ident, SymbolType::LABEL, curr_addr_, line_nr);
+}
+
+void spect::Compiler::AddConstant(spect::SourceFile *sf, const std::string &ident,
+                                  const std::string &val, int line_nr)
+{
+    Symbol *s = symbols_->GetSymbol(ident);
+    Symbol *s_dummy;
+
+    if (s) {
+        if (s->resolved_) {
+            char buf[128];
+            std::sprintf(buf, "Symbol: '%s' previously defined at: %s:%d",
+                            ident.c_str(), s->f_->path_.c_str(), s->line_nr_);
+            ErrorAt(std::string(buf), sf, line_nr, spect::ErrCode::SYMBOL);
+        } else {
+            symbols_->ResolveSymbol(s, SymbolType::CONSTANT,
+                                    ParseValue(sf, line_nr, val, s_dummy));
+        }
+    } else {
+        symbols_->AddSymbol(ident, SymbolType::CONSTANT,
+                            ParseValue(sf, line_nr, val, s_dummy), line_nr);
+    }
+
+    // TODO: Check s_dummy ??
+}
+
+void spect::Compiler::AddInstruction(spect::SourceFile *sf, spect::Instruction *instr,
+                                     int line_nr)
 {
-    SourceFile *sf = new spect::SourceFile(path, curr_addr_);
-    Symbol *label;
-    Symbol *last_label;
+    num_instr_++;
+
+    if (curr_addr_ >= SPECT_INSTR_MEM_BASE + SPECT_INSTR_MEM_SIZE) {
+        char buf[256];
+        std::sprintf(buf, "Program does not fit into Instruction memory. "
+                          "Address of first instruction: 0x%08x, "
+                          "Maximal program size till end of Instruction Memory: "
+                          "%d instructions",
+                        first_addr_,
+                        (SPECT_INSTR_MEM_BASE + SPECT_INSTR_MEM_SIZE - first_addr_) / 4);
+        ErrorAt(std::string(buf), sf, line_nr, spect::ErrCode::NOT_ENOUGH_SPACE);
+    }
+
+    program_->AppendInstruction(instr);
+    //print_fnc("%s", instr->Dump().c_str());
+    curr_addr_ += 4;
+}
+
+void spect::Compiler::IncludeFile(spect::SourceFile *sf, const std::string &new_file)
+{
+    print_fnc("Loading included file: %s\n", new_file.c_str());
+    LoadFile(new_file);
+    // Restore parent file handler
+    print_fnc("Back to file: %s\n", sf->path_.c_str());
     symbols_->curr_file_ = sf;
-    files_[path] = sf;
+}
 
-    print_fnc("Compiling: %s\n", path.c_str());
+void spect::Compiler::LoadRecords(spect::SourceFile *sf, const Records &records)
+{
+    typedef RecordType R;
 
-    for (unsigned int line_nr = 1; line_nr <= sf->lines_.size(); line_nr++) {
-        std::string line_buf = sf->lines_[line_nr - 1];
+    Symbol *last_label = nullptr;
 
-        // Remove comments
-        line_buf = std::regex_replace(line_buf, std::regex(";.*"), "");
-        TrimSpaces(line_buf);
+    for (const auto &rec : records) {
 
-        // Check for conditional compilation keywords
-        if (ParseCondCompile(sf, line_buf, line_nr))
+        // Conditional compilation keywords
+        if (rec.type == R::IFDEF) {
+            cond_stack_.push_front(!CondDefExists(rec.name));
             continue;
+        }
 
-        // Skip Parsing due to conditional compile
+        if (rec.type == R::ELSE || rec.type == R::ENDIF) {
+            if (cond_stack_.empty())
+                ErrorAt("No previous 'ifdef' defined!", sf, rec.line_nr, spect::ErrCode::SYNTAX);
+            bool top = cond_stack_.front();
+            cond_stack_.pop_front();
+            if (rec.type == R::ELSE)
+                cond_stack_.push_front(!top);
+            continue;
+        }
+
+        // Skip records due to conditional compile
         if (!ShouldParse())
             continue;
 
-        // Parse Label
-        label = ParseLabel(sf, line_buf, line_nr);
-        if (label)
-            last_label = label;
+        switch (rec.type) {
+        case R::DEFINE:
+            CondDefAdd(rec.name);
+            break;
 
-        if (line_buf.empty())
-            continue;
+        case R::LABEL:
+            last_label = AddLabel(sf, rec.name, rec.line_nr);
+            break;
 
-        TrimSpaces(line_buf);
+        case R::CONSTANT:
+            AddConstant(sf, rec.name, rec.val, rec.line_nr);
+            break;
 
-        // Check for definitions of constants
-        if (ParseConstant(sf, line_buf, line_nr))
-            continue;
+        case R::INCLUDE:
+            IncludeFile(sf, rec.name);
+            break;
 
-        // Check for include of another file
-        if (ParseIncludeFile(sf, line_buf))
-            continue;
+        case R::INSTRUCTION:
+        {
+            spect::Instruction *new_instr =
+                InstructionFactory::GetInstruction(isa_version_, rec.name)->Clone();
+            new_instr->s_label_ = last_label;
+            last_label = nullptr;
+
+            for (const auto &arg : rec.args)
+                ParseArgument(sf, rec.line_nr, new_instr, arg.text, arg.index);
 
-        spect::Instruction *new_instr = ParseInstruction(sf, line_buf, line_nr, last_label);
-        last_label = nullptr;
-
-        if (curr_addr_ >= SPECT_INSTR_MEM_BASE + SPECT_INSTR_MEM_SIZE) {
-            char buf[256];
-            std::sprintf(buf, "Program does not fit into Instruction memory. "
-                              "Address of first instruction: 0x%08x, "
-                              "Maximal program size till end of Instruction Memory: "
-                              "%d instructions",
-                            first_addr_,
-                            (SPECT_INSTR_MEM_BASE + SPECT_INSTR_MEM_SIZE - first_addr_) / 4);
-            ErrorAt(std::string(buf), sf, line_nr, spect::ErrCode::NOT_ENOUGH_SPACE);
+            if (!rec.val.empty())
+                ErrorAt(rec.val, sf, rec.line_nr, spect::ErrCode::SYNTAX);
+
+            AddInstruction(sf, new_instr, rec.line_nr);
+            break;
         }
 
-        program_->AppendInstruction(new_instr);
-        //print_fnc("%s", new_instr->Dump().c_str());
-        curr_addr_ += 4;
+        case R::ERROR:
+            ErrorAt(rec.val, sf, rec.line_nr, spect::ErrCode::SYNTAX);
+            break;
+
+        default:
+            break;
+        }
     }
 }
 
+void spect::Compiler::LoadFile(const std::string &path)
+{
+    auto it = parsed_.find(path);
+    assert(it != parsed_.end());
+    const ParsedFile &pf = it->second;
+
+    if (!pf.error.empty())
+        throw std::runtime_error(pf.error);
+
+    SourceFile *sf = pf.sf;
+    sf->first_addr_ = curr_addr_;
+    symbols_->curr_file_ = sf;
+    files_[path] = sf;
+
+    print_fnc("Compiling: %s\n", path.c_str());
+    LoadRecords(sf, pf.records);
+}
+
+void spect::Compiler::Compile(std::string path)
+{
+    Compile(std::vector<std::string>(1, path));
+}
+
+void spect::Compiler::Compile(const std::vector<std::string> &paths)
+{
+    parsed_.clear();
+
+    // First phase: Parse all files (and included files) in parallel
+    ParseFiles(paths);
+
+    // Second phase: Place instructions, define and resolve symbols in order of the files
+    for (const auto &path : paths)
+        LoadFile(path);
+}
+
 int spect::Compiler::CompileFinish()
 {
     int rv = 0;
@@ -471,23 +630,18 @@ int spect::Compiler::CompileFinish()
         Warning("Program is empty, no instructions found!");
         rv = 1;
     }
-    if (!symbols_->IsDefined(START_SYMBOL)) {
+    Symbol *s_start = symbols_->GetSymbol(START_SYMBOL);
+    if (!s_start) {
         Warning("'" START_SYMBOL "' symbol not found in the program!");
         rv = 1;
     } else
-        print_fnc("Program start address:     0x%4x\n", symbols_->GetSymbol(START_SYMBOL)->val_);
+        print_fnc("Program start address:     0x%4x\n", s_start->val_);
 
     print_fnc("%s\n", std::string(80, '*').c_str());
 
     return rv;
 }
 
-void spect::Compiler::TrimSpaces(std::string &input)
-{
-    input = std::regex_replace(input, std::regex("^ +"), "");
-    input = std::regex_replace(input, std::regex(" +$"), "");
-}
-
 void spect::Compiler::ErrorAt(std::string err, const SourceFile *sf, int line_nr,
                               spect::ErrCode err_code)
 {
@@ -10,12 +10,14 @@
 #define SPECT_LIB_COMPILER_H_
 
 #include <iostream>
+#include <map>
 
 #include "Instruction.h"
 #include "Symbol.h"
 #include "SymbolTable.h"
 #include "CpuProgram.h"
 #include "SourceFile.h"
+#include "Lexer.h"
 
 class spect::Compiler
 {
@@ -23,9 +25,10 @@ class spect::Compiler
 
         ///////////////////////////////////////////////////////////////////////////////////////////
         /// @brief New Compiler constructor
+        /// @param isa_version SPECT ISA version of compiled program
         /// @returns New model object
         ///////////////////////////////////////////////////////////////////////////////////////////
-        Compiler(void);
+        Compiler(int isa_version);
 
         ///////////////////////////////////////////////////////////////////////////////////////////
         /// @brief Compiler destructor
@@ -46,6 +49,19 @@ class spect::Compiler
         ///////////////////////////////////////////////////////////////////////////////////////////
         void Compile(std::string path);
 
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Compile program made of multiple files. Compiled in two phases:
+        ///         1. Files and all files they include are parsed to records in parallel by
+        ///            'num_threads_' threads.
+        ///         2. Records are loaded in order of 'paths' (includes are loaded in place of
+        ///            '.include'). Instructions are placed at addresses and symbols are defined.
+        ///        Result (including printed messages) is the same as when 'Compile' is called for
+        ///        each file of 'paths' in order.
+        /// @param paths Paths to SPECT .s files
+        /// @throw std::runtime_error upon compilation error
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void Compile(const std::vector<std::string> &paths);
+
         ///////////////////////////////////////////////////////////////////////////////////////////
         /// @brief Finalize compilation (to be called after 'Compile'). Only prints stas of
         ///        compiled program.
@@ -96,13 +112,16 @@ class spect::Compiler
         ///////////////////////////////////////////////////////////////////////////////////////////
         void WarningAt(std::string warn, const SourceFile *sf, int line_nr);
 
+        // SPECT ISA version of compiled program
+        const int isa_version_;
+
         // Pointer to symbol table
         spect::SymbolTable *symbols_;
 
         // Pointer to compiled program
         spect::CpuProgram *program_ = nullptr;
 
-        // Pointer to source files (.s) used for compilation
+        // Pointer to source files (.s) used for compilation (owned by 'sources_')
         std::map<std::string, spect::SourceFile*> files_;
 
         // Address where first compiled instruction is placed (set by constructor)
@@ -117,19 +136,99 @@ class spect::Compiler
         // Print function - By default 'printf'
         int (*print_fnc)(const char *format, ...);
 
+        // Number of threads parsing source files, 0 - Number of hardware threads
+        unsigned num_threads_ = 1;
+
     private:
-        void TrimSpaces(std::string &input);
+
+        // Record of parsed source file, in source order:
+        //  DEFINE, IFDEF, ELSE, ENDIF - Conditional compilation directives
+        //  LABEL, CONSTANT            - Defined label / constant
+        //  INCLUDE                    - Included file
+        //  INSTRUCTION                - Instruction mnemonic and text of its arguments
+        //  ERROR                      - Syntax error
+        // Conditional compilation is evaluated and errors are reported in the second phase, so
+        // also lines in code skipped by '.ifdef' are recorded.
+        enum class RecordType {
+            DEFINE,
+            IFDEF,
+            ELSE,
+            ENDIF,
+            LABEL,
+            CONSTANT,
+            INCLUDE,
+            INSTRUCTION,
+            ERROR
+        };
+
+        struct Argument {
+            // Index of argument (1 - 3) passed to 'ParseArgument'
+            int index;
+            std::string text;
+        };
+
+        struct Record {
+            Record(RecordType rec_type, int rec_line_nr, const std::string &rec_name = "",
+                   const std::string &rec_val = "", const std::vector<Argument> &rec_args = {}) :
+                type(rec_type), line_nr(rec_line_nr), name(rec_name), val(rec_val),
+                args(rec_args) {}
+
+            RecordType type;
+            int line_nr;
+
+            // DEFINE, IFDEF, LABEL, CONSTANT - Identifier, INCLUDE - Path,
+            // INSTRUCTION - Mnemonic
+            std::string name;
+
+            // CONSTANT - Value, INSTRUCTION - Error found after the arguments (empty if none),
+            // ERROR - Error message
+            std::string val;
+
+            // INSTRUCTION - Arguments
+            std::vector<Argument> args;
+        };
+
+        typedef std::vector<Record> Records;
+
+        // Source file parsed in the first phase of compilation
+        struct ParsedFile {
+            spect::SourceFile *sf = nullptr;
+            Records records;
+
+            // Error when reading the file (reported when the file is loaded)
+            std::string error;
+        };
+
+        // First phase (thread safe, only records content of the file)
+        bool ParseCondCompile(spect::Lexer &lex, int line_nr, Records &records);
+        void ParseLabel(spect::Lexer &lex, int line_nr, Records &records);
+        bool ParseConstant(spect::Lexer &lex, int line_nr, Records &records);
+        bool ParseIncludeFile(const spect::SourceFile *sf, spect::Lexer &lex, int line_nr,
+                              Records &records);
+        void ParseInstruction(spect::Lexer &lex, int line_nr, Records &records);
+        void ParseSource(const spect::SourceFile *sf, Records &records);
+        void ParseFile(const std::string &path, ParsedFile &pf);
+        void ParseFiles(const std::vector<std::string> &paths);
+
+        // Second phase (defines symbols and places instructions)
         uint32_t ParseValue(spect::SourceFile *sf, int line_nr, const std::string &val,
                             spect::Symbol* &s, uint32_t limit = 0);
         void ParseArgument(spect::SourceFile *sf, int line_nr, spect::Instruction* instr,
-                            std::string &arg, int arg_index);
-        spect::Symbol* ParseLabel(spect::SourceFile *sf, std::string &line_buf, int line_nr);
-        bool ParseConstant(spect::SourceFile *sf, std::string &line_buf, int line_nr);
-        bool ParseIncludeFile(spect::SourceFile *sf, std::string &line_buf);
-        spect::Instruction* ParseInstruction(spect::SourceFile *sf, std::string &line_buf,
-                                             int line_nr,  spect::Symbol *label);
-        spect::CpuGpr ParseOp(spect::SourceFile *sf, int line_nr, std::string &arg);
-        bool ParseCondCompile(spect::SourceFile *sf, std::string &line_buf, int line_nr);
+                            const std::string &arg, int arg_index);
+        spect::CpuGpr ParseOp(spect::SourceFile *sf, int line_nr, const std::string &arg);
+        spect::Symbol* AddLabel(spect::SourceFile *sf, const std::string &ident, int line_nr);
+        void AddConstant(spect::SourceFile *sf, const std::string &ident, const std::string &val,
+                         int line_nr);
+        void AddInstruction(spect::SourceFile *sf, spect::Instruction *instr, int line_nr);
+        void IncludeFile(spect::SourceFile *sf, const std::string &new_file);
+        void LoadRecords(spect::SourceFile *sf, const Records &records);
+        void LoadFile(const std::string &path);
+
+        // Files parsed in first phase of compilation
+        std::map<std::string, ParsedFile> parsed_;
+
+        // All source files read by the compiler
+        std::vector<spect::SourceFile*> sources_;
 
         std::list<bool> cond_stack_;
         std::vector<std::string> cond_defs_;
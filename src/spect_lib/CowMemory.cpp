@@ -0,0 +1,87 @@
+/**************************************************************************************************
+*
+* SPECT Compiler
+* Copyright (C) 2022-present Tropic Square
+*
+* @todo: License
+*
+**************************************************************************************************/
+
+#include <algorithm>
+#include <cassert>
+
+#include "CowMemory.h"
+
+spect::CowMemory::CowMemory(size_t size, size_t page_size) :
+    page_mask_(page_size - 1),
+    private_(size / page_size, nullptr)
+{
+    assert(size % page_size == 0);
+    assert((page_size & page_mask_) == 0);
+
+    while ((size_t(1) << page_shift_) < page_size)
+        page_shift_++;
+
+    zero_page_ = std::make_shared<const Page>(page_size, 0);
+    ones_page_ = std::make_shared<const Page>(page_size, 0xFFFFFFFF);
+    pages_.assign(size / page_size, zero_page_);
+}
+
+void spect::CowMemory::Read(size_t index, uint32_t *data, size_t size) const
+{
+    for (size_t i = 0; i < size; i++)
+        data[i] = Read(index + i);
+}
+
+void spect::CowMemory::Write(size_t index, const uint32_t *data, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+        Write(index + i, data[i]);
+}
+
+spect::CowMemory::Pages spect::CowMemory::Snapshot()
+{
+    for (size_t i = 0; i < pages_.size(); i++) {
+        if (private_[i] == nullptr)
+            continue;
+
+        // Erased / unused memory is not kept in separate pages
+        const Page &page = *pages_[i];
+        if (std::all_of(page.begin(), page.end(), [](uint32_t wrd) { return wrd == 0; }))
+            pages_[i] = zero_page_;
+        else if (std::all_of(page.begin(), page.end(), [](uint32_t wrd) { return wrd == 0xFFFFFFFF; }))
+            pages_[i] = ones_page_;
+
+        // Page is shared with snapshot from now on, next write copies it
+        private_[i] = nullptr;
+    }
+    return pages_;
+}
+
+void spect::CowMemory::Restore(const Pages &pages)
+{
+    assert(pages.size() == pages_.size());
+
+    pages_ = pages;
+    std::fill(private_.begin(), private_.end(), nullptr);
+}
+
+void spect::CowMemory::Share(size_t index, const Pages &pages)
+{
+    assert((index & page_mask_) == 0);
+    assert((index >> page_shift_) + pages.size() <= pages_.size());
+
+    size_t first = index >> page_shift_;
+    for (size_t i = 0; i < pages.size(); i++) {
+        assert(pages[i]->size() == page_mask_ + 1);
+        pages_[first + i] = pages[i];
+        private_[first + i] = nullptr;
+    }
+}
+
+void spect::CowMemory::MakePrivate(size_t page)
+{
+    auto copy = std::make_shared<Page>(*pages_[page]);
+    private_[page] = copy->data();
+    pages_[page] = std::move(copy);
+}
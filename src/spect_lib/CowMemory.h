@@ -0,0 +1,137 @@
+/**************************************************************************************************
+*
+* SPECT Compiler
+* Copyright (C) 2022-present Tropic Square
+*
+* @todo: License
+*
+**************************************************************************************************/
+
+#ifndef SPECT_LIB_COW_MEMORY_H_
+#define SPECT_LIB_COW_MEMORY_H_
+
+#include <memory>
+#include <vector>
+
+#include "spect.h"
+
+// Size of memory page of model memory and its snapshots (in 32 bit words)
+#define SPECT_SNAPSHOT_PAGE_SIZE 64
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Copy-on-write paged memory
+//  Memory is split to pages of fixed size. Each page is either shared (immutable page which
+//  can be referenced also by snapshots, program images or other memories), or private (owned
+//  by this memory only). Page is copied to private page on first write which modifies it.
+//
+//  Snapshot hands out current pages, private pages become shared. Restore replaces pages by
+//  pages of snapshot. Neither of them copies content of pages. Memories restored from the
+//  same snapshot, or sharing the same pages (Share), therefore hold only pages they modified.
+//  All-zero / all-ones pages are shared when snapshot is taken.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+class spect::CowMemory
+{
+    public:
+        typedef std::vector<uint32_t> Page;
+        typedef std::vector<std::shared_ptr<const Page>> Pages;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Copy-on-write memory constructor. All words of memory are zero.
+        /// @param size Size of memory in 32 bit words, multiple of 'page_size'
+        /// @param page_size Size of page in 32 bit words, power of two
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        CowMemory(size_t size, size_t page_size);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Read word of memory
+        /// @param index Index of the word within memory
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        uint32_t Read(size_t index) const
+        {
+            return (*pages_[index >> page_shift_])[index & page_mask_];
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Write word of memory
+        /// @param index Index of the word within memory
+        /// @param data Data to write
+        /// @note Write of the same value does not make page private.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void Write(size_t index, uint32_t data)
+        {
+            size_t page = index >> page_shift_;
+            if (private_[page] == nullptr) {
+                if ((*pages_[page])[index & page_mask_] == data)
+                    return;
+                MakePrivate(page);
+            }
+            private_[page][index & page_mask_] = data;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Read block of words
+        /// @param index Index of first word within memory
+        /// @param data Buffer for read words
+        /// @param size Number of words
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void Read(size_t index, uint32_t *data, size_t size) const;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Write block of words
+        /// @param index Index of first word within memory
+        /// @param data Words to write
+        /// @param size Number of words
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void Write(size_t index, const uint32_t *data, size_t size);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Take snapshot of memory
+        /// @returns Pages with current memory content
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        Pages Snapshot();
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Restore memory content from snapshot
+        /// @param pages Snapshot of memory with the same size and page size
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void Restore(const Pages &pages);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Replace part of memory by shared pages
+        /// @param index Index of first word within memory, multiple of page size
+        /// @param pages Pages with the same page size (e.g. snapshot of smaller memory)
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void Share(size_t index, const Pages &pages);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @param index Index of word within memory
+        /// @param page Shared page
+        /// @returns True if page with the word is 'page', False otherwise (different or private
+        ///          page, even if content is equal)
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        bool IsShared(size_t index, const std::shared_ptr<const Page> &page) const
+        {
+            return pages_[index >> page_shift_] == page;
+        }
+
+    private:
+        // Replace shared page by its private copy
+        void MakePrivate(size_t page);
+
+        // log2 of page size and mask of word index within page
+        size_t page_shift_ = 0;
+        const size_t page_mask_;
+
+        // Pages of memory
+        Pages pages_;
+
+        // Writable content of private pages, nullptr for shared pages
+        std::vector<uint32_t*> private_;
+
+        // Pages filled by all zeros / all ones, shared by all such pages
+        std::shared_ptr<const Page> zero_page_;
+        std::shared_ptr<const Page> ones_page_;
+};
+
+#endif
@@ -10,91 +10,115 @@
 *
 *****************************************************************************/
 
+#include <algorithm>
 #include <fstream>
 #include <cstdarg>
+#include <cstring>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "CpuModel.h"
 
 #include "InstructionDefs.h"
 #include "InstructionFactory.h"
+#include "FastEngine.h"
+#include "HexHandler.h"
+#include "ProgramImage.h"
+#include "CpuSnapshot.h"
+#include "CpuSimulator.h"
+#include "KeyMemory.h"
 
 
-spect::CpuModel::CpuModel(bool instr_mem_ahb_w, bool instr_mem_ahb_r) :
+spect::CpuModel::CpuModel(int isa_version, bool instr_mem_ahb_w, bool instr_mem_ahb_r) :
+    memory_(SPECT_TOTAL_MEM_SIZE / 4, SPECT_SNAPSHOT_PAGE_SIZE),
+    isa_version_(isa_version),
     instr_mem_ahb_w_(instr_mem_ahb_w),
     instr_mem_ahb_r_(instr_mem_ahb_r)
 {
-    memory_ = new uint32_t[SPECT_TOTAL_MEM_SIZE / 4];
+    assert(isa_version > 0 && isa_version <= NUM_ISA_VERSIONS);
+
     regs_ = new ordt_root();
     print_fnc = &(printf);
+
+    instr_stats_ = new InstrStats[spect::InstructionFactory::GetInstructionCount()];
+    for (int i = 0; i < spect::InstructionFactory::GetInstructionCount(); i++) {
+        instr_stats_[i].exec_cnt = 0;
+        instr_stats_[i].cycles = spect::InstructionFactory::GetInstructionById(i)->cycles_;
+    }
+
     Reset();
 }
 
 spect::CpuModel::~CpuModel()
 {
-    delete memory_;
+    InvalidateInstructionCache();
+    delete fast_engine_;
     delete regs_;
+    delete[] instr_stats_;
 }
 
 void spect::CpuModel::Start()
 {
-    DebugInfo(VERBOSITY_LOW, "Starting program execution...");
+    DEBUG_INFO(this, VERBOSITY_LOW, "Starting program execution...");
     if (timing_accurate_sim_) {
         char buf[12];
         sprintf(buf, "%10d", execution_time_step_);
-        DebugInfo(VERBOSITY_LOW, "Running in timing accurate mode with time step:", buf, "us.");
+        DEBUG_INFO(this, VERBOSITY_LOW, "Running in timing accurate mode with time step:", buf, "us.");
     }
-    DebugInfo(VERBOSITY_LOW, "First instruction address:", tohexs(start_pc_, 4));
+    DEBUG_INFO(this, VERBOSITY_LOW, "First instruction address:", tohexs(start_pc_, 4));
     SetPc(start_pc_);
 
-    DebugInfo(VERBOSITY_MEDIUM, "SPECT is clearing COMMAND[START] = 0.");
+    // Content of Instruction memory might have changed since last run
+    InvalidateInstructionCache();
+
+    DEBUG_INFO(this, VERBOSITY_MEDIUM, "SPECT is clearing COMMAND[START] = 0.");
     regs_->r_command.f_start.data = 0;
 
-    DebugInfo(VERBOSITY_MEDIUM, "SPECT is clearing STATUS[IDLE] = 0.");
+    DEBUG_INFO(this, VERBOSITY_MEDIUM, "SPECT is clearing STATUS[IDLE] = 0.");
     regs_->r_status.f_idle.data = 0;
     UpdateInterrupts();
 
     end_executed_ = false;
 
     // Erase track of execution count
-    auto it = spect::InstructionFactory::GetInstructionIterator();
-    for (; !spect::InstructionFactory::IteratorIsLast(it); it++) {
-        Instruction *instr = it->second;
-        instr->exec_cnt_ = 0;
-    }
+    for (int i = 0; i < spect::InstructionFactory::GetInstructionCount(); i++)
+        instr_stats_[i].exec_cnt = 0;
 
     // Erase track of number of executed instructions
     instr_cnt_ = 0;
 
     // To make browsing logs easier
-    DebugInfo(VERBOSITY_LOW, "");
+    DEBUG_INFO(this, VERBOSITY_LOW, "");
 }
 
 void spect::CpuModel::Finish(int status_err)
 {
     end_executed_ = true;
-    DebugInfo(VERBOSITY_LOW, "Finishing program execution...");
+    DEBUG_INFO(this, VERBOSITY_LOW, "Finishing program execution...");
 
-    DebugInfo(VERBOSITY_MEDIUM, "SPECT setting STATUS[IDLE] = 1.");
+    DEBUG_INFO(this, VERBOSITY_MEDIUM, "SPECT setting STATUS[IDLE] = 1.");
     regs_->r_status.f_idle.data = 1;
 
-    DebugInfo(VERBOSITY_MEDIUM, "SPECT setting STATUS[DONE] = ", !status_err);
+    DEBUG_INFO(this, VERBOSITY_MEDIUM, "SPECT setting STATUS[DONE] = ", !status_err);
     regs_->r_status.f_done.data = !status_err;
 
-    DebugInfo(VERBOSITY_MEDIUM, "SPECT setting STATUS[ERR] = ", status_err);
+    DEBUG_INFO(this, VERBOSITY_MEDIUM, "SPECT setting STATUS[ERR] = ", status_err);
     regs_->r_status.f_err.data = status_err;
 
 
-    DebugInfo(VERBOSITY_HIGH, "Program statistics:");
-    DebugInfo(VERBOSITY_HIGH, "     Instruction         No. of Executions       Cycles per instruction");
-    auto it = spect::InstructionFactory::GetInstructionIterator();
-    for (; !spect::InstructionFactory::IteratorIsLast(it); it++) {
+    DEBUG_INFO(this, VERBOSITY_HIGH, "Program statistics:");
+    DEBUG_INFO(this, VERBOSITY_HIGH, "     Instruction         No. of Executions       Cycles per instruction");
+    auto it = spect::InstructionFactory::GetInstructionIterator(isa_version_);
+    for (; !spect::InstructionFactory::IteratorIsLast(isa_version_, it); it++) {
         Instruction *instr = it->second;
-        if (instr->exec_cnt_ > 0) {
+        InstrStats &stats = instr_stats_[instr->id_];
+        if (stats.exec_cnt > 0) {
             char buf[128];
             sprintf(buf, "   %10s                   %4lu                        %4d", instr->mnemonic_.c_str(),
-                    instr->exec_cnt_, instr->cycles_);
-            DebugInfo(VERBOSITY_HIGH, buf);
+                    stats.exec_cnt, stats.cycles);
+            DEBUG_INFO(this, VERBOSITY_HIGH, buf);
         }
     }
 }
@@ -106,16 +130,19 @@ bool spect::CpuModel::IsFinished()
 
 void spect::CpuModel::SetStartPc(uint16_t start_pc)
 {
-    DebugInfo(VERBOSITY_MEDIUM, "Setting Start PC to:", tohexs(start_pc, 4));
+    DEBUG_INFO(this, VERBOSITY_MEDIUM, "Setting Start PC to:", tohexs(start_pc, 4));
     start_pc_ = start_pc;
 }
 
 void spect::CpuModel::SetMemory(uint16_t address, uint32_t data)
 {
-    DebugInfo(VERBOSITY_MEDIUM, "Setting memory, address:", tohexs(address, 4),
+    DEBUG_INFO(this, VERBOSITY_MEDIUM, "Setting memory, address:", tohexs(address, 4),
                                  "data:", tohexs(data, 8));
 
-    memory_[address >> 2] = data;
+    memory_.Write(address >> 2, data);
+
+    if (IsWithinMem(CpuMemory::INSTR_MEM, address))
+        InvalidateInstructionCacheAt(address);
 
     if (IsWithinMem(CpuMemory::CONFIG_REGS, address)) {
         ordt_data wdata(1, data);
@@ -127,7 +154,7 @@ void spect::CpuModel::SetMemory(uint16_t address, uint32_t data)
 
 uint32_t spect::CpuModel::GetMemory(uint16_t address)
 {
-    uint32_t rv = memory_[address >> 2];
+    uint32_t rv = memory_.Read(address >> 2);
 
     if (IsWithinMem(CpuMemory::CONFIG_REGS, address)) {
         ordt_data rdata(1, 0);
@@ -135,29 +162,168 @@ uint32_t spect::CpuModel::GetMemory(uint16_t address)
         rv = rdata[0];
     }
 
-    DebugInfo(VERBOSITY_MEDIUM, "Getting memory, address:", tohexs(address, 4),
+    DEBUG_INFO(this, VERBOSITY_MEDIUM, "Getting memory, address:", tohexs(address, 4),
                                     "data:", tohexs(rv, 8));
 
     return rv;
 }
 
-uint32_t* spect::CpuModel::GetMemoryPtr()
+void spect::CpuModel::ReadMemoryBlock(uint32_t address, uint32_t *data, uint32_t size)
+{
+    memory_.Read(address >> 2, data, size >> 2);
+}
+
+void spect::CpuModel::WriteMemoryBlock(uint32_t address, const uint32_t *data, uint32_t size)
+{
+    for (uint32_t i = 0; i < (size >> 2); i++) {
+        uint32_t index = (address >> 2) + i;
+        if (memory_.Read(index) == data[i])
+            continue;
+
+        memory_.Write(index, data[i]);
+        if (IsWithinMem(CpuMemory::INSTR_MEM, index << 2))
+            InvalidateInstructionCacheAt(index << 2);
+    }
+}
+
+void spect::CpuModel::LoadHexFile(const std::string &path, uint32_t offset)
+{
+    DEBUG_INFO(this, VERBOSITY_MEDIUM, "Loading HEX file:", path);
+
+    // Words not present in HEX file keep their value, only modified pages are copied
+    std::vector<uint32_t> mem(SPECT_TOTAL_MEM_SIZE / 4);
+    ReadMemoryBlock(0, mem.data(), SPECT_TOTAL_MEM_SIZE);
+    HexHandler::LoadHexFile(path, mem.data(), offset);
+    WriteMemoryBlock(0, mem.data(), SPECT_TOTAL_MEM_SIZE);
+}
+
+void spect::CpuModel::DumpHexFile(const std::string &path, HexFileType hex_type,
+                                  uint32_t offset, uint32_t size)
+{
+    DEBUG_INFO(this, VERBOSITY_MEDIUM, "Dumping HEX file:", path);
+
+    std::vector<uint32_t> mem(SPECT_TOTAL_MEM_SIZE / 4);
+    ReadMemoryBlock(offset, mem.data() + (offset >> 2), size);
+    HexHandler::DumpHexFile(path, hex_type, mem.data(), offset, size);
+}
+
+void spect::CpuModel::InvalidateInstructionCache()
+{
+    for (int i = 0; i < (SPECT_INSTR_MEM_SIZE / 4); i += SPECT_SNAPSHOT_PAGE_SIZE) {
+        auto &page = instr_cache_[i / SPECT_SNAPSHOT_PAGE_SIZE];
+        if (!page)
+            continue;
+        for (int j = 0; j < SPECT_SNAPSHOT_PAGE_SIZE; j++) {
+            if (!image_ || page[j] != image_->GetInstruction(i + j))
+                delete page[j];
+        }
+        page.reset();
+    }
+
+    if (fast_engine_)
+        fast_engine_->Invalidate();
+}
+
+void spect::CpuModel::InvalidateInstructionCacheAt(uint16_t address)
+{
+    int index = (address - SPECT_INSTR_MEM_BASE) >> 2;
+    auto &page = instr_cache_[index / SPECT_SNAPSHOT_PAGE_SIZE];
+    if (page) {
+        Instruction *&instr = page[index % SPECT_SNAPSHOT_PAGE_SIZE];
+        if (!image_ || instr != image_->GetInstruction(index))
+            delete instr;
+        instr = nullptr;
+    }
+    if (fast_engine_)
+        fast_engine_->InvalidateAt(address);
+}
+
+bool spect::CpuModel::IsImagePage(int index)
+{
+    return image_ && image_->GetParityType() == GetParityType() &&
+           memory_.IsShared((SPECT_INSTR_MEM_BASE >> 2) + index,
+                            image_->GetInstrMem()[index / SPECT_SNAPSHOT_PAGE_SIZE]);
+}
+
+bool spect::CpuModel::IsInstructionDecoded(int index)
+{
+    const auto &page = instr_cache_[index / SPECT_SNAPSHOT_PAGE_SIZE];
+    return IsImagePage(index) || (page && page[index % SPECT_SNAPSHOT_PAGE_SIZE]);
+}
+
+spect::Instruction* spect::CpuModel::GetDecodedInstruction(int index)
+{
+    // Page not modified since image was loaded, execute instruction decoded by the image
+    if (IsImagePage(index))
+        return image_->GetInstruction(index);
+
+    auto &page = instr_cache_[index / SPECT_SNAPSHOT_PAGE_SIZE];
+    if (!page)
+        page.reset(new Instruction*[SPECT_SNAPSHOT_PAGE_SIZE]());
+
+    Instruction *&instr = page[index % SPECT_SNAPSHOT_PAGE_SIZE];
+    if (instr != nullptr)
+        return instr;
+
+    uint32_t wrd = memory_.Read((SPECT_INSTR_MEM_BASE >> 2) + index);
+
+    // Word not modified since image was loaded, share instruction decoded by the image
+    if (image_ && image_->GetParityType() == GetParityType() &&
+        image_->GetInstrMemWord(index) == wrd)
+        instr = image_->GetInstruction(index);
+    else
+        instr = spect::Instruction::DisAssemble(isa_version_, GetParityType(), wrd);
+
+    return instr;
+}
+
+void spect::CpuModel::SetProgramImage(std::shared_ptr<const ProgramImage> image)
+{
+    if (image && image->GetIsaVersion() != isa_version_)
+        throw std::runtime_error("Program image ISA version " +
+                                 std::to_string(image->GetIsaVersion()) +
+                                 " does not match model ISA version " +
+                                 std::to_string(isa_version_));
+
+    // Drop instructions of previous image before it is released
+    InvalidateInstructionCache();
+    image_ = image;
+
+    if (image_) {
+        DEBUG_INFO(this, VERBOSITY_MEDIUM, "Loading program image");
+
+        // Memory pages are shared with the image until they are written
+        memory_.Share(SPECT_INSTR_MEM_BASE >> 2, image_->GetInstrMem());
+        memory_.Share(SPECT_CONST_ROM_BASE >> 2, image_->GetConstRom());
+
+        SetStartPc(image_->GetStartPc());
+    }
+
+    // Fast engine might still point to pages of previous image
+    if (fast_engine_)
+        fast_engine_->Invalidate();
+}
+
+const std::shared_ptr<const spect::ProgramImage>& spect::CpuModel::GetProgramImage()
 {
-    return memory_;
+    return image_;
 }
 
 void spect::CpuModel::WriteMemoryAhb(uint16_t address, uint32_t data)
 {
-    DebugInfo(VERBOSITY_MEDIUM, "AHB Write", tohexs(address, 4), "data:", tohexs(data, 8));
+    DEBUG_INFO(this, VERBOSITY_MEDIUM, "AHB Write", tohexs(address, 4), "data:", tohexs(data, 8));
 
     DEFINE_CHANGE(ch_mem, DPI_CHANGE_MEM, address);
 
     if ( IsWithinMem(CpuMemory::DATA_RAM_IN, address) ||
         (IsWithinMem(CpuMemory::INSTR_MEM, address) && instr_mem_ahb_w_)) {
-        ch_mem.old_val[0] = memory_[address >> 2];
-        memory_[address >> 2] = data;
+        ch_mem.old_val[0] = memory_.Read(address >> 2);
+        memory_.Write(address >> 2, data);
         ch_mem.new_val[0] = data;
         ReportChange(ch_mem);
+
+        if (IsWithinMem(CpuMemory::INSTR_MEM, address))
+            InvalidateInstructionCacheAt(address);
     }
 
     if (IsWithinMem(CpuMemory::CONFIG_REGS, address)) {
@@ -175,7 +341,7 @@ uint32_t spect::CpuModel::ReadMemoryAhb(uint16_t address)
     if ( IsWithinMem(CpuMemory::DATA_RAM_OUT, address) ||
          IsWithinMem(CpuMemory::CONST_ROM, address)    ||
         (IsWithinMem(CpuMemory::INSTR_MEM, address) && instr_mem_ahb_r_))
-        rv = memory_[address >> 2];
+        rv = memory_.Read(address >> 2);
 
     if (IsWithinMem(CpuMemory::CONFIG_REGS, address)) {
         ordt_data rdata(1, 0);
@@ -183,7 +349,7 @@ uint32_t spect::CpuModel::ReadMemoryAhb(uint16_t address)
         rv = rdata[0];
     }
 
-    DebugInfo(VERBOSITY_MEDIUM, "AHB Read", tohexs(address, 4), "data:", tohexs(rv, 8));
+    DEBUG_INFO(this, VERBOSITY_MEDIUM, "AHB Read", tohexs(address, 4), "data:", tohexs(rv, 8));
     return rv;
 }
 
@@ -192,35 +358,35 @@ uint32_t spect::CpuModel::ReadMemoryCoreData(uint16_t address)
     uint32_t rv = 0;
     if (IsWithinMem(CpuMemory::DATA_RAM_IN, address) ||
         IsWithinMem(CpuMemory::CONST_ROM, address))
-        rv = memory_[address >> 2];
+        rv = memory_.Read(address >> 2);
 
     if (IsWithinMem(CpuMemory::EMEM_IN, address)) {
         DEFINE_CHANGE(ch_emem, DPI_CHANGE_MEM, address);
-        rv = memory_[address >> 2];
+        rv = memory_.Read(address >> 2);
         ReportChange(ch_emem);
     }
 
-    DebugInfo(VERBOSITY_MEDIUM, "Core Read", tohexs(address, 4), "data:", tohexs(rv, 8));
+    DEBUG_INFO(this, VERBOSITY_MEDIUM, "Core Read", tohexs(address, 4), "data:", tohexs(rv, 8));
 
     return rv;
 }
 
 void spect::CpuModel::WriteMemoryCoreData(uint16_t address, uint32_t data)
 {
-    DebugInfo(VERBOSITY_MEDIUM, "Core Write", tohexs(address, 4), "data:", tohexs(data, 8));
+    DEBUG_INFO(this, VERBOSITY_MEDIUM, "Core Write", tohexs(address, 4), "data:", tohexs(data, 8));
 
     if (IsWithinMem(CpuMemory::DATA_RAM_IN, address) ||
         IsWithinMem(CpuMemory::DATA_RAM_OUT, address)) {
         DEFINE_CHANGE(ch_mem, DPI_CHANGE_MEM, address);
-        ch_mem.old_val[0] = memory_[address >> 2];
-        memory_[address >> 2] = data;
+        ch_mem.old_val[0] = memory_.Read(address >> 2);
+        memory_.Write(address >> 2, data);
         ch_mem.new_val[0] = data;
         ReportChange(ch_mem);
     }
 
     if (IsWithinMem(CpuMemory::EMEM_OUT, address)) {
         DEFINE_CHANGE(ch_emem, DPI_CHANGE_MEM, address);
-        memory_[address >> 2] = data;
+        memory_.Write(address >> 2, data);
         ch_emem.new_val[0] = data;
         ReportChange(ch_emem);
     }
@@ -228,9 +394,9 @@ void spect::CpuModel::WriteMemoryCoreData(uint16_t address, uint32_t data)
 
 uint32_t spect::CpuModel::ReadMemoryCoreFetch(uint16_t address)
 {
-    DebugInfo(VERBOSITY_MEDIUM, "Fetching instruction, address: ", tohexs(address, 4));
+    DEBUG_INFO(this, VERBOSITY_MEDIUM, "Fetching instruction, address: ", tohexs(address, 4));
     if (IsWithinMem(CpuMemory::INSTR_MEM, address)) {
-        return memory_[address >> 2];
+        return memory_.Read(address >> 2);
     }
     return 0x0;
 }
@@ -242,10 +408,19 @@ const uint256_t& spect::CpuModel::GetGpr(int index)
 
 void spect::CpuModel::SetGpr(int index, const uint256_t &val)
 {
-    std::stringstream ss;
-    ss << static_cast<CpuGpr>(index);
-    DebugInfo(VERBOSITY_MEDIUM, "Setting", ss.str(), "to", tohexs(val));
+    DEBUG_INFO(this, VERBOSITY_MEDIUM, "Setting", static_cast<CpuGpr>(index), "to", tohexs(val));
     gpr_[index] = val;
+    if (index == TO_INT(CpuGpr::R31))
+        r31_red_valid_ = false;
+}
+
+const spect::ModularReduction& spect::CpuModel::GetR31Reduction()
+{
+    if (!r31_red_valid_) {
+        r31_red_.SetModulus(gpr_[TO_INT(CpuGpr::R31)]);
+        r31_red_valid_ = true;
+    }
+    return r31_red_;
 }
 
 uint16_t spect::CpuModel::GetPc()
@@ -255,7 +430,7 @@ uint16_t spect::CpuModel::GetPc()
 
 void spect::CpuModel::SetPc(uint16_t val)
 {
-    DebugInfo(VERBOSITY_MEDIUM, "Setting PC to", tohexs(val, 4));
+    DEBUG_INFO(this, VERBOSITY_MEDIUM, "Setting PC to", tohexs(val, 4));
     pc_ = val;
 }
 
@@ -263,15 +438,15 @@ void spect::CpuModel::SetCpuFlag(CpuFlagType type, bool val)
 {
     switch (type) {
     case CpuFlagType::ZERO:
-        DebugInfo(VERBOSITY_MEDIUM, "Setting Z flag to", val);
+        DEBUG_INFO(this, VERBOSITY_MEDIUM, "Setting Z flag to", val);
         flags_.zero = val;
         break;
     case CpuFlagType::CARRY:
-        DebugInfo(VERBOSITY_MEDIUM, "Setting C flag to", val);
+        DEBUG_INFO(this, VERBOSITY_MEDIUM, "Setting C flag to", val);
         flags_.carry = val;
         break;
     case CpuFlagType::ERROR:
-        DebugInfo(VERBOSITY_MEDIUM, "Setting E flag to", val);
+        DEBUG_INFO(this, VERBOSITY_MEDIUM, "Setting E flag to", val);
         flags_.error = val;
         break;
     default:
@@ -300,10 +475,10 @@ spect::CpuFlags spect::CpuModel::GetCpuFlags()
 
 void spect::CpuModel::RarPush(uint16_t ret_addr)
 {
-    DebugInfo(VERBOSITY_MEDIUM, "Pushing", tohexs(ret_addr, 4), "to RAR stack.");
+    DEBUG_INFO(this, VERBOSITY_MEDIUM, "Pushing", tohexs(ret_addr, 4), "to RAR stack.");
 
     if (GetRarSp() == SPECT_RAR_DEPTH)
-        DebugInfo(VERBOSITY_LOW, "FATAL: RAR stack overflow");
+        DEBUG_INFO(this, VERBOSITY_LOW, "FATAL: RAR stack overflow");
 
     rar_stack_[rar_sp_] = ret_addr;
     SetRarSp(GetRarSp() + 1);
@@ -312,12 +487,12 @@ void spect::CpuModel::RarPush(uint16_t ret_addr)
 uint16_t spect::CpuModel::RarPop()
 {
     if (GetRarSp() == 0)
-        DebugInfo(VERBOSITY_LOW, "FATAL: RAR stack underflow");
+        DEBUG_INFO(this, VERBOSITY_LOW, "FATAL: RAR stack underflow");
 
     SetRarSp(GetRarSp() - 1);
     uint16_t rv = GetRarAt(GetRarSp());
 
-    DebugInfo(VERBOSITY_MEDIUM, "Poping ", tohexs(rv, 4), "from RAR stack.");
+    DEBUG_INFO(this, VERBOSITY_MEDIUM, "Poping ", tohexs(rv, 4), "from RAR stack.");
 
     return rv;
 }
@@ -339,7 +514,7 @@ uint16_t spect::CpuModel::GetRarSp()
 
 void spect::CpuModel::SetRarSp(uint16_t val)
 {
-    DebugInfo(VERBOSITY_MEDIUM, "Setting RAR SP to:", val);
+    DEBUG_INFO(this, VERBOSITY_MEDIUM, "Setting RAR SP to:", val);
     rar_sp_ = val;
 }
 
@@ -358,8 +533,11 @@ bool spect::CpuModel::GetInterrrupt(CpuIntType int_type)
 
 void spect::CpuModel::SetParityType(ParityType type)
 {
-    DebugInfo(VERBOSITY_MEDIUM, "Setting Parity Type to:", type);
+    DEBUG_INFO(this, VERBOSITY_MEDIUM, "Setting Parity Type to:", type);
     parity_type_ = type;
+
+    // Parity check is done during disassembly -> Cached instructions are not valid anymore.
+    InvalidateInstructionCache();
 }
 
 spect::ParityType spect::CpuModel::GetParityType()
@@ -367,9 +545,14 @@ spect::ParityType spect::CpuModel::GetParityType()
     return parity_type_;
 }
 
+int spect::CpuModel::GetIsaVersion()
+{
+    return isa_version_;
+}
+
 void spect::CpuModel::GrvQueuePush(uint32_t data)
 {
-    DebugInfo(VERBOSITY_HIGH, "Pushing to GRV queue:", tohexs(data, 8));
+    DEBUG_INFO(this, VERBOSITY_HIGH, "Pushing to GRV queue:", tohexs(data, 8));
     grv_q_.push(data);
 }
 
@@ -379,15 +562,15 @@ uint32_t spect::CpuModel::GrvQueuePop()
     if (!grv_q_.empty()) {
         rv = grv_q_.front();
         grv_q_.pop();
-        DebugInfo(VERBOSITY_HIGH, "Popping from GRV queue:", tohexs(rv, 8));
+        DEBUG_INFO(this, VERBOSITY_HIGH, "Popping from GRV queue:", tohexs(rv, 8));
     } else
-        DebugInfo(VERBOSITY_LOW, "Popping from empty GRV queue, GRV returns 0");
+        DEBUG_INFO(this, VERBOSITY_LOW, "Popping from empty GRV queue, GRV returns 0");
     return rv;
 }
 
 void spect::CpuModel::LdkQueuePush(uint32_t data)
 {
-    DebugInfo(VERBOSITY_HIGH, "Pushing to LDK queue:", tohexs(data, 8));
+    DEBUG_INFO(this, VERBOSITY_HIGH, "Pushing to LDK queue:", tohexs(data, 8));
     ldk_q_.push(data);
 }
 
@@ -397,15 +580,15 @@ uint32_t spect::CpuModel::LdkQueuePop()
     if (!ldk_q_.empty()) {
         rv = ldk_q_.front();
         ldk_q_.pop();
-        DebugInfo(VERBOSITY_HIGH, "Popping from LDK queue:", tohexs(rv, 8));
+        DEBUG_INFO(this, VERBOSITY_HIGH, "Popping from LDK queue:", tohexs(rv, 8));
     } else
-        DebugInfo(VERBOSITY_LOW, "Popping from empty LDK queue, LDK returns 0");
+        DEBUG_INFO(this, VERBOSITY_LOW, "Popping from empty LDK queue, LDK returns 0");
     return rv;
 }
 
 void spect::CpuModel::KbusErrorQueuePush(bool error)
 {
-    DebugInfo(VERBOSITY_HIGH, "Pushing to KBUS Error queue:", error);
+    DEBUG_INFO(this, VERBOSITY_HIGH, "Pushing to KBUS Error queue:", error);
     kbus_error_q_.push(error);
 }
 
@@ -415,18 +598,26 @@ bool spect::CpuModel::KbusErrorQueuePop()
     if (!kbus_error_q_.empty()) {
         rv = kbus_error_q_.front();
         kbus_error_q_.pop();
-        DebugInfo(VERBOSITY_HIGH, "Popping from KBUS Error queue:", rv);
+        DEBUG_INFO(this, VERBOSITY_HIGH, "Popping from KBUS Error queue:", rv);
     } else
-        DebugInfo(VERBOSITY_LOW, "Popping from empty KBUS Error queue, returns false");
+        DEBUG_INFO(this, VERBOSITY_LOW, "Popping from empty KBUS Error queue, returns false");
     return rv;
 }
 
+void spect::CpuModel::ClearQueues()
+{
+    DEBUG_INFO(this, VERBOSITY_MEDIUM, "Clearing GRV, LDK and KBUS Error queues");
+    grv_q_ = std::queue<uint32_t>();
+    ldk_q_ = std::queue<uint32_t>();
+    kbus_error_q_ = std::queue<bool>();
+}
+
 void spect::CpuModel::ReportChange(dpi_state_change_t change)
 {
     if (change_reporting_) {
-        DebugInfo(VERBOSITY_HIGH, "Pushing change to model change queue:");
+        DEBUG_INFO(this, VERBOSITY_HIGH, "Pushing change to model change queue:");
         PrintChange(change);
-        change_q_.push(change);
+        change_q_.Push(change);
     }
 }
 
@@ -434,15 +625,12 @@ dpi_state_change_t spect::CpuModel::ConsumeChange()
 {
     dpi_state_change_t rv = {};
 
-    if (!HasChange()) {
-        DebugInfo(VERBOSITY_LOW, "WARNING: Change queue empty, nothing to Pop, returning invalid change!");
+    if (!change_q_.Pop(rv)) {
+        DEBUG_INFO(this, VERBOSITY_LOW, "WARNING: Change queue empty, nothing to Pop, returning invalid change!");
         return rv;
     }
 
-    rv = change_q_.front();
-    change_q_.pop();
-
-    DebugInfo(VERBOSITY_HIGH, "Popping change from model change queue:");
+    DEBUG_INFO(this, VERBOSITY_HIGH, "Popping change from model change queue:");
     PrintChange(rv);
 
     return rv;
@@ -450,28 +638,34 @@ dpi_state_change_t spect::CpuModel::ConsumeChange()
 
 void spect::CpuModel::PrintChange(dpi_state_change_t change)
 {
-    DebugInfo(VERBOSITY_HIGH, "     kind:      ", dpi_change_kind_to_str(change.kind));
-    DebugInfo(VERBOSITY_HIGH, "     obj:       ", dpi_change_obj_to_str(change.kind, change.obj));
+    if (!DEBUG_ENABLED(this, VERBOSITY_HIGH))
+        return;
+
+    DEBUG_INFO(this, VERBOSITY_HIGH, "     kind:      ", dpi_change_kind_to_str(change.kind));
+    DEBUG_INFO(this, VERBOSITY_HIGH, "     obj:       ", dpi_change_obj_to_str(change.kind, change.obj));
 
     char buf[100];
     sprintf(buf, "old_val: %08x %08x %08x %08x %08x %08x %08x %08x",
                 change.old_val[7], change.old_val[6], change.old_val[5], change.old_val[4],
                 change.old_val[3], change.old_val[2], change.old_val[1], change.old_val[0]);
-    DebugInfo(VERBOSITY_HIGH, "    ", buf);
+    DEBUG_INFO(this, VERBOSITY_HIGH, "    ", buf);
 
     sprintf(buf, "new_val: %08x %08x %08x %08x %08x %08x %08x %08x",
                 change.new_val[7], change.new_val[6], change.new_val[5], change.new_val[4],
                 change.new_val[3], change.new_val[2], change.new_val[1], change.new_val[0]);
-    DebugInfo(VERBOSITY_HIGH, "    ", buf);
+    DEBUG_INFO(this, VERBOSITY_HIGH, "    ", buf);
 }
 
 void spect::CpuModel::PrintHashContext(uint32_t verbosity_level)
 {
+    if (!DEBUG_ENABLED(this, verbosity_level))
+        return;
+
     for (int i = 0; i < 8; i++) {
         std::stringstream ss;
         ss << "W[" << i << "] = ";
         ss << tohexs(sha_512_.getContext(i), 16);
-        DebugInfo(verbosity_level, ss.str().c_str());
+        DEBUG_INFO(this, verbosity_level, ss.str().c_str());
     }
 }
 
@@ -484,14 +678,309 @@ void spect::CpuModel::PrintHashContext(uint32_t verbosity_level)
     for (int i = 0; i < 3; i++)     \
         std::getline(ifs, line);
 
-void spect::CpuModel::DumpContext(const std::string &path)
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Binary context file
+//  Header followed by context data. Data is fixed layout of model state in host byte order,
+//  'size' and 'checksum' (FNV-1a) of the header cover the data. Version shall be incremented
+//  on each change of the data layout.
+//
+// Delta context file
+//  Header followed by 'count' records. Each record holds index and new value of 32 bit word
+//  of context data which differs from baseline. 'base_checksum' is checksum of the baseline
+//  (delta is applied only on top of it), 'checksum' is checksum of context data after the
+//  delta is applied.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define CONTEXT_MAGIC       "SPECTCTX"
+#define CONTEXT_DELTA_MAGIC "SPECTDLT"
+#define CONTEXT_VERSION     1
+
+struct ContextHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t size;
+    uint32_t checksum;
+    uint32_t reserved;
+};
+
+struct ContextDeltaHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t size;
+    uint32_t base_checksum;
+    uint32_t checksum;
+    uint32_t count;
+    uint32_t reserved;
+};
+
+struct ContextDeltaRecord {
+    uint32_t index;
+    uint32_t value;
+};
+
+struct spect::CpuModel::ContextData {
+    uint64_t sha_512[8];
+    uint32_t gpr[SPECT_GPR_CNT][8];
+    uint32_t data_ram_in[SPECT_DATA_RAM_IN_SIZE / 4];
+    uint32_t data_ram_out[SPECT_DATA_RAM_OUT_SIZE / 4];
+    uint32_t keccak_rate;
+    uint32_t keccak_byte_io_index;
+    uint32_t keccak_squeezing;
+    uint16_t rar_stack[SPECT_RAR_DEPTH];
+    uint16_t rar_sp;
+    uint8_t  keccak_state[50];
+    uint8_t  flags[3];
+};
+
+#define CONTEXT_DATA_WORDS  (sizeof(ContextData) / 4)
+
+static uint32_t ContextChecksum(const void *data, size_t size)
+{
+    const uint8_t *p = static_cast<const uint8_t*>(data);
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++)
+        hash = (hash ^ p[i]) * 16777619u;
+    return hash;
+}
+
+void spect::CpuModel::GetContextData(ContextData &data)
+{
+    static_assert(sizeof(data.keccak_state) == sizeof(keccak_inst_.state),
+                  "Keccak state size does not match binary context layout");
+    static_assert(sizeof(ContextData) % 4 == 0,
+                  "Binary context layout is not made of whole 32 bit words");
+
+    // Padding is zeroed, so that equal states give equal data
+    memset(&data, 0, sizeof(data));
+
+    for (int i = 0; i < 8; i++)
+        data.sha_512[i] = sha_512_.getContext(i);
+    for (int i = 0; i < SPECT_GPR_CNT; i++)
+        std::copy_n(gpr_[i].crepresentation().begin(), 8, data.gpr[i]);
+    memory_.Read(SPECT_DATA_RAM_IN_BASE >> 2, data.data_ram_in, SPECT_DATA_RAM_IN_SIZE / 4);
+    memory_.Read(SPECT_DATA_RAM_OUT_BASE >> 2, data.data_ram_out, SPECT_DATA_RAM_OUT_SIZE / 4);
+    data.keccak_rate = keccak_inst_.rate;
+    data.keccak_byte_io_index = keccak_inst_.byteIOIndex;
+    data.keccak_squeezing = keccak_inst_.squeezing;
+    std::copy_n(rar_stack_, SPECT_RAR_DEPTH, data.rar_stack);
+    data.rar_sp = rar_sp_;
+    std::copy_n(keccak_inst_.state, sizeof(data.keccak_state), data.keccak_state);
+    data.flags[0] = flags_.zero;
+    data.flags[1] = flags_.carry;
+    data.flags[2] = flags_.error;
+}
+
+void spect::CpuModel::SetContextData(const ContextData &data)
+{
+    for (int i = 0; i < 8; i++)
+        sha_512_.setContext(i, data.sha_512[i]);
+    for (int i = 0; i < SPECT_GPR_CNT; i++)
+        std::copy_n(data.gpr[i], 8, gpr_[i].representation().begin());
+    r31_red_valid_ = false;
+
+    memory_.Write(SPECT_DATA_RAM_IN_BASE >> 2, data.data_ram_in, SPECT_DATA_RAM_IN_SIZE / 4);
+    memory_.Write(SPECT_DATA_RAM_OUT_BASE >> 2, data.data_ram_out, SPECT_DATA_RAM_OUT_SIZE / 4);
+
+    keccak_inst_.rate = data.keccak_rate;
+    keccak_inst_.byteIOIndex = data.keccak_byte_io_index;
+    keccak_inst_.squeezing = data.keccak_squeezing;
+    std::copy_n(data.keccak_state, sizeof(data.keccak_state), keccak_inst_.state);
+    std::copy_n(data.rar_stack, SPECT_RAR_DEPTH, rar_stack_);
+    rar_sp_ = data.rar_sp;
+    flags_.zero = data.flags[0];
+    flags_.carry = data.flags[1];
+    flags_.error = data.flags[2];
+}
+
+void spect::CpuModel::DumpContext(const std::string &path, ContextFormat format)
+{
+    if (format == ContextFormat::TEXT)
+        DumpContextText(path);
+    else
+        DumpContextBinary(path);
+}
+
+void spect::CpuModel::LoadContext(const std::string &path)
+{
+    if (!LoadContextBinary(path))
+        LoadContextText(path);
+}
+
+void spect::CpuModel::DumpContextBinary(const std::string &path)
+{
+    std::ofstream ofs(path, std::ios::binary);
+
+    if (!ofs.is_open())
+        throw std::runtime_error("Unable to open a file: " + path);
+
+    DEBUG_INFO(this, VERBOSITY_LOW, "Dumping model context to: ", path);
+
+    ContextData data;
+    GetContextData(data);
+
+    ContextHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CONTEXT_MAGIC, sizeof(header.magic));
+    header.version = CONTEXT_VERSION;
+    header.size = sizeof(ContextData);
+    header.checksum = ContextChecksum(&data, sizeof(data));
+
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    ofs.write(reinterpret_cast<const char*>(&data), sizeof(data));
+    if (!ofs)
+        throw std::runtime_error("Unable to write a file: " + path);
+
+    DEBUG_INFO(this, VERBOSITY_LOW, "Finished Dumping model context.");
+}
+
+bool spect::CpuModel::LoadContextBinary(const std::string &path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("Unable to open a file: " + path);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(ContextHeader)) {
+        close(fd);
+        return false;
+    }
+
+    void *map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        throw std::runtime_error("Unable to map a file: " + path);
+
+    const ContextHeader *header = static_cast<const ContextHeader*>(map);
+    if (memcmp(header->magic, CONTEXT_MAGIC, sizeof(header->magic)) != 0) {
+        munmap(map, st.st_size);
+        return false;
+    }
+
+    std::string err;
+    const ContextData *data = reinterpret_cast<const ContextData*>(header + 1);
+    if (header->version != CONTEXT_VERSION)
+        err = "Unsupported version of context file: " + std::to_string(header->version);
+    else if (header->size != sizeof(ContextData) ||
+             (size_t)st.st_size != sizeof(ContextHeader) + sizeof(ContextData))
+        err = "Invalid size of context file: " + path;
+    else if (header->checksum != ContextChecksum(data, sizeof(ContextData)))
+        err = "Checksum mismatch in context file: " + path;
+
+    if (!err.empty()) {
+        munmap(map, st.st_size);
+        throw std::runtime_error(err);
+    }
+
+    DEBUG_INFO(this, VERBOSITY_LOW, "Loading model context from: ", path);
+    SetContextData(*data);
+    munmap(map, st.st_size);
+    DEBUG_INFO(this, VERBOSITY_LOW, "Finished Loading model context.");
+
+    return true;
+}
+
+void spect::CpuModel::SetContextBaseline()
+{
+    ContextData data;
+    GetContextData(data);
+    context_base_.resize(CONTEXT_DATA_WORDS);
+    memcpy(context_base_.data(), &data, sizeof(data));
+}
+
+void spect::CpuModel::DumpContextDelta(const std::string &path)
+{
+    if (context_base_.empty())
+        throw std::runtime_error("Context baseline is not set, unable to dump delta: " + path);
+
+    std::ofstream ofs(path, std::ios::binary);
+
+    if (!ofs.is_open())
+        throw std::runtime_error("Unable to open a file: " + path);
+
+    DEBUG_INFO(this, VERBOSITY_LOW, "Dumping model context delta to: ", path);
+
+    ContextData data;
+    GetContextData(data);
+    uint32_t words[CONTEXT_DATA_WORDS];
+    memcpy(words, &data, sizeof(data));
+
+    std::vector<ContextDeltaRecord> records;
+    for (uint32_t i = 0; i < CONTEXT_DATA_WORDS; i++)
+        if (words[i] != context_base_[i])
+            records.push_back({i, words[i]});
+
+    ContextDeltaHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CONTEXT_DELTA_MAGIC, sizeof(header.magic));
+    header.version = CONTEXT_VERSION;
+    header.size = sizeof(ContextData);
+    header.base_checksum = ContextChecksum(context_base_.data(), sizeof(ContextData));
+    header.checksum = ContextChecksum(&data, sizeof(data));
+    header.count = records.size();
+
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    ofs.write(reinterpret_cast<const char*>(records.data()),
+              records.size() * sizeof(ContextDeltaRecord));
+    if (!ofs)
+        throw std::runtime_error("Unable to write a file: " + path);
+
+    DEBUG_INFO(this, VERBOSITY_LOW, "Dumped", std::to_string(records.size()), "changed context words.");
+}
+
+void spect::CpuModel::LoadContextDelta(const std::string &path)
+{
+    std::ifstream ifs(path, std::ios::binary);
+
+    if (!ifs.is_open())
+        throw std::runtime_error("Unable to open a file: " + path);
+
+    ContextDeltaHeader header;
+    if (!ifs.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        memcmp(header.magic, CONTEXT_DELTA_MAGIC, sizeof(header.magic)) != 0)
+        throw std::runtime_error("Not a context delta file: " + path);
+    if (header.version != CONTEXT_VERSION)
+        throw std::runtime_error("Unsupported version of context delta file: " +
+                                 std::to_string(header.version));
+    if (header.size != sizeof(ContextData) || header.count > CONTEXT_DATA_WORDS)
+        throw std::runtime_error("Invalid size of context delta file: " + path);
+
+    std::vector<ContextDeltaRecord> records(header.count);
+    if (!ifs.read(reinterpret_cast<char*>(records.data()),
+                  records.size() * sizeof(ContextDeltaRecord)))
+        throw std::runtime_error("Invalid size of context delta file: " + path);
+
+    DEBUG_INFO(this, VERBOSITY_LOW, "Loading model context delta from: ", path);
+
+    ContextData data;
+    GetContextData(data);
+    if (ContextChecksum(&data, sizeof(data)) != header.base_checksum)
+        throw std::runtime_error("Model context does not match baseline of delta: " + path);
+
+    uint32_t words[CONTEXT_DATA_WORDS];
+    memcpy(words, &data, sizeof(data));
+    for (const auto &record : records) {
+        if (record.index >= CONTEXT_DATA_WORDS)
+            throw std::runtime_error("Invalid record in context delta file: " + path);
+        words[record.index] = record.value;
+    }
+
+    if (ContextChecksum(words, sizeof(words)) != header.checksum)
+        throw std::runtime_error("Checksum mismatch in context delta file: " + path);
+
+    memcpy(&data, words, sizeof(data));
+    SetContextData(data);
+
+    DEBUG_INFO(this, VERBOSITY_LOW, "Applied", std::to_string(records.size()), "changed context words.");
+}
+
+void spect::CpuModel::DumpContextText(const std::string &path)
 {
     uint32_t backup = verbosity_;
     std::ofstream ofs;
     ofs.open(path);
 
     if (ofs.is_open()) {
-        DebugInfo(VERBOSITY_LOW, "Dumping model context to: ", path);
+        DEBUG_INFO(this, VERBOSITY_LOW, "Dumping model context to: ", path);
 
         ofs << std::hex;
         ofs << std::setfill('0');
@@ -536,7 +1025,7 @@ void spect::CpuModel::DumpContext(const std::string &path)
         for (int i = 0; i < (SPECT_DATA_RAM_IN_SIZE / 4) ; i++) {
             if (i == 10) {
                 int num_accesses = (SPECT_DATA_RAM_IN_SIZE / 4) - 10;
-                DebugInfo(VERBOSITY_LOW, "Executed", std::to_string(num_accesses),
+                DEBUG_INFO(this, VERBOSITY_LOW, "Executed", std::to_string(num_accesses),
                         "further acesses to Data RAM In memory that were not printed...");
                 verbosity_ = 0;
             }
@@ -548,7 +1037,7 @@ void spect::CpuModel::DumpContext(const std::string &path)
         for (int i = 0; i < (SPECT_DATA_RAM_OUT_SIZE / 4) ; i++) {
             if (i == 10) {
                 int num_accesses = (SPECT_DATA_RAM_OUT_SIZE / 4) - 10;
-                DebugInfo(VERBOSITY_LOW, "Executed", std::to_string(num_accesses),
+                DEBUG_INFO(this, VERBOSITY_LOW, "Executed", std::to_string(num_accesses),
                         "further acesses to Data RAM Out memory that were not printed...");
                 verbosity_ = 0;
             }
@@ -556,22 +1045,22 @@ void spect::CpuModel::DumpContext(const std::string &path)
         }
         verbosity_ = backup;
 
-        DebugInfo(VERBOSITY_LOW, "Finished Dumping model context.");
-        DebugInfo(VERBOSITY_LOW, "\n");
+        DEBUG_INFO(this, VERBOSITY_LOW, "Finished Dumping model context.");
+        DEBUG_INFO(this, VERBOSITY_LOW, "\n");
 
         ofs.close();
     } else
         throw std::runtime_error("Unable to open a file: " + path);
 }
 
-void spect::CpuModel::LoadContext(const std::string &path)
+void spect::CpuModel::LoadContextText(const std::string &path)
 {
     uint32_t backup = verbosity_;
     std::ifstream ifs(path);
     std::string line;
 
     if (ifs.is_open()) {
-        DebugInfo(VERBOSITY_LOW, "Loading model context from: ", path);
+        DEBUG_INFO(this, VERBOSITY_LOW, "Loading model context from: ", path);
 
         // GPRs
         SKIP_COMMENT_LINES
@@ -588,7 +1077,7 @@ void spect::CpuModel::LoadContext(const std::string &path)
             std::getline(ifs, line);
             std::istringstream iss(line);
             iss >> std::hex >> num;
-            DebugInfo(VERBOSITY_LOW, "Setting SHA512 context (", i, ") to 0x", line.c_str());
+            DEBUG_INFO(this, VERBOSITY_LOW, "Setting SHA512 context (", i, ") to 0x", line.c_str());
             sha_512_.setContext(i, num);
         }
 
@@ -603,7 +1092,7 @@ void spect::CpuModel::LoadContext(const std::string &path)
             std::stringstream idx_high;
             idx_low << std::setw(2) << i*10;
             idx_high << std::setw(2) << (i+1)*10-1;
-            DebugInfo(VERBOSITY_LOW, "Setting TMAC context - state [", idx_low.str().c_str(), ":", idx_high.str().c_str(), "] to", (num.c_str()));
+            DEBUG_INFO(this, VERBOSITY_LOW, "Setting TMAC context - state [", idx_low.str().c_str(), ":", idx_high.str().c_str(), "] to", (num.c_str()));
             for (int j = 0; j < 10; j++) {
                 keccak_inst_.state[i*10+j] = (unsigned char)((uint256_t(num.c_str()) >> (72-j*8)) & uint256_t("0xFF"));
             }
@@ -611,17 +1100,17 @@ void spect::CpuModel::LoadContext(const std::string &path)
         // Rate, byteIOIndex, squeezing
         std::getline(ifs, line);
         std::istringstream rate_iss(line);
-        DebugInfo(VERBOSITY_LOW, "Setting TMAC context - rate to", line);
+        DEBUG_INFO(this, VERBOSITY_LOW, "Setting TMAC context - rate to", line);
         rate_iss >> keccak_inst_.rate;
         // byteIOIndex
         std::getline(ifs, line);
         std::istringstream bioi_iss(line);
-        DebugInfo(VERBOSITY_LOW, "Setting TMAC context - byteIOIndex to", line);
+        DEBUG_INFO(this, VERBOSITY_LOW, "Setting TMAC context - byteIOIndex to", line);
         bioi_iss >> keccak_inst_.byteIOIndex;
         // squeezing
         std::getline(ifs, line);
         std::istringstream squeezing_iss(line);
-        DebugInfo(VERBOSITY_LOW, "Setting TMAC context - squeezing to", line);
+        DEBUG_INFO(this, VERBOSITY_LOW, "Setting TMAC context - squeezing to", line);
         squeezing_iss >> keccak_inst_.squeezing;
 
         // RAR stack
@@ -666,7 +1155,7 @@ void spect::CpuModel::LoadContext(const std::string &path)
         for (int i = 0; i < (SPECT_DATA_RAM_IN_SIZE / 4) ; i++) {
             if (i == 10) {
                 int num_accesses = (SPECT_DATA_RAM_IN_SIZE / 4) - 10;
-                DebugInfo(VERBOSITY_LOW, "Executed", std::to_string(num_accesses),
+                DEBUG_INFO(this, VERBOSITY_LOW, "Executed", std::to_string(num_accesses),
                         "further acesses to Data RAM In memory that were not printed...");
                 verbosity_ = 0;
             }
@@ -683,7 +1172,7 @@ void spect::CpuModel::LoadContext(const std::string &path)
         for (int i = 0; i < (SPECT_DATA_RAM_OUT_SIZE / 4) ; i++) {
             if (i == 10) {
                 int num_accesses = (SPECT_DATA_RAM_OUT_SIZE / 4) - 10;
-                DebugInfo(VERBOSITY_LOW, "Executed", std::to_string(num_accesses),
+                DEBUG_INFO(this, VERBOSITY_LOW, "Executed", std::to_string(num_accesses),
                         "further acesses to Data RAM Out memory that were not printed...");
                 verbosity_ = 0;
             }
@@ -695,17 +1184,143 @@ void spect::CpuModel::LoadContext(const std::string &path)
         }
         verbosity_ = backup;
 
-        DebugInfo(VERBOSITY_LOW, "Finished Loading model context.");
-        DebugInfo(VERBOSITY_LOW, "\n");
+        DEBUG_INFO(this, VERBOSITY_LOW, "Finished Loading model context.");
+        DEBUG_INFO(this, VERBOSITY_LOW, "\n");
 
         ifs.close();
     } else
         throw std::runtime_error("Unable to open a file: " + path);
 }
 
+std::shared_ptr<const spect::CpuSnapshot> spect::CpuModel::Snapshot()
+{
+    DEBUG_INFO(this, VERBOSITY_MEDIUM, "Taking snapshot of model state");
+
+    auto snapshot = std::make_shared<CpuSnapshot>();
+
+    std::copy_n(gpr_, SPECT_GPR_CNT, snapshot->gpr_);
+    snapshot->pc_ = pc_;
+    snapshot->flags_ = flags_;
+    std::copy_n(rar_stack_, SPECT_RAR_DEPTH, snapshot->rar_stack_);
+    snapshot->rar_sp_ = rar_sp_;
+
+    snapshot->memory_ = memory_.Snapshot();
+
+    snapshot->command_start_ = regs_->r_command.f_start.data;
+    snapshot->command_soft_reset_ = regs_->r_command.f_soft_reset.data;
+    snapshot->status_idle_ = regs_->r_status.f_idle.data;
+    snapshot->status_done_ = regs_->r_status.f_done.data;
+    snapshot->status_err_ = regs_->r_status.f_err.data;
+    snapshot->int_done_en_ = regs_->r_int_ena.f_int_done_en.data;
+    snapshot->int_err_en_ = regs_->r_int_ena.f_int_err_en.data;
+    snapshot->int_done_ = int_done_;
+    snapshot->int_err_ = int_err_;
+
+    snapshot->sha_512_ = sha_512_;
+    snapshot->keccak_inst_ = keccak_inst_;
+
+    snapshot->grv_q_ = grv_q_;
+    snapshot->ldk_q_ = ldk_q_;
+    snapshot->kbus_error_q_ = kbus_error_q_;
+
+    snapshot->end_executed_ = end_executed_;
+    snapshot->start_pc_ = start_pc_;
+    snapshot->instr_cnt_ = instr_cnt_;
+    snapshot->last_instr_ = last_instr;
+
+    if (simulator_)
+        snapshot->key_memory_ = simulator_->key_memory_->Snapshot();
+
+    return snapshot;
+}
+
+void spect::CpuModel::Restore(const CpuSnapshot &snapshot)
+{
+    DEBUG_INFO(this, VERBOSITY_MEDIUM, "Restoring model state from snapshot");
+
+    std::copy_n(snapshot.gpr_, SPECT_GPR_CNT, gpr_);
+    r31_red_valid_ = false;
+    pc_ = snapshot.pc_;
+    flags_ = snapshot.flags_;
+    std::copy_n(snapshot.rar_stack_, SPECT_RAR_DEPTH, rar_stack_);
+    rar_sp_ = snapshot.rar_sp_;
+
+    // Instruction memory might differ
+    memory_.Restore(snapshot.memory_);
+    InvalidateInstructionCache();
+
+    regs_->r_command.f_start.data = snapshot.command_start_;
+    regs_->r_command.f_soft_reset.data = snapshot.command_soft_reset_;
+    regs_->r_status.f_idle.data = snapshot.status_idle_;
+    regs_->r_status.f_done.data = snapshot.status_done_;
+    regs_->r_status.f_err.data = snapshot.status_err_;
+    regs_->r_int_ena.f_int_done_en.data = snapshot.int_done_en_;
+    regs_->r_int_ena.f_int_err_en.data = snapshot.int_err_en_;
+    int_done_ = snapshot.int_done_;
+    int_err_ = snapshot.int_err_;
+
+    sha_512_ = snapshot.sha_512_;
+    keccak_inst_ = snapshot.keccak_inst_;
+
+    grv_q_ = snapshot.grv_q_;
+    ldk_q_ = snapshot.ldk_q_;
+    kbus_error_q_ = snapshot.kbus_error_q_;
+
+    end_executed_ = snapshot.end_executed_;
+    start_pc_ = snapshot.start_pc_;
+    instr_cnt_ = snapshot.instr_cnt_;
+    last_instr = snapshot.last_instr_;
+
+    if (simulator_ && snapshot.key_memory_)
+        simulator_->key_memory_->Restore(*snapshot.key_memory_);
+}
+
+spect::CpuModel* spect::CpuModel::Fork()
+{
+    CpuModel *model = new CpuModel(isa_version_, instr_mem_ahb_w_, instr_mem_ahb_r_);
+
+    model->change_reporting_ = change_reporting_;
+    model->instr_sampling_ = instr_sampling_;
+    model->verbosity_ = verbosity_;
+    model->max_instr_cnt_ = max_instr_cnt_;
+    model->timing_accurate_sim_ = timing_accurate_sim_;
+    model->execution_time_step_ = execution_time_step_;
+    model->print_fnc = print_fnc;
+    model->parity_type_ = parity_type_;
+    model->image_ = image_;
+    model->SetExecEngine(GetExecEngine());
+    std::copy_n(breakpoints_, SPECT_INSTR_MEM_SIZE / 4, model->breakpoints_);
+
+    model->Restore(*Snapshot());
+
+    return model;
+}
+
+uint32_t spect::CpuModel::ConsumeChanges(dpi_state_change_t *buf, uint32_t max)
+{
+    uint32_t cnt = 0;
+
+    while (cnt < max && change_q_.Pop(buf[cnt])) {
+        DEBUG_INFO(this, VERBOSITY_HIGH, "Popping change from model change queue:");
+        PrintChange(buf[cnt]);
+        cnt++;
+    }
+
+    return cnt;
+}
+
 bool spect::CpuModel::HasChange()
 {
-    return !change_q_.empty();
+    return !change_q_.Empty();
+}
+
+void spect::CpuModel::ConfigureChangeQueue(size_t capacity, ChangeQueueOverflow overflow)
+{
+    std::stringstream ss;
+    ss << std::dec << capacity << ", overflow: " << overflow;
+    DEBUG_INFO(this, VERBOSITY_LOW, "Configuring change queue, capacity:", ss.str());
+
+    change_q_.Configure(capacity, overflow);
 }
 
 void spect::CpuModel::GetLastInstruction(dpi_instruction_t *dpi_instr)
@@ -716,23 +1331,23 @@ void spect::CpuModel::GetLastInstruction(dpi_instruction_t *dpi_instr)
 
 int spect::CpuModel::Step(int n)
 {
-    if (n > 0) {
-        std::stringstream ss;
-        ss << std::dec << n;
-        DebugInfo(VERBOSITY_HIGH, "Executing", ss.str(), "instructions:");
-    } else
-        DebugInfo(VERBOSITY_HIGH, "Executing all instructions till end of program:");
+    if (DEBUG_ENABLED(this, VERBOSITY_HIGH)) {
+        if (n > 0) {
+            std::stringstream ss;
+            ss << std::dec << n;
+            DEBUG_INFO(this, VERBOSITY_HIGH, "Executing", ss.str(), "instructions:");
+        } else
+            DEBUG_INFO(this, VERBOSITY_HIGH, "Executing all instructions till end of program:");
+    }
 
     int cnt = 0;
     if (n == 0) {
         do {
-            ExecuteNextInstruction(0);
-            cnt++;
+            cnt += ExecuteNextBlock(0);
         } while (!end_executed_);
     } else {
-        for (int i = 0; i < n; i++) {
-            ExecuteNextInstruction(0);
-            cnt++;
+        while (cnt < n) {
+            cnt += ExecuteNextBlock(n - cnt);
             if (end_executed_)
                 break;
         }
@@ -742,16 +1357,58 @@ int spect::CpuModel::Step(int n)
 
 int spect::CpuModel::StepSingle(int cycles)
 {
-    std::stringstream ss;
-    ss << std::dec << cycles;
-    DebugInfo(VERBOSITY_HIGH, "Executing single instruction in ", ss.str(), " RTL clock cycles:");
+    if (DEBUG_ENABLED(this, VERBOSITY_HIGH)) {
+        std::stringstream ss;
+        ss << std::dec << cycles;
+        DEBUG_INFO(this, VERBOSITY_HIGH, "Executing single instruction in ", ss.str(), " RTL clock cycles:");
+    }
 
     return ExecuteNextInstruction(cycles);
 }
 
+int spect::CpuModel::StepBlock()
+{
+    if (IsFastEngineActive()) {
+        DEBUG_INFO(this, VERBOSITY_HIGH, "Executing basic block:");
+        int cnt = fast_engine_->ExecuteBlock(0);
+        if (cnt > 0)
+            return cnt;
+    }
+
+    StepSingle(0);
+    return 1;
+}
+
+void spect::CpuModel::SetBreakpoint(uint16_t address, bool enable)
+{
+    if (!IsWithinMem(CpuMemory::INSTR_MEM, address))
+        return;
+
+    breakpoints_[(address - SPECT_INSTR_MEM_BASE) >> 2] = enable;
+    if (fast_engine_)
+        fast_engine_->InvalidateAt(address);
+}
+
+void spect::CpuModel::SetExecEngine(ExecEngine engine)
+{
+    std::stringstream ss;
+    ss << engine;
+    DEBUG_INFO(this, VERBOSITY_LOW, "Selecting execution engine:", ss.str());
+
+    delete fast_engine_;
+    fast_engine_ = nullptr;
+    if (engine == ExecEngine::FAST)
+        fast_engine_ = new FastEngine(this);
+}
+
+spect::ExecEngine spect::CpuModel::GetExecEngine()
+{
+    return fast_engine_ ? ExecEngine::FAST : ExecEngine::REFERENCE;
+}
+
 void spect::CpuModel::Reset()
 {
-    DebugInfo(VERBOSITY_LOW, "Reseting CPU Model.");
+    DEBUG_INFO(this, VERBOSITY_LOW, "Reseting CPU Model.");
 
     for (int i = 0; i < SPECT_GPR_CNT; i++)
         SetGpr(i, uint256_t("0x0"));
@@ -774,7 +1431,7 @@ void spect::CpuModel::Reset()
     regs_ = new ordt_root();
 
     // To make browsing logs easier
-    DebugInfo(VERBOSITY_LOW, "");
+    DEBUG_INFO(this, VERBOSITY_LOW, "");
 
     // Don't fill the content of memories intentionally!
     // This more realistically corresponds to un-inited memory having
@@ -784,7 +1441,7 @@ void spect::CpuModel::Reset()
 
 void spect::CpuModel::UpdateInterrupts()
 {
-    DebugInfo(VERBOSITY_LOW, "Updating CPU Interrupt values");
+    DEBUG_INFO(this, VERBOSITY_LOW, "Updating CPU Interrupt values");
 
     ordt_data en(1,0);
     ordt_data status(1,0);
@@ -796,11 +1453,11 @@ void spect::CpuModel::UpdateInterrupts()
 
     int_done_ = (regs_->r_int_ena.f_int_done_en.data == 1 &&
                  regs_->r_status.f_done.data == 1);
-    DebugInfo(VERBOSITY_MEDIUM, "Setting int_done     =", int_done_);
+    DEBUG_INFO(this, VERBOSITY_MEDIUM, "Setting int_done     =", int_done_);
 
     int_err_ = (regs_->r_int_ena.f_int_err_en.data == 1 &&
                 regs_->r_status.f_err.data == 1);
-    DebugInfo(VERBOSITY_MEDIUM, "Setting int_err      =", int_err_);
+    DEBUG_INFO(this, VERBOSITY_MEDIUM, "Setting int_err      =", int_err_);
 
     // Construct and report model change
     ch_int_done.new_val[0] = int_done_;
@@ -814,117 +1471,134 @@ void spect::CpuModel::UpdateInterrupts()
 
 void spect::CpuModel::UpdateRegisterEffects()
 {
-    DebugInfo(VERBOSITY_LOW, "Updating Register effects");
+    DEBUG_INFO(this, VERBOSITY_LOW, "Updating Register effects");
 
     // COMMAND[START] == 1
     if (regs_->r_command.f_start.data == 1) {
-        DebugInfo(VERBOSITY_LOW, "Written COMMAND[START] = 1.");
+        DEBUG_INFO(this, VERBOSITY_LOW, "Written COMMAND[START] = 1.");
         Start();
     }
 
     // COMMAND[SOFT_RESET] == 1
     if (regs_->r_command.f_soft_reset.data == 1) {
-        DebugInfo(VERBOSITY_LOW, "Written COMMAND[SOFT_RESET] = 1.");
+        DEBUG_INFO(this, VERBOSITY_LOW, "Written COMMAND[SOFT_RESET] = 1.");
         Reset();
     }
 }
 
-int spect::CpuModel::ExecuteNextInstruction(int cycles)
+bool spect::CpuModel::IsFastEngineActive()
+{
+    return fast_engine_ && !change_reporting_ && !instr_sampling_;
+}
+
+void spect::CpuModel::InstrLimitReached()
+{
+    DEBUG_INFO(this, VERBOSITY_LOW, "Limit of executed instruction (", max_instr_cnt_, ") reached!");
+    Finish(1);
+    UpdateInterrupts();
+}
+
+int spect::CpuModel::ExecuteNextBlock(int n)
 {
-    uint32_t wrd = ReadMemoryCoreFetch(GetPc());
+    // Fast engine executes whole basic blocks when no changes are reported and no instruction
+    // is sampled. Anything else is executed instruction by instruction.
+    if (IsFastEngineActive()) {
+        int cnt = fast_engine_->ExecuteBlock(n);
+        if (cnt > 0)
+            return cnt;
+    }
 
-    DebugInfo(VERBOSITY_MEDIUM, "Disassembling instruction:     ", tohexs(wrd, 8));
-    Instruction *instr = spect::Instruction::DisAssemble(GetParityType(), wrd);
+    ExecuteNextInstruction(0);
+    return 1;
+}
+
+int spect::CpuModel::ExecuteNextInstruction(int cycles)
+{
+    // Fast engine executes instructions from Instruction memory when no changes are reported
+    // and no instruction is sampled. Anything else falls through to reference engine below.
+    int fast_rv;
+    if (IsFastEngineActive() && fast_engine_->ExecuteNextInstruction(cycles, fast_rv))
+        return fast_rv;
+
+    uint16_t pc = GetPc();
+    uint32_t wrd = ReadMemoryCoreFetch(pc);
+
+    // Instructions fetched from Instruction memory are disassembled only once and kept in
+    // pre-decoded instruction cache. Anything else is disassembled on each fetch.
+    bool cacheable = IsWithinMem(CpuMemory::INSTR_MEM, pc);
+    int cache_index = (pc - SPECT_INSTR_MEM_BASE) >> 2;
+
+    if (!cacheable || !IsInstructionDecoded(cache_index))
+        DEBUG_INFO(this, VERBOSITY_MEDIUM, "Disassembling instruction:     ", tohexs(wrd, 8));
+
+    Instruction *instr;
+    if (cacheable)
+        instr = GetDecodedInstruction(cache_index);
+    else
+        instr = spect::Instruction::DisAssemble(isa_version_, GetParityType(), wrd);
 
     // Detect invalid instruction and finish
     if (instr == nullptr) {
-        DebugInfo(VERBOSITY_LOW, "Detected invalid instruction!");
+        DEBUG_INFO(this, VERBOSITY_LOW, "Detected invalid instruction!");
         Finish(1);
         UpdateInterrupts();
 
         return 0;
     }
 
-    DebugInfo(VERBOSITY_LOW, "Executing instruction:         ", instr->Dump());
+    DEBUG_INFO(this, VERBOSITY_LOW, "Executing instruction:         ", instr->Dump());
 
     // Sample input operands and values for DPI readout
-    instr->SampleInputs(&(last_instr), this);
+    if (instr_sampling_)
+        instr->SampleInputs(&(last_instr), this);
 
     // Check last execution time of instruction with the same mnemonic
-    // Hold execution time of instruction per-mnemonic in Instruction Factory.
+    // Hold execution time of instruction per-mnemonic in instruction statistics.
     // Ignore cases where:
     //      1. We stop measurement for whatever reason (cycles == 0).
     //      2. Instruction has 'c_time' = false. Such instruction can last
     //         variable amount of clock cycles.
     int rv = 0;
-    Instruction *gold = spect::InstructionFactory::GetInstruction(instr->mnemonic_);
-    if (cycles > 0 && cycles != gold->cycles_)
-        rv = gold->cycles_;
-    if (!gold->c_time_)
+    InstrStats &stats = instr_stats_[instr->id_];
+    if (cycles > 0 && cycles != stats.cycles)
+        rv = stats.cycles;
+    if (!instr->c_time_)
         rv = 0;
 
     if (timing_accurate_sim_)
         // When in timing accurate mode, insert sleep to mimic execution
         // duration on RTL
-        usleep(gold->cycles_ * execution_time_step_);
+        usleep(stats.cycles * execution_time_step_);
     else
         // Otherwise store observed execution duration for comparison/reports
-        gold->cycles_ = cycles;
+        stats.cycles = cycles;
 
-    gold->exec_cnt_++;
+    stats.exec_cnt++;
 
     // Execute instruction
-    instr->model_ = this;
-    if (instr->Execute())
+    if (instr->Execute(this))
         SetPc(GetPc() + 0x4);
 
     // Sample output operands and values for DPI readout
-    instr->SampleOutputs(&(last_instr), this);
+    if (instr_sampling_)
+        instr->SampleOutputs(&(last_instr), this);
+
+    if (!cacheable)
+        delete instr;
 
     // Check number of executed instructions
     instr_cnt_++;
     if (instr_cnt_ == max_instr_cnt_) {
-        DebugInfo(VERBOSITY_LOW, "Limit of executed instruction (", max_instr_cnt_, ") reached!");
-        Finish(1);
-        UpdateInterrupts();
+        InstrLimitReached();
         return 0;
     }
 
     // Separate instructions by empty line -> More readable output
-    DebugInfo(VERBOSITY_MEDIUM, "");
+    DEBUG_INFO(this, VERBOSITY_MEDIUM, "");
 
-    delete instr;
     return rv;
 }
 
-uint32_t *spect::CpuModel::MemToPtrs(CpuMemory mem, int *size)
-{
-    switch (mem) {
-    case CpuMemory::DATA_RAM_IN:
-        *size = SPECT_DATA_RAM_IN_SIZE >> 2;
-        return &(memory_[SPECT_DATA_RAM_IN_BASE >> 2]);
-        break;
-    case CpuMemory::DATA_RAM_OUT:
-        *size = SPECT_DATA_RAM_OUT_SIZE >> 2;
-        return &(memory_[SPECT_DATA_RAM_OUT_BASE >> 2]);
-        break;
-    case CpuMemory::CONST_ROM:
-        *size = SPECT_CONST_ROM_SIZE >> 2;
-        return &(memory_[SPECT_CONST_ROM_BASE >> 2]);
-        break;
-    case CpuMemory::INSTR_MEM:
-        *size = SPECT_INSTR_MEM_SIZE >> 2;
-        return &(memory_[SPECT_INSTR_MEM_BASE >> 2]);
-        break;
-    case CpuMemory::CONFIG_REGS:
-        *size = SPECT_CONFIG_REGS_SIZE >> 2;
-        return &(memory_[SPECT_CONFIG_REGS_BASE >> 2]);
-        break;
-    default:
-        return NULL;
-    }
-}
-
 bool spect::CpuModel::IsWithinMem(CpuMemory mem, uint16_t address)
 {
     uint16_t start;
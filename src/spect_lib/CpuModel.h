@@ -13,11 +13,16 @@
 #ifndef SPECT_LIB_CPU_MODEL_H_
 #define SPECT_LIB_CPU_MODEL_H_
 
+#include <memory>
 #include <queue>
+#include <vector>
 
 #include "spect.h"
 #include "CpuProgram.h"
 #include "Sha512.h"
+#include "ModularReduction.h"
+#include "ChangeQueue.h"
+#include "CowMemory.h"
 extern "C" {
 #include "KeccakSponge.h"
 }
@@ -29,6 +34,9 @@ extern "C" {
 
 class spect::CpuModel
 {
+    // Fast engine executes directly on model state
+    friend class FastEngine;
+
     public:
 
         ///////////////////////////////////////////////////////////////////////////////////////////
@@ -39,11 +47,12 @@ class spect::CpuModel
 
         ///////////////////////////////////////////////////////////////////////////////////////////
         /// @brief New CPU model constructor
+        /// @param isa_version SPECT ISA version of executed program
         /// @param instr_mem_ahb_w Instruction memory writable via AHB
         /// @param instr_mem_ahb_r Instruction memory readable via AHB
         /// @returns New model object
         ///////////////////////////////////////////////////////////////////////////////////////////
-        CpuModel(bool instr_mem_ahb_w, bool instr_mem_ahb_r);
+        CpuModel(int isa_version, bool instr_mem_ahb_w, bool instr_mem_ahb_r);
 
         ///////////////////////////////////////////////////////////////////////////////////////////
         /// @brief CPU model destructor
@@ -90,6 +99,37 @@ class spect::CpuModel
         ///////////////////////////////////////////////////////////////////////////////////////////
         int  StepSingle(int cycles);
 
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Execute instructions of program till end of basic block
+        /// @returns Number of actually executed instructions
+        /// @note Fast engine executes whole basic block (straight-line instructions up to and
+        ///       including first jump, CALL, RET or END). Block never spans breakpoint set by
+        ///       'SetBreakpoint'. Reference engine executes single instruction, same as
+        ///       'StepSingle' with 'cycles' = 0.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        int  StepBlock();
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Set or clear breakpoint. Execution of basic block stops before breakpoint, so
+        ///        caller can check PC after 'StepBlock'.
+        /// @param address Address of instruction within Instruction memory
+        /// @param enable True - Set breakpoint, False - Clear breakpoint
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void SetBreakpoint(uint16_t address, bool enable);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Select engine which executes instructions
+        /// @param engine Execution engine
+        /// @note Fast engine is used only while change reporting and instruction sampling are
+        ///       disabled. Otherwise (e.g. DPI co-simulation), reference engine is always used.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void SetExecEngine(ExecEngine engine);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @returns Selected execution engine
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        ExecEngine GetExecEngine();
+
         ///////////////////////////////////////////////////////////////////////////////////////////
         /// @brief Reset the model
         ///////////////////////////////////////////////////////////////////////////////////////////
@@ -111,6 +151,24 @@ class spect::CpuModel
         ///////////////////////////////////////////////////////////////////////////////////////////
         void SetStartPc(uint16_t start_pc);
 
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Load program image to the model
+        /// @param image Program image, shared read-only with other models. nullptr - Release
+        ///              program image, memory content is kept.
+        /// @throws std::runtime_error when image is for different ISA version than the model
+        /// @note Instruction memory and Constant ROM pages are shared with the image (page is
+        ///       copied on first write), and Start PC is set to start address of the image.
+        ///       Instructions are executed pre-decoded by the image while Instruction memory word
+        ///       matches the image and model parity type matches the image. Only words modified
+        ///       afterwards are decoded by the model.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void SetProgramImage(std::shared_ptr<const ProgramImage> image);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @returns Program image loaded to the model, nullptr if there is none
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        const std::shared_ptr<const ProgramImage>& GetProgramImage();
+
         ///////////////////////////////////////////////////////////////////////////////////////////
         /// @brief Set data to model memory
         /// @param address Addresss to set
@@ -135,10 +193,50 @@ class spect::CpuModel
         uint32_t GetMemory(uint16_t address);
 
         ///////////////////////////////////////////////////////////////////////////////////////////
-        /// @brief Get pointer to model memory
-        /// @returns Pointer to first address of model memory
+        /// @brief Read block of model memory
+        /// @param address Address of first word
+        /// @param data Buffer for read words
+        /// @param size Size of block in bytes
+        /// @note Same restrictions as in 'GetMemory' apply, Config registers are not read.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void ReadMemoryBlock(uint32_t address, uint32_t *data, uint32_t size);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Write block of model memory (e.g. assembled program)
+        /// @param address Address of first word
+        /// @param data Words to write
+        /// @param size Size of block in bytes
+        /// @note Same restrictions as in 'SetMemory' apply, Config registers are not written.
+        ///       Only modified words are written, pages of memory with unmodified content stay
+        ///       shared (with snapshots or program image).
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void WriteMemoryBlock(uint32_t address, const uint32_t *data, uint32_t size);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Load HEX file to model memory (see 'WriteMemoryBlock')
+        /// @param path Path to HEX file
+        /// @param offset Address where non-addressed HEX file is placed
+        /// @throws std::runtime_error when file can't be loaded
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void LoadHexFile(const std::string &path, uint32_t offset);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Dump block of model memory to HEX file
+        /// @param path Path to HEX file
+        /// @param hex_type Type of HEX file
+        /// @param offset Address of first word
+        /// @param size Size of block in bytes
+        /// @throws std::runtime_error when file can't be written
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void DumpHexFile(const std::string &path, HexFileType hex_type, uint32_t offset,
+                         uint32_t size);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Invalidate whole pre-decoded instruction cache
+        /// @note Writes via 'SetMemory', 'WriteMemoryAhb', 'WriteMemoryBlock' and 'LoadHexFile'
+        ///       invalidate modified words automatically.
         ///////////////////////////////////////////////////////////////////////////////////////////
-        uint32_t* GetMemoryPtr();
+        void InvalidateInstructionCache();
 
         ///////////////////////////////////////////////////////////////////////////////////////////
         /// @brief Read from the model memory space as-if via AHB bus
@@ -253,11 +351,19 @@ class spect::CpuModel
         ///////////////////////////////////////////////////////////////////////////////////////////
         bool KbusErrorQueuePop();
 
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Drop content of GRV, LDK and KBUS Error queues
+        /// @note Allows to re-use model for next program run without data left by previous one.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void ClearQueues();
+
         ///////////////////////////////////////////////////////////////////////////////////////////
         /// @brief Report Change on the CPU model
         /// @param change Change to be reported
         /// @note Change is reported only if change_reporting_ = true. Otherwise this call has no
         //        effect.
+        /// @throw std::runtime_error if the change queue is full and its overflow policy is
+        ///        ChangeQueueOverflow::ERROR (see 'ConfigureChangeQueue').
         ///////////////////////////////////////////////////////////////////////////////////////////
         void ReportChange(dpi_state_change_t change);
 
@@ -267,11 +373,32 @@ class spect::CpuModel
         ///////////////////////////////////////////////////////////////////////////////////////////
         dpi_state_change_t ConsumeChange();
 
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Read (Consume) multiple changes from the model
+        /// @param buf Buffer where changes are stored, oldest change first
+        /// @param max Maximal number of changes to consume
+        /// @returns Number of changes stored to 'buf'
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        uint32_t ConsumeChanges(dpi_state_change_t *buf, uint32_t max);
+
         ///////////////////////////////////////////////////////////////////////////////////////////
         /// @returns True when there are changes to consume, False otherwise
         ///////////////////////////////////////////////////////////////////////////////////////////
         bool HasChange();
 
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Configure queue of reported changes. Changes which were not consumed yet are
+        ///        dropped.
+        /// @param capacity Maximal number of not consumed changes (rounded up to power of two)
+        /// @param overflow What happens when change is reported while the queue is full
+        /// @note By default, the queue starts with SPECT_CHANGE_Q_SIZE changes and grows
+        ///       (ChangeQueueOverflow::GROW).
+        /// @note 'ReportChange' (model execution) and 'ConsumeChange' may be called from two
+        ///       different threads, unless the queue grows. ChangeQueueOverflow::BLOCK shall be
+        ///       used only in such case, otherwise full queue blocks the model forever.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void ConfigureChangeQueue(size_t capacity, ChangeQueueOverflow overflow);
+
         ///////////////////////////////////////////////////////////////////////////////////////////
         /// @brief Gets last executed instruction including sampled operands and filled results
         /// @param dpi_instr Instruction structure in which instruction will be filled
@@ -279,6 +406,8 @@ class spect::CpuModel
         ///       executed instruction for functional coverage measurement. If this function is
         ///       queried without previous invocation of one of these functions, behavior of this
         ///       function is undefined.
+        /// @note Instruction is sampled only when instr_sampling_ = true. Sampling is disabled
+        ///       by default and enabled by DPI model on its creation.
         ///////////////////////////////////////////////////////////////////////////////////////////
         void GetLastInstruction(dpi_instruction_t *dpi_instr);
 
@@ -306,15 +435,70 @@ class spect::CpuModel
         ///////////////////////////////////////////////////////////////////////////////////////////
         /// @brief Dump whole model (GPRs, Memory content, Hash unit context, RAR, Flags)
         /// @param path File where to dump Model context
+        /// @param format Format of context file:
+        ///         BINARY  - Header (magic, format version, size, checksum) followed by
+        ///                   fixed layout of model state in host byte order.
+        ///         TEXT    - One hex value per line, sections separated by comment lines.
         ///////////////////////////////////////////////////////////////////////////////////////////
-        void DumpContext(const std::string &path);
+        void DumpContext(const std::string &path, ContextFormat format = ContextFormat::BINARY);
 
         ///////////////////////////////////////////////////////////////////////////////////////////
-        /// @brief Dump whole model (GPRs, Memory content, Hash unit content, RAR, Flags)
-        /// @param path File where to dump Model context
+        /// @brief Load whole model (GPRs, Memory content, Hash unit content, RAR, Flags)
+        /// @param path File with Model context, format (binary or text) is detected from content
+        /// @throws std::runtime_error when file can't be opened, or binary context has wrong
+        ///         version, size or checksum.
+        /// @note Binary context is mapped to memory and copied directly to model state, without
+        ///       per-word register side effects and debug messages of text context load.
         ///////////////////////////////////////////////////////////////////////////////////////////
         void LoadContext(const std::string &path);
 
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Record current context (as dumped by DumpContext) as baseline for context
+        ///        delta dumps.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void SetContextBaseline();
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Dump only parts of context (GPRs, memory words, RAR, hash contexts, flags)
+        ///        which differ from baseline (see SetContextBaseline).
+        /// @param path File where to dump context delta
+        /// @throws std::runtime_error when baseline is not set, or file can't be written
+        /// @note Baseline is kept. Call SetContextBaseline after the dump to chain deltas.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void DumpContextDelta(const std::string &path);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Apply context delta on top of current context
+        /// @param path File with context delta dumped by DumpContextDelta
+        /// @throws std::runtime_error when current context is not the baseline of the delta, or
+        ///         delta file is invalid.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void LoadContextDelta(const std::string &path);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Take snapshot of model state (see CpuSnapshot)
+        /// @returns Snapshot, memory pages not modified since previous snapshot are shared
+        /// @note Key Memory is included when model is attached to simulator.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        std::shared_ptr<const CpuSnapshot> Snapshot();
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Restore model state from snapshot
+        /// @param snapshot Snapshot taken by this or other model with the same ISA version
+        /// @note Only memory pages which differ from snapshot are copied.
+        /// @note Key Memory is restored when snapshot has it and model is attached to simulator.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void Restore(const CpuSnapshot &snapshot);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Create independent copy of the model
+        /// @returns New model with the same configuration and state. Memory pages are shared
+        ///          copy-on-write with snapshot of this model.
+        /// @note New model is not attached to simulator (has no Key Memory), use
+        ///       CpuSimulator::Fork to fork also Key Memory.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        CpuModel* Fork();
+
         ///////////////////////////////////////////////////////////////////////////////////////////
         ///////////////////////////////////////////////////////////////////////////////////////////
         /// @section Simple accessors
@@ -325,6 +509,9 @@ class spect::CpuModel
         const uint256_t& GetGpr(int index);
         void SetGpr(int index, const uint256_t &val);
 
+        // Reduction context for modulus in R31, (re)computed on first use after R31 write
+        const ModularReduction& GetR31Reduction();
+
         // Program counter (PC) accessors
         uint16_t GetPc();
         void SetPc(uint16_t val);
@@ -352,6 +539,9 @@ class spect::CpuModel
         void SetParityType(ParityType type);
         ParityType GetParityType();
 
+        // SPECT ISA version of executed program
+        int GetIsaVersion();
+
         ///////////////////////////////////////////////////////////////////////////////////////////
         ///////////////////////////////////////////////////////////////////////////////////////////
         /// @section Public attributes
@@ -361,6 +551,10 @@ class spect::CpuModel
         // Enable for reporting of processor state changes
         bool change_reporting_ = false;
 
+        // Enable for sampling of last executed instruction (last_instr) for DPI readout.
+        // Disabled by default since only DPI model reads the instruction.
+        bool instr_sampling_ = false;
+
         // Verbosity level of the model
         uint32_t verbosity_ = 0;
 
@@ -402,6 +596,10 @@ class spect::CpuModel
         // General Purpose registers (R0-R31)
         uint256_t gpr_[SPECT_GPR_CNT];
 
+        // Reduction context of R31 modulus, valid only when r31_red_valid_ is true
+        ModularReduction r31_red_;
+        bool r31_red_valid_ = false;
+
         // program Counter (PC)
         uint16_t pc_;
 
@@ -414,8 +612,9 @@ class spect::CpuModel
         // RAR stack pointer
         uint16_t rar_sp_;
 
-        // Memory space (flat 16 bit space (64 KB))
-        uint32_t* memory_;
+        // Memory space (flat 16 bit space (64 KB)), pages are shared with snapshots and
+        // program image until written
+        CowMemory memory_;
 
         // Register model
         ordt_root *regs_;
@@ -434,7 +633,10 @@ class spect::CpuModel
         std::queue<bool> kbus_error_q_;
 
         // Queue for processor state changes
-        std::queue<dpi_state_change_t> change_q_;
+        ChangeQueue change_q_{SPECT_CHANGE_Q_SIZE, ChangeQueueOverflow::GROW};
+
+        // SPECT ISA version of executed program
+        const int isa_version_;
 
         // Instruction memory writable via AHB
         const bool instr_mem_ahb_w_;
@@ -457,11 +659,73 @@ class spect::CpuModel
         // Last executed instruction
         dpi_instruction_t last_instr = {};
 
-        uint32_t *MemToPtrs(CpuMemory mem, int *size);
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        // Pre-decoded instruction cache. Single entry for each word of Instruction memory,
+        // allocated per page of Instruction memory which is not shared with program image.
+        // Entry holds instruction disassembled from the word, ready to be executed.
+        //  nullptr - Word was not disassembled yet, or it was modified since.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        std::unique_ptr<Instruction*[]> instr_cache_[SPECT_INSTR_MEM_SIZE / 4 / SPECT_SNAPSHOT_PAGE_SIZE];
+
+        // Program image, instructions of pages shared with the image and entries of instruction
+        // cache equal to image instructions are owned by the image.
+        std::shared_ptr<const ProgramImage> image_;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        // Per-instruction execution statistics, indexed by Instruction::id_.
+        //  exec_cnt - Number of times instruction was executed since Start.
+        //  cycles   - Instruction duration. In timing accurate mode, used to insert delay.
+        //             Otherwise holds last observed execution duration on RTL.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        struct InstrStats {
+            uint64_t exec_cnt;
+            int cycles;
+        };
+        InstrStats *instr_stats_;
+
+        // Fast execution engine, nullptr when reference engine is selected
+        FastEngine *fast_engine_ = nullptr;
+
+        // Breakpoints, single entry for each word of Instruction memory
+        bool breakpoints_[SPECT_INSTR_MEM_SIZE / 4] = {};
+
+        // Baseline of context delta dumps (words of ContextData), empty if not set
+        std::vector<uint32_t> context_base_;
+
+        void InvalidateInstructionCacheAt(uint16_t address);
+
+        // Get pre-decoded instruction from word of Instruction memory, decode it on cache miss.
+        // Returns nullptr when word is not valid instruction.
+        Instruction* GetDecodedInstruction(int index);
+
+        // Page of Instruction memory with word is shared with program image
+        bool IsImagePage(int index);
+
+        // Word of Instruction memory is pre-decoded (by the model or by program image)
+        bool IsInstructionDecoded(int index);
+
+        // Context data in fixed binary layout (see CpuModel.cpp)
+        struct ContextData;
+        void GetContextData(ContextData &data);
+        void SetContextData(const ContextData &data);
+
+        void DumpContextText(const std::string &path);
+        void DumpContextBinary(const std::string &path);
+        void LoadContextText(const std::string &path);
+
+        // Returns false when file is not binary context
+        bool LoadContextBinary(const std::string &path);
         bool IsWithinMem(CpuMemory mem, uint16_t address);
 
         int ExecuteNextInstruction(int cycles);
 
+        int ExecuteNextBlock(int n);
+
+        bool IsFastEngineActive();
+
+        // Finish program when limit of executed instructions is reached
+        void InstrLimitReached();
+
         void PrintChange(dpi_state_change_t change);
 
         void PrintArgs();
@@ -34,7 +34,8 @@ void spect::CpuProgram::Assemble(uint32_t *mem, spect::ParityType parity_type)
 {
     for (auto const &instr : code_) {
 
-        // If relocation entry is unresolved, then it is returned
+        // Link step: Symbols of all compiled files are known now. If relocation entry is
+        // unresolved, then it is returned
         Symbol *s_unknown = instr->Relocate();
         if (s_unknown != nullptr) {
             char buf[128];
@@ -36,9 +36,11 @@ class spect::CpuProgram
         void AppendInstruction(spect::Instruction *instr);
 
         ///////////////////////////////////////////////////////////////////////////////////////////
-        /// @brief Assemble the program
+        /// @brief Link and assemble the program. Symbols referenced by instructions (from all
+        ///        compiled files) are resolved before instructions are encoded.
         /// @param mem Pointer to memory where the program shall be assembled
         /// @param parity_type Type of parity to generate
+        /// @throw std::runtime_error when referenced symbol is not defined
         ///////////////////////////////////////////////////////////////////////////////////////////
         void Assemble(uint32_t *mem, spect::ParityType parity_type);
 
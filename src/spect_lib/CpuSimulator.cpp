@@ -14,15 +14,15 @@
 #include "CpuModel.h"
 #include "Compiler.h"
 #include "CpuSimulator.h"
-#include "HexHandler.h"
 #include "KeyMemory.h"
+#include "ProgramImage.h"
 
-spect::CpuSimulator::CpuSimulator()
+spect::CpuSimulator::CpuSimulator(int isa_version)
 {
-    model_ = new spect::CpuModel(SPECT_INSTR_MEM_AHB_W, SPECT_INSTR_MEM_AHB_R);
+    model_ = new spect::CpuModel(isa_version, SPECT_INSTR_MEM_AHB_W, SPECT_INSTR_MEM_AHB_R);
     model_->verbosity_ = VERBOSITY_HIGH;
     model_->simulator_ = this;
-    compiler_ = new spect::Compiler();
+    compiler_ = new spect::Compiler(isa_version);
     key_memory_ = new spect::KeyMemory();
     key_memory_->verbosity_ = VERBOSITY_HIGH;
 
@@ -45,6 +45,45 @@ spect::CpuSimulator::~CpuSimulator()
     delete cli_;
 }
 
+spect::CpuSimulator* spect::CpuSimulator::Fork()
+{
+    CpuSimulator *sim = new spect::CpuSimulator(model_->GetIsaVersion());
+
+    delete sim->model_;
+    sim->model_ = model_->Fork();
+    sim->model_->simulator_ = sim;
+
+    sim->key_memory_->verbosity_ = key_memory_->verbosity_;
+    sim->key_memory_->Restore(*key_memory_->Snapshot());
+
+    sim->model_context_ = model_context_;
+    sim->model_context_delta_ = model_context_delta_;
+    sim->cmd_file_ = cmd_file_;
+    sim->breakpoints_ = breakpoints_;
+    sim->program_running_ = program_running_;
+
+    return sim;
+}
+
+void spect::CpuSimulator::LoadModelContext()
+{
+    if (model_context_ != "")
+        model_->LoadContext(model_context_);
+    if (model_context_delta_ != "")
+        model_->LoadContextDelta(model_context_delta_);
+
+    // Context delta dumped after the run holds changes done by the program
+    model_->SetContextBaseline();
+}
+
+spect::SymbolTable* spect::CpuSimulator::GetSymbols()
+{
+    const auto &image = model_->GetProgramImage();
+    if (image && image->GetSymbols())
+        return image->GetSymbols();
+    return compiler_->symbols_;
+}
+
 bool spect::CpuSimulator::CheckFinished()
 {
     if (model_->IsFinished()) {
@@ -74,12 +113,13 @@ bool spect::CpuSimulator::AddBreakpoint(uint16_t address)
     std::cout << "Adding breakpoint at:\n";
     std::cout << "    address: 0x" << std::hex << address << std::endl;
     breakpoints_.push_back(address);
+    model_->SetBreakpoint(address, true);
     return true;
 }
 
 bool spect::CpuSimulator::AddBreakpoint(std::string label)
 {
-    Symbol *s = compiler_->symbols_->GetSymbol(label);
+    Symbol *s = GetSymbols()->GetSymbol(label);
     if (s == nullptr) {
         std::cout << "Label '" << label << "' does not exist. Can't add breakpoint!\n";
         return false;
@@ -99,6 +139,7 @@ bool spect::CpuSimulator::AddBreakpoint(std::string label)
     std::cout << "Adding breakpoint at:\n";
     std::cout << "    " << label << ", address: 0x" << address << "\n";
     breakpoints_.push_back(address);
+    model_->SetBreakpoint(address, true);
 
     return true;
 }
@@ -110,6 +151,7 @@ bool spect::CpuSimulator::RemoveBreakPoint(uint32_t address)
             std::cout << "Removing breakpoint at:\n";
             std::cout << "    0x" << address << "\n";
             breakpoints_.erase(it);
+            model_->SetBreakpoint(address, false);
             return true;
         }
     std::cout << "No breakpoint exists at:\n";
@@ -119,7 +161,7 @@ bool spect::CpuSimulator::RemoveBreakPoint(uint32_t address)
 
 bool spect::CpuSimulator::RemoveBreakPoint(std::string label)
 {
-    Symbol *s = compiler_->symbols_->GetSymbol(label);
+    Symbol *s = GetSymbols()->GetSymbol(label);
     if (s == nullptr) {
         std::cout << "Label '" << label << "' does not exist. Can't remove breakpoint!\n";
         return false;
@@ -130,6 +172,7 @@ bool spect::CpuSimulator::RemoveBreakPoint(std::string label)
             std::cout << "Removing breakpoint at:\n";
             std::cout << "    " << label << ", address: 0x" << s->val_ << "\n";
             breakpoints_.erase(it);
+            model_->SetBreakpoint(s->val_, false);
             return true;
         }
     std::cout << "No breakpoint exists at:\n";
@@ -149,7 +192,7 @@ bool spect::CpuSimulator::IsBreakpointAt(uint32_t address)
 void spect::CpuSimulator::PrintBreakpoint(uint32_t breakpoint)
 {
     std::cout << "  " << std::hex << "0x" << breakpoint;
-    Symbol *s = compiler_->symbols_->GetSymbol(breakpoint, SymbolType::LABEL);
+    Symbol *s = GetSymbols()->GetSymbol(breakpoint, SymbolType::LABEL);
     if (s)
         std::cout << "  " << s->identifier_;
     std::cout << "\n";
@@ -185,8 +228,18 @@ void spect::CpuSimulator::PrintFlags()
 
 void spect::CpuSimulator::PrintPc()
 {
+    uint32_t pc = model_->GetPc();
     std::cout << "Program counter:\n";
-    std::cout << std::hex << "  0x" << model_->GetPc() << "\n";
+    std::cout << std::hex << "  0x" << pc;
+
+    // Label of code which contains PC
+    Symbol *s = GetSymbols()->GetNearestSymbol(pc, SymbolType::LABEL);
+    if (s) {
+        std::cout << "  " << s->identifier_;
+        if (pc != s->val_)
+            std::cout << "+0x" << (pc - s->val_);
+    }
+    std::cout << "\n";
 }
 
 void spect::CpuSimulator::PrintRar()
@@ -205,7 +258,7 @@ void spect::CpuSimulator::PrintRar()
 void spect::CpuSimulator::PrintSymbols()
 {
     std::cout << "Symbol Table:\n";
-    compiler_->symbols_->Print(std::cout);
+    GetSymbols()->Print(std::cout);
 }
 
 
@@ -271,13 +324,12 @@ void spect::CpuSimulator::CmdRun(A_UNUSED std::ostream &out)
 
     if (!program_running_) {
         model_->Reset();
-        if (model_context_ != "")
-            model_->LoadContext(model_context_);
+        LoadModelContext();
         model_->Start();
         program_running_ = true;
     }
     do {
-        model_->StepSingle(0);
+        model_->StepBlock();
         auto pc = model_->GetPc();
         if (IsBreakpointAt(pc)) {
             std::cout << "Hit Breakpoint:\n";
@@ -322,7 +374,7 @@ void spect::CpuSimulator::CmdJump(A_UNUSED std::ostream &out, std::string arg1)
         ss >> bp_address;
         model_->SetPc(bp_address);
     } else {
-        Symbol *s = compiler_->symbols_->GetSymbol(arg1);
+        Symbol *s = GetSymbols()->GetSymbol(arg1);
         if (s)
             model_->SetPc(s->val_);
         else
@@ -332,9 +384,8 @@ void spect::CpuSimulator::CmdJump(A_UNUSED std::ostream &out, std::string arg1)
 
 void spect::CpuSimulator::CmdGet(A_UNUSED std::ostream &out, std::string arg1)
 {
-    if (std::regex_match(arg1, std::regex("^" OP_REGEX))) {
-        std::string i_str = arg1.substr(1, arg1.size() - 1);
-        out << tohexs(model_->GetGpr(stoint(i_str))) << "\n";
+    if (stogpr(arg1) >= 0) {
+        out << tohexs(model_->GetGpr(stogpr(arg1))) << "\n";
 
     } else if (std::regex_match(arg1, std::regex("^mem\\[" NUM_REGEX "\\](\\+" NUM_REGEX ")?"))) {
         // Check if multiple addresses should be shown
@@ -390,9 +441,8 @@ void spect::CpuSimulator::CmdSet(A_UNUSED std::ostream &out, std::string arg1, s
 {
     std::stringstream ss;
 
-    if (std::regex_match(arg1, std::regex("^" OP_REGEX))) {
-        std::string i_str = arg1.substr(1, arg1.size() - 1);
-        model_->SetGpr(stoint(i_str), uint256_t(arg2.c_str()));
+    if (stogpr(arg1) >= 0) {
+        model_->SetGpr(stogpr(arg1), uint256_t(arg2.c_str()));
 
     } else if (std::regex_match(arg1, std::regex("^mem\\[" NUM_REGEX "\\]"))) {
         int from = arg1.find("[");
@@ -417,15 +467,13 @@ void spect::CpuSimulator::CmdSet(A_UNUSED std::ostream &out, std::string arg1, s
 
 void spect::CpuSimulator::CmdLoad(A_UNUSED std::ostream &out, std::string arg1, uint32_t offset)
 {
-    uint32_t *mem = model_->GetMemoryPtr();
     std::cout << "Loading " << arg1 << " to SPECT memory!\n";
-    HexHandler::LoadHexFile(arg1, mem, offset);
+    model_->LoadHexFile(arg1, offset);
 }
 
 void spect::CpuSimulator::CmdDump(A_UNUSED std::ostream &out, std::string arg1, uint32_t address,
                                   uint32_t size)
 {
-    uint32_t *mem = model_->GetMemoryPtr();
     std::cout << "Dumping memory:\n";
     std::cout << std::hex;
     std::cout << "   From address:    0x" << address << "\n";
@@ -433,7 +481,19 @@ void spect::CpuSimulator::CmdDump(A_UNUSED std::ostream &out, std::string arg1,
     std::cout << "   Number of bytes:   " << std::dec << size << "\n";
     std::cout << "   Number of words:   " << std::dec << (size >> 2) << "\n";
 
-    HexHandler::DumpHexFile(arg1, HexFileType::ISS_WORD, mem, address, size);
+    model_->DumpHexFile(arg1, HexFileType::ISS_WORD, address, size);
+}
+
+void spect::CpuSimulator::CmdBaseline(A_UNUSED std::ostream &out)
+{
+    std::cout << "Setting context baseline for context delta dumps\n";
+    model_->SetContextBaseline();
+}
+
+void spect::CpuSimulator::CmdDelta(A_UNUSED std::ostream &out, std::string arg1)
+{
+    std::cout << "Dumping context delta to: " << arg1 << "\n";
+    model_->DumpContextDelta(arg1);
 }
 
 void spect::CpuSimulator::CmdStep(A_UNUSED std::ostream &out, int n)
@@ -448,8 +508,7 @@ void spect::CpuSimulator::CmdStep(A_UNUSED std::ostream &out, int n)
 void spect::CpuSimulator::CmdStart(A_UNUSED std::ostream &out)
 {
     model_->Reset();
-    if (model_context_ != "")
-        model_->LoadContext(model_context_);
+    LoadModelContext();
     model_->Start();
     program_running_ = true;
 }
@@ -530,6 +589,17 @@ void spect::CpuSimulator::BuildCliCommands(std::unique_ptr<cli::Menu> &menu)
                 "Dump SPECT memory to a file:\n"
                 "           dump <hex-file> <start_addr> <size>      - Dump memory to HEX file.");
 
+    menu->Insert("baseline", [&](std::ostream &out){
+                    CmdBaseline(out);
+                 },
+                "Record current context as baseline for context delta dumps.");
+
+    menu->Insert("delta", [&](std::ostream &out, std::string arg1){
+                    CmdDelta(out, arg1);
+                 },
+                "Dump changes of context since baseline to a file:\n"
+                "           delta <file>                  - Dump context delta.");
+
     menu->Insert("run", [&](std::ostream &out){
                     CmdRun(out);
                  },
@@ -561,8 +631,7 @@ void spect::CpuSimulator::Start(bool batch_mode)
 {
     if (batch_mode) {
         model_->Reset();
-        if (model_context_ != "")
-            model_->LoadContext(model_context_);
+        LoadModelContext();
         model_->Start();
         model_->Step(0);
     } else {
@@ -24,15 +24,25 @@ class spect::CpuSimulator
 
         ///////////////////////////////////////////////////////////////////////////////////////////
         /// @brief New CPU simulator constructor
+        /// @param isa_version SPECT ISA version of simulated program
         /// @returns New model object
         ///////////////////////////////////////////////////////////////////////////////////////////
-        CpuSimulator();
+        CpuSimulator(int isa_version);
 
         ///////////////////////////////////////////////////////////////////////////////////////////
         /// @brief CPU Simulator destructor
         ///////////////////////////////////////////////////////////////////////////////////////////
         ~CpuSimulator();
 
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Fork the simulator
+        /// @returns New simulator with copy of model state, Key Memory and breakpoints. Memory
+        ///          of both simulators is shared copy-on-write, see CpuModel::Fork.
+        /// @note Symbol table is inherited only via program image of the model. Symbols of
+        ///       program compiled by 'compiler_' are not copied.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        CpuSimulator* Fork();
+
         ///////////////////////////////////////////////////////////////////////////////////////////
         /// @brief Add breakpoint
         /// @param address Address in program where to add breakpoint
@@ -142,6 +152,9 @@ class spect::CpuSimulator
         // Path to CPU model context file to be preloaded before model execution
         std::string model_context_;
 
+        // Path to CPU model context delta file to be applied on top of model context
+        std::string model_context_delta_;
+
         // Path to command file for simulator
         std::string cmd_file_;
 
@@ -160,6 +173,8 @@ class spect::CpuSimulator
         void CmdGet(std::ostream &out, std::string arg1);
         void CmdLoad(std::ostream &out, std::string arg1, uint32_t offset);
         void CmdDump(A_UNUSED std::ostream &out, std::string arg1, uint32_t address, uint32_t size);
+        void CmdBaseline(A_UNUSED std::ostream &out);
+        void CmdDelta(A_UNUSED std::ostream &out, std::string arg1);
 
     private:
 
@@ -169,6 +184,12 @@ class spect::CpuSimulator
         // Indication model execution is in progress
         bool program_running_ = false;
 
+        // Symbol table of simulated program, taken from program image when model has one
+        SymbolTable* GetSymbols();
+
+        // Load model context (and context delta) before execution, set context baseline
+        void LoadModelContext();
+
         // Create commands fo interactive CLI
         void BuildCliCommands(std::unique_ptr<cli::Menu> &menu);
 
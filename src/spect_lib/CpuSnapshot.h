@@ -0,0 +1,87 @@
+/**************************************************************************************************
+*
+* SPECT Compiler
+* Copyright (C) 2022-present Tropic Square
+*
+* @todo: License
+*
+**************************************************************************************************/
+
+#ifndef SPECT_LIB_CPU_SNAPSHOT_H_
+#define SPECT_LIB_CPU_SNAPSHOT_H_
+
+#include <memory>
+#include <queue>
+
+#include "spect.h"
+#include "CowMemory.h"
+#include "CpuModel.h"
+#include "KeyMemory.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Snapshot of CPU model state
+//  Taken by CpuModel::Snapshot, applied by CpuModel::Restore (to the same or to other model).
+//  Snapshot is immutable, single snapshot can be restored by multiple models (also from
+//  multiple threads at once). Memory is held as copy-on-write pages (see CowMemory). Pages
+//  which were not modified since previous snapshot are shared with it.
+//
+//  Snapshot holds architectural state: GPRs, PC, flags, RAR stack, memory, config registers,
+//  SHA-512 and Keccak context, GRV/LDK/KBUS queues and Key Memory of attached simulator.
+//  Model configuration (verbosity, execution engine, instruction limit, breakpoints, ...) and
+//  pending state change reports are not part of the snapshot.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+class spect::CpuSnapshot
+{
+    public:
+        // General Purpose registers (R0-R31)
+        uint256_t gpr_[SPECT_GPR_CNT];
+
+        // Program counter
+        uint16_t pc_;
+
+        // Flags (Z, C, E)
+        CpuFlags flags_;
+
+        // Return Address register (RAR) stack and stack pointer
+        uint16_t rar_stack_[SPECT_RAR_DEPTH];
+        uint16_t rar_sp_;
+
+        // Memory space (flat 16 bit space (64 KB))
+        CowMemory::Pages memory_;
+
+        // Fields of config registers
+        uint8_t command_start_;
+        uint8_t command_soft_reset_;
+        uint8_t status_idle_;
+        uint8_t status_done_;
+        uint8_t status_err_;
+        uint8_t int_done_en_;
+        uint8_t int_err_en_;
+
+        // Interrupt outputs
+        bool int_done_;
+        bool int_err_;
+
+        // SHA512 and Keccak context
+        Sha512 sha_512_;
+        KeccakWidth400_SpongeInstance keccak_inst_;
+
+        // GRV, LDK and KBUS error queues
+        std::queue<uint32_t> grv_q_;
+        std::queue<uint32_t> ldk_q_;
+        std::queue<bool> kbus_error_q_;
+
+        // Program execution state
+        bool end_executed_;
+        uint16_t start_pc_;
+        uint64_t instr_cnt_;
+
+        // Last executed instruction
+        dpi_instruction_t last_instr_;
+
+        // Key Memory of simulator attached to the model, nullptr if model has no simulator
+        std::shared_ptr<const KeyMemory::State> key_memory_;
+};
+
+#endif
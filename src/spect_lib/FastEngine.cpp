@@ -0,0 +1,641 @@
+/**************************************************************************************************
+*
+* SPECT Compiler
+* Copyright (C) 2022-present Tropic Square
+*
+* @todo: License
+*
+**************************************************************************************************/
+
+#include <unistd.h>
+
+#include "FastEngine.h"
+#include "InstructionDefs.h"
+#include "InstructionFactory.h"
+#include "ModularReduction.h"
+#include "ProgramImage.h"
+
+spect::FastEngine::FastEngine(CpuModel *model) :
+    model_(model)
+{}
+
+void spect::FastEngine::Invalidate()
+{
+    // Pages are selected again on first use
+    for (int i = 0; i < PAGE_CNT; i++)
+        pages_[i] = nullptr;
+}
+
+void spect::FastEngine::InvalidateAt(uint16_t address)
+{
+    // Blocks never cross end of page, only blocks of the same page may contain the word
+    pages_[((address - SPECT_INSTR_MEM_BASE) >> 2) / SPECT_SNAPSHOT_PAGE_SIZE] = nullptr;
+}
+
+void spect::FastEngine::SelectPage(int page)
+{
+    int first = page * SPECT_SNAPSHOT_PAGE_SIZE;
+
+    // Blocks of the image do not end at breakpoints
+    bool shared = model_->IsImagePage(first);
+    for (int i = first; shared && i < first + SPECT_SNAPSHOT_PAGE_SIZE; i++)
+        shared = !model_->breakpoints_[i];
+
+    if (shared) {
+        pages_[page] = model_->image_->GetDecodedPage(page);
+        return;
+    }
+
+    if (private_[page])
+        *private_[page] = {};
+    else
+        private_[page].reset(new DecodedPage());
+    pages_[page] = private_[page].get();
+}
+
+inline const spect::FastEngine::DecodedPage* spect::FastEngine::GetPage(int index)
+{
+    int page = index / SPECT_SNAPSHOT_PAGE_SIZE;
+    if (pages_[page] == nullptr)
+        SelectPage(page);
+    return pages_[page];
+}
+
+inline bool spect::FastEngine::IsPrivate(const DecodedPage *page, int index)
+{
+    return page == private_[index / SPECT_SNAPSHOT_PAGE_SIZE].get();
+}
+
+inline void spect::FastEngine::SetGpr(CpuModel *model, int index, const uint256_t &val)
+{
+    model->gpr_[index] = val;
+    if (index == TO_INT(CpuGpr::R31))
+        model->r31_red_valid_ = false;
+}
+
+void spect::FastEngine::Decode(Instruction *instr, FastOp &op)
+{
+    op = {};
+
+    switch (instr->itype_) {
+    case InstructionType::R: {
+        InstructionR *instr_r = static_cast<InstructionR*>(instr);
+        op.op1 = TO_INT(instr_r->op1_);
+        op.op2 = TO_INT(instr_r->op2_);
+        op.op3 = TO_INT(instr_r->op3_);
+        break;
+    }
+    case InstructionType::I: {
+        InstructionI *instr_i = static_cast<InstructionI*>(instr);
+        op.op1 = TO_INT(instr_i->op1_);
+        op.op2 = TO_INT(instr_i->op2_);
+        op.imm = instr_i->immediate_;
+        break;
+    }
+    case InstructionType::M: {
+        InstructionM *instr_m = static_cast<InstructionM*>(instr);
+        op.op1 = TO_INT(instr_m->op1_);
+        op.imm = instr_m->addr_;
+        break;
+    }
+    case InstructionType::J:
+        op.imm = static_cast<InstructionJ*>(instr)->new_pc_;
+        break;
+    default:
+        break;
+    }
+
+    op.instr = instr;
+    op.id = instr->id_;
+    op.c_time = instr->c_time_;
+    op.handler = GetHandlers()[instr->id_];
+}
+
+bool spect::FastEngine::Decode(int index)
+{
+    // Share pre-decoded instruction with reference engine
+    Instruction *instr = model_->GetDecodedInstruction(index);
+    if (instr == nullptr)
+        return false;
+
+    Decode(instr, private_[index / SPECT_SNAPSHOT_PAGE_SIZE]->ops[index % SPECT_SNAPSHOT_PAGE_SIZE]);
+    return true;
+}
+
+void spect::FastEngine::BuildPage(DecodedPage &page, Instruction *const *instrs)
+{
+    page = {};
+
+    for (int i = 0; i < SPECT_SNAPSHOT_PAGE_SIZE; i++)
+        if (instrs[i] != nullptr)
+            Decode(instrs[i], page.ops[i]);
+
+    // Block continues by block starting at next word, unless it ends by J-type instruction
+    for (int i = SPECT_SNAPSHOT_PAGE_SIZE - 1; i >= 0; i--) {
+        if (instrs[i] == nullptr)
+            continue;
+        page.blocks[i] = 1;
+        if (i + 1 < SPECT_SNAPSHOT_PAGE_SIZE && instrs[i]->itype_ != InstructionType::J)
+            page.blocks[i] += page.blocks[i + 1];
+    }
+}
+
+uint16_t spect::FastEngine::BuildBlock(int index)
+{
+    DecodedPage &page = *private_[index / SPECT_SNAPSHOT_PAGE_SIZE];
+    int first = index % SPECT_SNAPSHOT_PAGE_SIZE;
+    uint16_t len = 0;
+
+    for (int i = first; i < SPECT_SNAPSHOT_PAGE_SIZE; i++) {
+        int word = index + (i - first);
+
+        // Block can start at breakpoint, but never contains it further on
+        if (i > first && model_->breakpoints_[word])
+            break;
+        if (page.ops[i].handler == nullptr && !Decode(word))
+            break;
+
+        len++;
+
+        if (page.ops[i].instr->itype_ == InstructionType::J)
+            break;
+    }
+
+    page.blocks[first] = len;
+    return len;
+}
+
+int spect::FastEngine::ExecuteBlock(int n)
+{
+    uint16_t pc = model_->pc_;
+    if (!model_->IsWithinMem(CpuMemory::INSTR_MEM, pc))
+        return 0;
+
+    int index = (pc - SPECT_INSTR_MEM_BASE) >> 2;
+    const DecodedPage *page = GetPage(index);
+    const FastOp *op = &page->ops[index % SPECT_SNAPSHOT_PAGE_SIZE];
+
+    uint64_t len = page->blocks[index % SPECT_SNAPSHOT_PAGE_SIZE];
+    if (len == 0 && (!IsPrivate(page, index) || (len = BuildBlock(index)) == 0))
+        return 0;
+
+    // Cut the block short at requested count or at limit of executed instructions.
+    // Limit is hit only when instruction counter becomes equal to it, same as in reference
+    // engine.
+    if (n > 0 && static_cast<uint64_t>(n) < len)
+        len = n;
+    uint64_t to_limit = model_->max_instr_cnt_ - model_->instr_cnt_;
+    if (to_limit > 0 && to_limit < len)
+        len = to_limit;
+
+    const FastOp *last = op + len - 1;
+
+    bool timing = model_->timing_accurate_sim_;
+    if (timing) {
+        uint32_t cycles = 0;
+        for (const FastOp *it = op; it <= last; it++)
+            cycles += model_->instr_stats_[it->id].cycles;
+        usleep(cycles * model_->execution_time_step_);
+    }
+
+    // Only the last instruction of block can read or modify PC
+    for (; op < last; op++) {
+        CpuModel::InstrStats &stats = model_->instr_stats_[op->id];
+        if (!timing)
+            stats.cycles = 0;
+        stats.exec_cnt++;
+        op->handler(model_, *op);
+    }
+
+    CpuModel::InstrStats &stats = model_->instr_stats_[last->id];
+    if (!timing)
+        stats.cycles = 0;
+    stats.exec_cnt++;
+
+    model_->pc_ = pc + static_cast<uint16_t>((len - 1) << 2);
+    if (last->handler(model_, *last))
+        model_->pc_ += 0x4;
+
+    model_->instr_cnt_ += len;
+    if (model_->instr_cnt_ == model_->max_instr_cnt_)
+        model_->InstrLimitReached();
+
+    return static_cast<int>(len);
+}
+
+bool spect::FastEngine::ExecuteNextInstruction(int cycles, int &rv)
+{
+    uint16_t pc = model_->pc_;
+    if (!model_->IsWithinMem(CpuMemory::INSTR_MEM, pc))
+        return false;
+
+    int index = (pc - SPECT_INSTR_MEM_BASE) >> 2;
+    const DecodedPage *page = GetPage(index);
+    const FastOp &op = page->ops[index % SPECT_SNAPSHOT_PAGE_SIZE];
+    if (op.handler == nullptr && (!IsPrivate(page, index) || !Decode(index)))
+        return false;
+
+    // Same statistics and timing as in reference engine
+    rv = 0;
+    CpuModel::InstrStats &stats = model_->instr_stats_[op.id];
+    if (cycles > 0 && cycles != stats.cycles)
+        rv = stats.cycles;
+    if (!op.c_time)
+        rv = 0;
+
+    if (model_->timing_accurate_sim_)
+        usleep(stats.cycles * model_->execution_time_step_);
+    else
+        stats.cycles = cycles;
+
+    stats.exec_cnt++;
+
+    if (op.handler(model_, op))
+        model_->pc_ += 0x4;
+
+    model_->instr_cnt_++;
+    if (model_->instr_cnt_ == model_->max_instr_cnt_) {
+        model_->InstrLimitReached();
+        rv = 0;
+    }
+
+    return true;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Instruction handlers
+//  Semantics match InstructionDefsV2.cpp. Whenever instruction inputs break HW pre-conditions,
+//  handler falls back to Instruction::Execute() to report the same errors as reference engine.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<class T>
+bool spect::FastEngine::Execute(CpuModel *model, const FastOp &op)
+{
+    return static_cast<T*>(op.instr)->T::Execute(model);
+}
+
+#define FAST_EXECUTE(classname)                                                                 \
+    template<>                                                                                  \
+    bool spect::FastEngine::Execute<spect::classname>(A_UNUSED CpuModel *model,                 \
+                                                      A_UNUSED const FastOp &op)
+
+#define GPR(index) model->gpr_[index]
+
+// P25519 prime (2^255 - 19)
+static const uint256_t p_25519 = (uint256_t(1U) << 255) - 19U;
+
+// P256 prime (2^256 - 2^224 + 2^192 + 2^96 - 1)
+static const uint256_t p_256 = (uint256_t(0U) - (uint256_t(1U) << 224)) + (uint256_t(1U) << 192) +
+                               (uint256_t(1U) << 96) - 1U;
+
+// Mask of bit shifted out by 1 bit shift: MSB for left shift, LSB for right shift
+template<bool left>
+static inline const uint256_t& shift_carry_mask()
+{
+    static const uint256_t mask = left ? (uint256_t(1U) << 255) : uint256_t(1U);
+    return mask;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// R Instructions
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define FAST_R_32_AIRTH_OP(classname, operand, store_res)                                       \
+    FAST_EXECUTE(classname)                                                                     \
+    {                                                                                           \
+        uint32_t res = static_cast<uint32_t>(GPR(op.op2)) operand                               \
+                       static_cast<uint32_t>(GPR(op.op3));                                      \
+        if (store_res)                                                                          \
+            SetGpr(model, op.op1, uint256_t(res));                                              \
+        model->flags_.zero = (res == 0);                                                        \
+        return true;                                                                            \
+    }
+
+FAST_R_32_AIRTH_OP(V2InstructionADD, +, true)
+FAST_R_32_AIRTH_OP(V2InstructionSUB, -, true)
+FAST_R_32_AIRTH_OP(V2InstructionCMP, -, false)
+
+#define FAST_R_LOGIC_OP(classname, operand)                                                     \
+    FAST_EXECUTE(classname)                                                                     \
+    {                                                                                           \
+        uint256_t res = GPR(op.op2) operand GPR(op.op3);                                        \
+        model->flags_.zero = res.is_zero();                                                     \
+        SetGpr(model, op.op1, res);                                                             \
+        return true;                                                                            \
+    }
+
+FAST_R_LOGIC_OP(V2InstructionAND, &)
+FAST_R_LOGIC_OP(V2InstructionOR,  |)
+FAST_R_LOGIC_OP(V2InstructionXOR, ^)
+
+FAST_EXECUTE(V2InstructionNOT)
+{
+    // Operate on copy, ~ modifies its operand
+    uint256_t res = GPR(op.op2);
+    res = ~res;
+    model->flags_.zero = res.is_zero();
+    SetGpr(model, op.op1, res);
+    return true;
+}
+
+#define FAST_BIT_OP(classname, operation)                                                       \
+    FAST_EXECUTE(classname)                                                                     \
+    {                                                                                           \
+        uint32_t bit = static_cast<uint32_t>(GPR(op.op3)) & 0xFF;                               \
+        uint256_t tmp = GPR(op.op2);                                                            \
+        auto &limbs = tmp.representation();                                                     \
+        limbs[bit / 32] operation;                                                              \
+        SetGpr(model, op.op1, tmp);                                                             \
+        return true;                                                                            \
+    }
+
+FAST_BIT_OP(V2InstructionSBIT, |= (uint32_t(1) << (bit % 32)))
+FAST_BIT_OP(V2InstructionCBIT, &= ~(uint32_t(1) << (bit % 32)))
+
+#define FAST_SHIFT_OP(classname, op_shift, op_opposite, n_bits, rotate, op3_in, set_carry)      \
+    FAST_EXECUTE(classname)                                                                     \
+    {                                                                                           \
+        const uint256_t &op2 = GPR(op.op2);                                                     \
+        uint256_t tmp = op2 op_shift n_bits;                                                    \
+        if (rotate)                                                                             \
+            tmp |= op2 op_opposite (256 - n_bits);                                              \
+        if (op3_in)                                                                             \
+            tmp |= GPR(op.op3) op_opposite (256 - n_bits);                                      \
+        if (set_carry)                                                                          \
+            /* Bit shifted out: MSB for left shift, LSB for right shift */                      \
+            model->flags_.carry = !(op2 & shift_carry_mask<(1 op_shift 1) == 2>()).is_zero();   \
+        SetGpr(model, op.op1, tmp);                                                             \
+        return true;                                                                            \
+    }
+
+FAST_SHIFT_OP(V2InstructionLSL,     <<, >>, 1, false, false, true)
+FAST_SHIFT_OP(V2InstructionLSR,     >>, <<, 1, false, false, true)
+FAST_SHIFT_OP(V2InstructionROL,     <<, >>, 1, true,  false, true)
+FAST_SHIFT_OP(V2InstructionROR,     >>, <<, 1, true,  false, true)
+FAST_SHIFT_OP(V2InstructionROL8,    <<, >>, 8, true,  false, false)
+FAST_SHIFT_OP(V2InstructionROR8,    >>, <<, 8, true,  false, false)
+FAST_SHIFT_OP(V2InstructionROLIN,   <<, >>, 8, false, true,  false)
+FAST_SHIFT_OP(V2InstructionRORIN,   >>, <<, 8, false, true,  false)
+
+FAST_EXECUTE(V2InstructionSWE)
+{
+    uint256_t res;
+    const auto &src = GPR(op.op2).crepresentation();
+    auto &dst = res.representation();
+    for (size_t i = 0; i < src.size(); i++)
+        dst[src.size() - 1 - i] = __builtin_bswap32(src[i]);
+    SetGpr(model, op.op1, res);
+    return true;
+}
+
+FAST_EXECUTE(V2InstructionMOV)
+{
+    SetGpr(model, op.op1, GPR(op.op2));
+    return true;
+}
+
+FAST_EXECUTE(V2InstructionLDR)
+{
+    uint16_t addr = static_cast<uint16_t>(GPR(op.op2));
+    uint256_t tmp;
+    auto &limbs = tmp.representation();
+    for (size_t i = 0; i < limbs.size(); i++)
+        limbs[i] = model->ReadMemoryCoreData(addr + (4 * i));
+    SetGpr(model, op.op1, tmp);
+    return true;
+}
+
+FAST_EXECUTE(V2InstructionSTR)
+{
+    uint16_t addr = static_cast<uint16_t>(GPR(op.op2));
+    const auto limbs = GPR(op.op1).crepresentation();
+    for (size_t i = 0; i < limbs.size(); i++)
+        model->WriteMemoryCoreData(addr + (4 * i), limbs[i]);
+    return true;
+}
+
+#define FAST_SWAP_OP(classname, flag_name)                                                      \
+    FAST_EXECUTE(classname)                                                                     \
+    {                                                                                           \
+        if (model->flags_.flag_name) {                                                          \
+            uint256_t tmp = GPR(op.op2);                                                        \
+            SetGpr(model, op.op2, GPR(op.op1));                                                 \
+            SetGpr(model, op.op1, tmp);                                                         \
+        }                                                                                       \
+        return true;                                                                            \
+    }
+
+FAST_SWAP_OP(V2InstructionCSWAP, carry)
+FAST_SWAP_OP(V2InstructionZSWAP, zero)
+
+#define FAST_FIXED_PRIME_MUL_OP(classname, mul_fnc, prime)                                      \
+    FAST_EXECUTE(classname)                                                                     \
+    {                                                                                           \
+        const uint256_t &op2 = GPR(op.op2);                                                     \
+        const uint256_t &op3 = GPR(op.op3);                                                     \
+        if (op2 >= prime || op3 >= prime)                                                       \
+            return static_cast<classname*>(op.instr)->classname::Execute(model);                \
+        SetGpr(model, op.op1, ModularReduction::mul_fnc(op2, op3));                             \
+        return true;                                                                            \
+    }
+
+FAST_FIXED_PRIME_MUL_OP(V2InstructionMUL25519, MulModP25519, p_25519)
+FAST_FIXED_PRIME_MUL_OP(V2InstructionMUL256,   MulModP256,   p_256)
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Modular operations by R31. Operands of ADDP and SUBP are already reduced (checked), so single
+// conditional correction by R31 gives the same result as generic reduction.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+FAST_EXECUTE(V2InstructionADDP)
+{
+    const uint256_t &op2 = GPR(op.op2);
+    const uint256_t &op3 = GPR(op.op3);
+    const uint256_t &prime = GPR(TO_INT(CpuGpr::R31));
+    if (op2 >= prime || op3 >= prime || prime < 2U)
+        return static_cast<V2InstructionADDP*>(op.instr)->V2InstructionADDP::Execute(model);
+
+    uint256_t sum = op2 + op3;
+    if (sum < op2 || sum >= prime)
+        sum -= prime;
+    SetGpr(model, op.op1, sum);
+    return true;
+}
+
+FAST_EXECUTE(V2InstructionSUBP)
+{
+    const uint256_t &op2 = GPR(op.op2);
+    const uint256_t &op3 = GPR(op.op3);
+    const uint256_t &prime = GPR(TO_INT(CpuGpr::R31));
+    if (op2 >= prime || op3 >= prime || prime < 2U)
+        return static_cast<V2InstructionSUBP*>(op.instr)->V2InstructionSUBP::Execute(model);
+
+    uint256_t diff = op2 - op3;
+    if (op3 > op2)
+        diff += prime;
+    SetGpr(model, op.op1, diff);
+    return true;
+}
+
+FAST_EXECUTE(V2InstructionMULP)
+{
+    SetGpr(model, op.op1, model->GetR31Reduction().MulMod(GPR(op.op2), GPR(op.op3)));
+    return true;
+}
+
+FAST_EXECUTE(V2InstructionREDP)
+{
+    uint512_t tmp;
+    auto &dst = tmp.representation();
+    const auto &hi = GPR(op.op2).crepresentation();
+    const auto &lo = GPR(op.op3).crepresentation();
+    for (size_t i = 0; i < lo.size(); i++) {
+        dst[i] = lo[i];
+        dst[i + lo.size()] = hi[i];
+    }
+    SetGpr(model, op.op1, model->GetR31Reduction().Reduce(tmp));
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// I Instructions
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define FAST_I_32_AIRTH_OP(classname, operand, store_res)                                       \
+    FAST_EXECUTE(classname)                                                                     \
+    {                                                                                           \
+        uint32_t res = static_cast<uint32_t>(GPR(op.op2)) operand uint32_t(op.imm);             \
+        if (store_res)                                                                          \
+            SetGpr(model, op.op1, uint256_t(res));                                              \
+        model->flags_.zero = (res == 0);                                                        \
+        return true;                                                                            \
+    }
+
+FAST_I_32_AIRTH_OP(V2InstructionADDI, +, true)
+FAST_I_32_AIRTH_OP(V2InstructionSUBI, -, true)
+FAST_I_32_AIRTH_OP(V2InstructionCMPI, -, false)
+
+// Logic operation on 12 LSBs, upper bits are passed from op2
+#define FAST_I_LOGIC_OP(classname, operand)                                                     \
+    FAST_EXECUTE(classname)                                                                     \
+    {                                                                                           \
+        uint256_t res = GPR(op.op2);                                                            \
+        auto &limbs = res.representation();                                                     \
+        limbs[0] = (limbs[0] & ~uint32_t(0xFFF)) |                                              \
+                   (((limbs[0] & 0xFFF) operand (uint32_t(op.imm) & 0xFFF)) & 0xFFF);           \
+        model->flags_.zero = res.is_zero();                                                     \
+        SetGpr(model, op.op1, res);                                                             \
+        return true;                                                                            \
+    }
+
+FAST_I_LOGIC_OP(V2InstructionANDI, &)
+FAST_I_LOGIC_OP(V2InstructionORI,  |)
+FAST_I_LOGIC_OP(V2InstructionXORI, ^)
+
+FAST_EXECUTE(V2InstructionMOVI)
+{
+    SetGpr(model, op.op1, uint256_t(op.imm));
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// M Instructions
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+FAST_EXECUTE(V2InstructionLD)
+{
+    uint256_t tmp;
+    auto &limbs = tmp.representation();
+    for (size_t i = 0; i < limbs.size(); i++)
+        limbs[i] = model->ReadMemoryCoreData(op.imm + (4 * i));
+    SetGpr(model, op.op1, tmp);
+    return true;
+}
+
+FAST_EXECUTE(V2InstructionST)
+{
+    const auto limbs = GPR(op.op1).crepresentation();
+    for (size_t i = 0; i < limbs.size(); i++)
+        model->WriteMemoryCoreData(op.imm + (4 * i), limbs[i]);
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// J Instructions
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+FAST_EXECUTE(V2InstructionCALL)
+{
+    model->RarPush(model->pc_ + 0x4);
+    model->pc_ = op.imm;
+    return false;
+}
+
+FAST_EXECUTE(V2InstructionRET)
+{
+    model->pc_ = model->RarPop();
+    return false;
+}
+
+#define FAST_COND_JUMP_OP(classname, flag_name, value)                                          \
+    FAST_EXECUTE(classname)                                                                     \
+    {                                                                                           \
+        if (model->flags_.flag_name == value) {                                                 \
+            model->pc_ = op.imm;                                                                \
+            return false;                                                                       \
+        }                                                                                       \
+        return true;                                                                            \
+    }
+
+FAST_COND_JUMP_OP(V2InstructionBRZ,  zero,  true)
+FAST_COND_JUMP_OP(V2InstructionBRNZ, zero,  false)
+FAST_COND_JUMP_OP(V2InstructionBRC,  carry, true)
+FAST_COND_JUMP_OP(V2InstructionBRNC, carry, false)
+FAST_COND_JUMP_OP(V2InstructionBRE,  error, true)
+FAST_COND_JUMP_OP(V2InstructionBRNE, error, false)
+
+FAST_EXECUTE(V2InstructionJMP)
+{
+    model->pc_ = op.imm;
+    return false;
+}
+
+FAST_EXECUTE(V2InstructionNOP)
+{
+    return true;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Handler table
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+const std::vector<spect::FastEngine::Handler>& spect::FastEngine::GetHandlers()
+{
+    static const std::vector<Handler> handlers = [] () {
+        std::vector<Handler> rv(InstructionFactory::GetInstructionCount(), nullptr);
+
+        /////////////////////////////////////////////////////////////////////////////////////
+        // List of macros defined by CMake from InstructionDefs.txt, for each instruction:
+        //  FAST_HANDLER(version, name, mnemonic)
+        //  where:
+        //      version     - SPECT ISA version
+        //      name        - Name of instruction class (V<version>Instruction<MNEMONIC>)
+        //      mnemonic    - Instruction mnemonic
+        /////////////////////////////////////////////////////////////////////////////////////
+        #define FAST_HANDLER(version, name, mnemonic)                                       \
+            rv[InstructionFactory::GetInstruction(version, mnemonic)->id_] = &Execute<name>;
+
+        SPECT_FAST_HANDLERS_V1
+        SPECT_FAST_HANDLERS_V2
+
+        #undef FAST_HANDLER
+
+        return rv;
+    } ();
+
+    return handlers;
+}
@@ -0,0 +1,197 @@
+/**************************************************************************************************
+*
+* SPECT Compiler
+* Copyright (C) 2022-present Tropic Square
+*
+* @todo: License
+*
+**************************************************************************************************/
+
+#ifndef SPECT_LIB_FAST_ENGINE_H_
+#define SPECT_LIB_FAST_ENGINE_H_
+
+#include <memory>
+#include <vector>
+
+#include "spect.h"
+#include "CowMemory.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Fast execution engine
+//  Instructions from Instruction memory are decoded once to compact FastOp entries. Each entry
+//  holds pointer to handler of the instruction and its operands. Handler table is generated
+//  from InstructionDefs_v*.txt (SPECT_FAST_HANDLERS_V* macros). Instructions without dedicated
+//  handler fall back to Instruction::Execute() of the pre-decoded instruction.
+//
+//  Straight-line runs of decoded entries ending by J-type instruction (branch, CALL, RET, END)
+//  are cached as basic blocks. Block is executed by single dispatch: PC, instruction counter
+//  and limit of executed instructions are updated once per block. Blocks never span model
+//  breakpoints, and block is cut short when it would cross the instruction count limit.
+//
+//  Entries and blocks are held per page of Instruction memory (SPECT_SNAPSHOT_PAGE_SIZE
+//  words), blocks never cross end of page. Program image decodes all its pages once
+//  (BuildPage). Engine executes page of the image while model memory shares the page with
+//  the image and the page has no breakpoint. Other pages are decoded by the engine into
+//  private pages on first use.
+//
+//  Architectural state after execution matches reference engine. Dedicated handlers do not
+//  print per-instruction debug messages, do not sample DPI instruction (last_instr) and do
+//  not report changes. Model therefore uses the fast engine only while change reporting and
+//  instruction sampling are disabled.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+class spect::FastEngine
+{
+    public:
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Pre-decoded instruction
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        struct FastOp;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Instruction handler
+        /// @returns Same as Instruction::Execute()
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        typedef bool (*Handler)(CpuModel *model, const FastOp &op);
+
+        struct FastOp {
+            // Handler, nullptr - Entry not decoded yet (private page), or word is not valid
+            // instruction
+            Handler handler;
+
+            // Pre-decoded instruction (owned by model instruction cache or program image)
+            Instruction *instr;
+
+            // Immediate (I), Address (M) or New PC (J)
+            uint16_t imm;
+
+            // Instruction::id_
+            uint16_t id;
+
+            // GPR operand indices
+            uint8_t op1;
+            uint8_t op2;
+            uint8_t op3;
+
+            // Instruction executes in constant time
+            bool c_time;
+        };
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Decoded page of Instruction memory
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        struct DecodedPage {
+            // Decoded words of the page
+            FastOp ops[SPECT_SNAPSHOT_PAGE_SIZE];
+
+            // Number of instructions in basic block starting at each word of the page,
+            // 0 - Block not built yet (private page), word is not valid instruction (image page)
+            uint16_t blocks[SPECT_SNAPSHOT_PAGE_SIZE];
+        };
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Fast engine constructor
+        /// @param model Model whose state the engine executes on
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        FastEngine(CpuModel *model);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Execute next instruction of the model
+        /// @param cycles Same as CpuModel::StepSingle
+        /// @param rv Return value of CpuModel::StepSingle, valid only when instruction executed.
+        /// @returns True  - Instruction was executed.
+        ///          False - Instruction was not executed (PC outside of Instruction memory or
+        ///                  invalid instruction), reference engine shall execute it.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        bool ExecuteNextInstruction(int cycles, int &rv);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Execute basic block starting at PC of the model
+        /// @param n Maximal number of instructions to execute, 0 - no limit.
+        /// @returns Number of executed instructions.
+        ///          0 - Nothing was executed (PC outside of Instruction memory or invalid
+        ///              instruction), reference engine shall execute next instruction.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        int ExecuteBlock(int n);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Invalidate decoded entries and basic blocks of all pages
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void Invalidate();
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Invalidate decoded entries and basic blocks of page with Instruction memory
+        ///        word (word or breakpoint on the word was modified)
+        /// @param address Address within Instruction memory
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void InvalidateAt(uint16_t address);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Decode all words of page and build all its basic blocks
+        /// @param page Page to build
+        /// @param instrs Pre-decoded instructions of page words, nullptr for invalid words
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        static void BuildPage(DecodedPage &page, Instruction *const *instrs);
+
+    private:
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Decode instruction to FastOp entry
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        static void Decode(Instruction *instr, FastOp &op);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Decode Instruction memory word to FastOp entry of private page
+        /// @param index Index of the word within Instruction memory
+        /// @returns True if the word holds valid instruction, False otherwise
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        bool Decode(int index);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Build basic block of private page starting at Instruction memory word
+        /// @param index Index of the first word of the block within Instruction memory
+        /// @returns Number of instructions in block, 0 if first word is not valid instruction
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        uint16_t BuildBlock(int index);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Select page of program image or private page for page of Instruction memory.
+        ///        Private page is cleared.
+        /// @param page Index of page within Instruction memory
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void SelectPage(int page);
+
+        // Page with Instruction memory word, page is selected on first use
+        inline const DecodedPage* GetPage(int index);
+
+        // Page is private page of the engine
+        inline bool IsPrivate(const DecodedPage *page, int index);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Handler of instruction class T. Generic version falls back to T::Execute,
+        ///        dedicated versions are specialized in FastEngine.cpp.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        template<class T>
+        static bool Execute(CpuModel *model, const FastOp &op);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @returns Handler table indexed by Instruction::id_
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        static const std::vector<Handler>& GetHandlers();
+
+        // GPR write which keeps R31 reduction context of the model coherent
+        static inline void SetGpr(CpuModel *model, int index, const uint256_t &val);
+
+        // Model attached to the engine
+        CpuModel *model_;
+
+        // Number of pages of Instruction memory
+        static const int PAGE_CNT = SPECT_INSTR_MEM_SIZE / 4 / SPECT_SNAPSHOT_PAGE_SIZE;
+
+        // Executed pages: page of program image or private page
+        const DecodedPage *pages_[PAGE_CNT] = {};
+
+        // Private pages, allocated on first use
+        std::unique_ptr<DecodedPage> private_[PAGE_CNT];
+};
+
+#endif
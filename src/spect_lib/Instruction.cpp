@@ -61,7 +61,8 @@ uint32_t spect::Instruction::Assemble(spect::ParityType parity_type)
     return (wrd | ((parity & IENC_PARITY_MASK) << IENC_PARITY_OFFSET));
 }
 
-spect::Instruction* spect::Instruction::DisAssemble(spect::ParityType parity_type, uint32_t wrd)
+spect::Instruction* spect::Instruction::DisAssemble(int isa_version, spect::ParityType parity_type,
+                                                 uint32_t wrd)
 {
     using namespace spect;
     uint32_t itype = (wrd >> IENC_TYPE_OFFSET) & IENC_TYPE_MASK;
@@ -72,13 +73,13 @@ spect::Instruction* spect::Instruction::DisAssemble(spect::ParityType parity_typ
 
     switch (itype) {
     case TO_INT(InstructionType::R):
-        return InstructionR::DisAssemble(wrd);
+        return InstructionR::DisAssemble(isa_version, wrd);
     case TO_INT(InstructionType::I):
-        return InstructionI::DisAssemble(wrd);
+        return InstructionI::DisAssemble(isa_version, wrd);
     case TO_INT(InstructionType::M):
-        return InstructionM::DisAssemble(wrd);
+        return InstructionM::DisAssemble(isa_version, wrd);
     default:
-        return InstructionJ::DisAssemble(wrd);
+        return InstructionJ::DisAssemble(isa_version, wrd);
     }
 }
 
@@ -54,11 +54,14 @@ class spect::Instruction
 
         ///////////////////////////////////////////////////////////////////////////////////////////
         /// @brief Execute the instruction
+        /// @param model Model on which the instruction is executed
         /// @returns True  - PC shall be increased by +0x4 after the call (e.g ADD)/
         ///          False - PC shall not be increased, instruction modfied the PC by itself
         ///                  (e.g. JUMP)
+        /// @note Instruction holds no model state. Single decoded instruction can be therefore
+        ///       executed by multiple models (see ProgramImage).
         ///////////////////////////////////////////////////////////////////////////////////////////
-        virtual bool Execute() = 0;
+        virtual bool Execute(CpuModel *model) = 0;
 
         ///////////////////////////////////////////////////////////////////////////////////////////
         /// @brief Assemble the instruction
@@ -76,11 +79,13 @@ class spect::Instruction
 
         ///////////////////////////////////////////////////////////////////////////////////////////
         /// @brief Clone the instruction
+        /// @param isa_version ISA version to decode the instruction word by
         /// @param parity_type Type of parity to check
         /// @returns New instruction object living on heap, matches attributes of object which
         ///          called this function.
         ///////////////////////////////////////////////////////////////////////////////////////////
-        static spect::Instruction* DisAssemble(spect::ParityType parity_type, uint32_t wrd);
+        static spect::Instruction* DisAssemble(int isa_version, spect::ParityType parity_type,
+                                               uint32_t wrd);
 
         ///////////////////////////////////////////////////////////////////////////////////////////
         /// @brief Relocate the instruction.
@@ -152,14 +157,18 @@ class spect::Instruction
         int op_mask_;
 
         ///////////////////////////////////////////////////////////////////////////////////////////
-        /// Number of clock cycles instruction take to execute on RTL
-        ///  When in timing accurate mode, this value is used to insert delay.
-        ///  When running on RTL, this variable is used to store observed execution duration.
+        /// Number of clock cycles instruction take to execute on RTL (as in InstructionDefs.txt)
+        ///  Each CpuModel takes its initial per-instruction statistics from this value, it is
+        ///  never modified during execution.
         ///////////////////////////////////////////////////////////////////////////////////////////
         int cycles_;
 
-        // Number of times instruction was executed
-        uint64_t exec_cnt_ = 0;
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// Dense index of the instruction prototype within Instruction factory.
+        ///  Assigned when the prototype is registered, copied to each clone. Unique across
+        ///  all ISA versions, ranges from 0 to InstructionFactory::GetInstructionCount() - 1.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        int id_ = -1;
 
         // Symbol with instruction label from .s file
         spect::Symbol *s_label_ = nullptr;
@@ -169,10 +178,6 @@ class spect::Instruction
 
         // Instruction executes in constant time
         bool c_time_;
-
-    public:
-        // SPECT Model attached to the instruction
-        CpuModel *model_ = nullptr;
 };
 
 #endif
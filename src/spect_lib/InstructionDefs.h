@@ -39,9 +39,11 @@
                              op1, op2, op3, r31_dep, c_time, cycles)                            \
                 {};                                                                             \
             spect::Instruction* Clone() {                                                       \
-                return new name(op1_, op2_, op3_);                                              \
+                spect::Instruction *instr = new name(op1_, op2_, op3_);                         \
+                instr->id_ = id_;                                                               \
+                return instr;                                                                   \
             }                                                                                   \
-            bool Execute();                                                                     \
+            bool Execute(CpuModel *model);                                                      \
     };
 
 #define DEFINE_I_INSTRUCTION(name, mnemonic, opcode, func, op_mask, r31_dep, c_time, cycles)    \
@@ -52,9 +54,11 @@
                              op1, op2, immediate, r31_dep, c_time, cycles)                      \
                 {};                                                                             \
             spect::Instruction* Clone() {                                                       \
-                return new name(op1_, op2_, immediate_);                                        \
+                spect::Instruction *instr = new name(op1_, op2_, immediate_);                   \
+                instr->id_ = id_;                                                               \
+                return instr;                                                                   \
             }                                                                                   \
-            bool Execute();                                                                     \
+            bool Execute(CpuModel *model);                                                      \
     };                                                                                          \
 
 #define DEFINE_M_INSTRUCTION(name, mnemonic, opcode, func, op_mask, r31_dep, c_time, cycles)    \
@@ -65,9 +69,11 @@
                             op1, addr, r31_dep, c_time, cycles)                                 \
                 {};                                                                             \
             spect::Instruction* Clone() {                                                       \
-                return new name(op1_, addr_);                                                   \
+                spect::Instruction *instr = new name(op1_, addr_);                              \
+                instr->id_ = id_;                                                               \
+                return instr;                                                                   \
             }                                                                                   \
-            bool Execute();                                                                     \
+            bool Execute(CpuModel *model);                                                      \
     };                                                                                          \
 
 #define DEFINE_J_INSTRUCTION(name, mnemonic, opcode, func, op_mask, r31_dep, c_time, cycles)    \
@@ -78,9 +84,11 @@
                              c_time, cycles)                                                    \
                 {};                                                                             \
             spect::Instruction* Clone() {                                                       \
-                return new name(new_pc_);                                                       \
+                spect::Instruction *instr = new name(new_pc_);                                  \
+                instr->id_ = id_;                                                               \
+                return instr;                                                                   \
             }                                                                                   \
-            bool Execute();                                                                     \
+            bool Execute(CpuModel *model);                                                      \
     };                                                                                          \
 
 
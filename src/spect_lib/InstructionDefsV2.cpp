@@ -14,6 +14,7 @@
 
 #include "InstructionDefs.h"
 #include "InstructionFactory.h"
+#include "ModularReduction.h"
 
 #include "ordt_pio_common.hpp"
 #include "ordt_pio.hpp"
@@ -22,6 +23,24 @@
 // Helper functions
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Constants used by instruction semantics.
+// Built once at start-up instead of being parsed from strings on each instruction execution.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Number of hexadecimal digits in a single limb of uint256_t
+static constexpr int LIMB_DIGITS = std::numeric_limits<uint256_t::limb_type>::digits / 4;
+
+// P25519 prime (2^255 - 19)
+static const uint256_t p_25519 = (uint256_t(1U) << 255) - 19U;
+
+// P256 prime (2^256 - 2^224 + 2^192 + 2^96 - 1)
+static const uint256_t p_256 = (uint256_t(0U) - (uint256_t(1U) << 224)) + (uint256_t(1U) << 192) +
+                               (uint256_t(1U) << 96) - 1U;
+
+// Mask ORed to op3 by SCB (2^255 + 2^223)
+static const uint512_t scb_mask = (uint512_t(1U) << 255) | (uint512_t(1U) << 223);
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /// @brief Mask LSB part of number
 /// @param val Number to mask
@@ -30,8 +49,18 @@
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 static uint256_t mask_n_lsb_digits(const uint256_t &val, int digits)
 {
-    std::string mask = std::string("0x") + std::string(digits, 'F');
-    return val & uint256_t(mask.c_str());
+    uint256_t rv = val;
+    auto &limbs = rv.representation();
+
+    for (size_t i = 0; i < limbs.size(); i++) {
+        int limb_digits = digits - static_cast<int>(i) * LIMB_DIGITS;
+        if (limb_digits <= 0)
+            limbs[i] = 0;
+        else if (limb_digits < LIMB_DIGITS)
+            limbs[i] &= (uint256_t::limb_type(1) << (limb_digits * 4)) - 1;
+    }
+
+    return rv;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -39,7 +68,7 @@ static uint256_t mask_n_lsb_digits(const uint256_t &val, int digits)
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 static bool is_32_lsb_bits_zero(const uint256_t &val)
 {
-    return ((val & (uint256_t("0xFFFFFFFF"))) == uint256_t("0x000000000"));
+    return (static_cast<uint32_t>(val) == 0);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -59,77 +88,51 @@ static uint256_t binary_logic_op_lsb(const uint256_t &lhs, const uint256_t &rhs,
     uint256_t mask_a = mask_n_lsb_digits(lhs, active_digits);
     uint256_t mask_b = mask_n_lsb_digits(rhs, active_digits);
 
-    // LHS corresponds to op2_, mask its 'active_digits' LSB bits, keep only upper bits
-    std::string mask_msb = std::string("0x") +
-                           std::string(64 - active_digits, 'F') +
-                           std::string(active_digits, '0');
-    uint256_t mask_res = lhs & uint256_t(mask_msb.c_str());
+    // LHS corresponds to op2_, clear its 'active_digits' LSB bits, keep only upper bits
+    uint256_t mask_res = lhs ^ mask_a;
 
     uint256_t op_res = op(mask_a, mask_b);
     uint256_t rv = mask_res | op_res;
     return rv;
 }
 
-///////////////////////////////////////////////////////////////////////////////////////////////////
-/// @returns P25519 prime (2^255 - 19)
-///////////////////////////////////////////////////////////////////////////////////////////////////
-static uint512_t get_p_25519()
-{
-    uint512_t tmp = uint512_t("0x1");
-    tmp = tmp << 255;
-    return tmp - uint512_t("19");
-}
-
-///////////////////////////////////////////////////////////////////////////////////////////////////
-/// @returns P256 prime (2^256 - 2^224 + 2^192 + 2^96 - 1)
-///////////////////////////////////////////////////////////////////////////////////////////////////
-static uint512_t get_p_256()
-{
-    uint512_t msk = uint512_t("0x1");
-    uint512_t tmp = (msk << 256);
-    tmp -= (msk << 224);
-    tmp += (msk << 192);
-    tmp += (msk << 96);
-    tmp -= msk;
-    return tmp;
-}
-
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /// @returns Checks if inputs to modular instruction inputs are less than prime modulus.
 ///          This is pre-condition of HW, and if not met, its behavior is undefined.
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-static void check_modulo_conds(spect::CpuModel *model, spect::InstructionR *instr, uint256_t prime)
+static void check_modulo_conds(spect::CpuModel *model, spect::InstructionR *instr,
+                               const uint256_t &prime)
 {
     uint256_t op2 = model->GetGpr(TO_INT(instr->op2_));
     uint256_t op3 = model->GetGpr(TO_INT(instr->op3_));
-    if (op2 >= prime || op3 >= prime || prime == uint256_t("0x0") || prime == uint256_t("0x1"))
+    if (op2 >= prime || op3 >= prime || prime == 0U || prime == 1U)
     {
         std::stringstream ss;
         ss << "Error: Input operands are not valid -> Behavior of HW is undefined. ";
         ss << "Following conditions are not met:";
-        model->DebugInfo(VERBOSITY_NONE, ss.str().c_str());
+        DEBUG_INFO(model, VERBOSITY_NONE, ss.str().c_str());
         ss.str("");
 
         if (op2 >= prime) {
             ss << "    op2(" << instr->op2_ << ") < 0x" << std::hex << prime;
-            model->DebugInfo(VERBOSITY_NONE, ss.str().c_str());
+            DEBUG_INFO(model, VERBOSITY_NONE, ss.str().c_str());
         }
         ss.str("");
 
         if (op3 >= prime) {
             ss << "    op3(" << instr->op3_ << ") < 0x" << std::hex << prime;
-            model->DebugInfo(VERBOSITY_NONE, ss.str().c_str());
+            DEBUG_INFO(model, VERBOSITY_NONE, ss.str().c_str());
         }
         ss.str("");
 
-        if (prime == uint256_t("0x0")) {
+        if (prime == 0U) {
             ss << "    R31(" << prime << ") != 0";
-            model->DebugInfo(VERBOSITY_NONE, ss.str().c_str());
+            DEBUG_INFO(model, VERBOSITY_NONE, ss.str().c_str());
         }
 
-        if (prime == uint256_t("0x1")) {
+        if (prime == 1U) {
             ss << "    R31(" << prime << ") != 1";
-            model->DebugInfo(VERBOSITY_NONE, ss.str().c_str());
+            DEBUG_INFO(model, VERBOSITY_NONE, ss.str().c_str());
         }
     }
 }
@@ -146,25 +149,25 @@ static void check_modulo_conds(spect::CpuModel *model, spect::InstructionR *inst
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 #define IMPLEMENT_R_32_AIRTH_OP(classname,operand,store_res)                                    \
-    bool spect::classname::Execute()                                                            \
+    bool spect::classname::Execute(CpuModel *model)                                             \
     {                                                                                           \
         DEFINE_CHANGE(ch_gpr, DPI_CHANGE_GPR, TO_INT(op1_));                                    \
         DEFINE_CHANGE(ch_zf, DPI_CHANGE_FLAG, DPI_SPECT_FLAG_ZERO);                             \
                                                                                                 \
-        PUT_FLAG_TO_CHANGE(ch_zf, old_val, model_->GetCpuFlag(CpuFlagType::ZERO));              \
-        PUT_GPR_TO_CHANGE(ch_gpr, old_val, model_->GetGpr(TO_INT(op1_)));                       \
+        PUT_FLAG_TO_CHANGE(ch_zf, old_val, model->GetCpuFlag(CpuFlagType::ZERO));               \
+        PUT_GPR_TO_CHANGE(ch_gpr, old_val, model->GetGpr(TO_INT(op1_)));                        \
                                                                                                 \
-        uint256_t add = model_->GetGpr(TO_INT(op2_)) operand model_->GetGpr(TO_INT(op3_));      \
+        uint256_t add = model->GetGpr(TO_INT(op2_)) operand model->GetGpr(TO_INT(op3_));        \
         uint256_t mask = mask_n_lsb_digits(add, 8);                                             \
         if (store_res)                                                                          \
-            model_->SetGpr(TO_INT(op1_), mask);                                                 \
-        model_->SetCpuFlag(CpuFlagType::ZERO, is_32_lsb_bits_zero(mask));                       \
+            model->SetGpr(TO_INT(op1_), mask);                                                  \
+        model->SetCpuFlag(CpuFlagType::ZERO, is_32_lsb_bits_zero(mask));                        \
                                                                                                 \
-        PUT_FLAG_TO_CHANGE(ch_zf, new_val, model_->GetCpuFlag(CpuFlagType::ZERO));              \
-        PUT_GPR_TO_CHANGE(ch_gpr, new_val, model_->GetGpr(TO_INT(op1_)));                       \
+        PUT_FLAG_TO_CHANGE(ch_zf, new_val, model->GetCpuFlag(CpuFlagType::ZERO));               \
+        PUT_GPR_TO_CHANGE(ch_gpr, new_val, model->GetGpr(TO_INT(op1_)));                        \
         if (store_res)                                                                          \
-            model_->ReportChange(ch_gpr);                                                       \
-        model_->ReportChange(ch_zf);                                                            \
+            model->ReportChange(ch_gpr);                                                        \
+        model->ReportChange(ch_zf);                                                             \
                                                                                                 \
         return true;                                                                            \
     }
@@ -175,29 +178,29 @@ IMPLEMENT_R_32_AIRTH_OP(V2InstructionCMP,-,false)
 
 
 #define IMPLEMENT_R_LOGIC_OP(classname,operand)                                                 \
-    bool spect::classname::Execute()                                                            \
+    bool spect::classname::Execute(CpuModel *model)                                             \
     {                                                                                           \
         DEFINE_CHANGE(ch_gpr, DPI_CHANGE_GPR, TO_INT(op1_));                                    \
         DEFINE_CHANGE(ch_zf, DPI_CHANGE_FLAG, DPI_SPECT_FLAG_ZERO);                             \
                                                                                                 \
-        PUT_FLAG_TO_CHANGE(ch_zf, old_val, model_->GetCpuFlag(CpuFlagType::ZERO));              \
-        PUT_GPR_TO_CHANGE(ch_gpr, old_val, model_->GetGpr(TO_INT(op1_)));                       \
+        PUT_FLAG_TO_CHANGE(ch_zf, old_val, model->GetCpuFlag(CpuFlagType::ZERO));               \
+        PUT_GPR_TO_CHANGE(ch_gpr, old_val, model->GetGpr(TO_INT(op1_)));                        \
                                                                                                 \
-        model_->SetGpr(TO_INT(op1_),                                                            \
-            binary_logic_op_lsb(model_->GetGpr(TO_INT(op2_)),                                   \
-                                model_->GetGpr(TO_INT(op3_)),                                   \
+        model->SetGpr(TO_INT(op1_),                                                             \
+            binary_logic_op_lsb(model->GetGpr(TO_INT(op2_)),                                    \
+                                model->GetGpr(TO_INT(op3_)),                                    \
                                 64,                                                             \
                 [] (const uint256_t &lhs, const uint256_t &rhs) -> uint256_t {                  \
                     return lhs operand rhs;                                                     \
                 }                                                                               \
             ));                                                                                 \
-        bool new_flag_val = (model_->GetGpr(TO_INT(op1_)) == uint256_t("0x0"));                 \
-        model_->SetCpuFlag(CpuFlagType::ZERO, new_flag_val);                                    \
+        bool new_flag_val = model->GetGpr(TO_INT(op1_)).is_zero();                              \
+        model->SetCpuFlag(CpuFlagType::ZERO, new_flag_val);                                     \
                                                                                                 \
-        PUT_FLAG_TO_CHANGE(ch_zf, new_val, model_->GetCpuFlag(CpuFlagType::ZERO));              \
-        PUT_GPR_TO_CHANGE(ch_gpr, new_val, model_->GetGpr(TO_INT(op1_)));                       \
-        model_->ReportChange(ch_gpr);                                                           \
-        model_->ReportChange(ch_zf);                                                            \
+        PUT_FLAG_TO_CHANGE(ch_zf, new_val, model->GetCpuFlag(CpuFlagType::ZERO));               \
+        PUT_GPR_TO_CHANGE(ch_gpr, new_val, model->GetGpr(TO_INT(op1_)));                        \
+        model->ReportChange(ch_gpr);                                                            \
+        model->ReportChange(ch_zf);                                                             \
                                                                                                 \
         return true;                                                                            \
     }
@@ -207,17 +210,17 @@ IMPLEMENT_R_LOGIC_OP(V2InstructionOR, |)
 IMPLEMENT_R_LOGIC_OP(V2InstructionXOR, ^)
 
 
-bool spect::V2InstructionNOT::Execute()
+bool spect::V2InstructionNOT::Execute(CpuModel *model)
 {
     DEFINE_CHANGE(ch_gpr, DPI_CHANGE_GPR, TO_INT(op1_));
     DEFINE_CHANGE(ch_zf, DPI_CHANGE_FLAG, DPI_SPECT_FLAG_ZERO);
 
-    PUT_FLAG_TO_CHANGE(ch_zf, old_val, model_->GetCpuFlag(CpuFlagType::ZERO));
-    PUT_GPR_TO_CHANGE(ch_gpr, old_val, model_->GetGpr(TO_INT(op1_)));
+    PUT_FLAG_TO_CHANGE(ch_zf, old_val, model->GetCpuFlag(CpuFlagType::ZERO));
+    PUT_GPR_TO_CHANGE(ch_gpr, old_val, model->GetGpr(TO_INT(op1_)));
 
-    model_->SetGpr( TO_INT(op1_),
-        binary_logic_op_lsb(model_->GetGpr(TO_INT(op2_)),
-                            model_->GetGpr(TO_INT(op3_)),
+    model->SetGpr( TO_INT(op1_),
+        binary_logic_op_lsb(model->GetGpr(TO_INT(op2_)),
+                            model->GetGpr(TO_INT(op3_)),
                             64,
             [] (const uint256_t &lhs, [[maybe_unused]] const uint256_t &rhs) -> uint256_t {
                 // Need copy, since ~ modifies passed reference
@@ -225,58 +228,62 @@ bool spect::V2InstructionNOT::Execute()
                 return mask_n_lsb_digits(~cpy, 64);
             }
         ));
-    model_->SetCpuFlag(CpuFlagType::ZERO, model_->GetGpr(TO_INT(op1_)) == uint256_t("0x0"));
+    model->SetCpuFlag(CpuFlagType::ZERO, model->GetGpr(TO_INT(op1_)).is_zero());
 
-    PUT_FLAG_TO_CHANGE(ch_zf, new_val, model_->GetCpuFlag(CpuFlagType::ZERO));
-    PUT_GPR_TO_CHANGE(ch_gpr, new_val, model_->GetGpr(TO_INT(op1_)));
-    model_->ReportChange(ch_gpr);
-    model_->ReportChange(ch_zf);
+    PUT_FLAG_TO_CHANGE(ch_zf, new_val, model->GetCpuFlag(CpuFlagType::ZERO));
+    PUT_GPR_TO_CHANGE(ch_gpr, new_val, model->GetGpr(TO_INT(op1_)));
+    model->ReportChange(ch_gpr);
+    model->ReportChange(ch_zf);
 
     return true;
 }
 
-bool spect::V2InstructionSBIT::Execute()
+bool spect::V2InstructionSBIT::Execute(CpuModel *model)
 {
     DEFINE_CHANGE(ch_gpr, DPI_CHANGE_GPR, TO_INT(op1_));
 
-    PUT_GPR_TO_CHANGE(ch_gpr, old_val, model_->GetGpr(TO_INT(op1_)));
+    PUT_GPR_TO_CHANGE(ch_gpr, old_val, model->GetGpr(TO_INT(op1_)));
 
-    uint256_t shift = model_->GetGpr(TO_INT(op3_)) & uint256_t("0xFF");
-    uint256_t mask  = uint256_t("0x1") << static_cast<uint32_t>(shift);
-    model_->SetGpr( TO_INT(op1_), model_->GetGpr(TO_INT(op2_)) | mask);
+    uint32_t bit = static_cast<uint32_t>(model->GetGpr(TO_INT(op3_))) & 0xFF;
+    uint256_t tmp = model->GetGpr(TO_INT(op2_));
+    auto &limbs = tmp.representation();
+    limbs[bit / 32] |= (uint32_t(1) << (bit % 32));
+    model->SetGpr( TO_INT(op1_), tmp);
 
-    PUT_GPR_TO_CHANGE(ch_gpr, new_val, model_->GetGpr(TO_INT(op1_)));
-    model_->ReportChange(ch_gpr);
+    PUT_GPR_TO_CHANGE(ch_gpr, new_val, model->GetGpr(TO_INT(op1_)));
+    model->ReportChange(ch_gpr);
 
     return true;
 }
 
-bool spect::V2InstructionCBIT::Execute()
+bool spect::V2InstructionCBIT::Execute(CpuModel *model)
 {
     DEFINE_CHANGE(ch_gpr, DPI_CHANGE_GPR, TO_INT(op1_));
 
-    PUT_GPR_TO_CHANGE(ch_gpr, old_val, model_->GetGpr(TO_INT(op1_)));
+    PUT_GPR_TO_CHANGE(ch_gpr, old_val, model->GetGpr(TO_INT(op1_)));
 
-    uint256_t shift = model_->GetGpr(TO_INT(op3_)) & uint256_t("0xFF");
-    uint256_t mask  = uint256_t("0x1") << static_cast<uint32_t>(shift);
-    model_->SetGpr( TO_INT(op1_), model_->GetGpr(TO_INT(op2_)) & ~mask);
+    uint32_t bit = static_cast<uint32_t>(model->GetGpr(TO_INT(op3_))) & 0xFF;
+    uint256_t tmp = model->GetGpr(TO_INT(op2_));
+    auto &limbs = tmp.representation();
+    limbs[bit / 32] &= ~(uint32_t(1) << (bit % 32));
+    model->SetGpr( TO_INT(op1_), tmp);
 
-    PUT_GPR_TO_CHANGE(ch_gpr, new_val, model_->GetGpr(TO_INT(op1_)));
-    model_->ReportChange(ch_gpr);
+    PUT_GPR_TO_CHANGE(ch_gpr, new_val, model->GetGpr(TO_INT(op1_)));
+    model->ReportChange(ch_gpr);
 
     return true;
 }
 
 #define IMPLEMENT_R_32_SHIFT_OP(classname,op_shift,op_opposite,n_bits,rotate,op3_in,set_carry)      \
-    bool spect::classname::Execute()                                                                \
+    bool spect::classname::Execute(CpuModel *model)                                                 \
     {                                                                                               \
         DEFINE_CHANGE(ch_gpr, DPI_CHANGE_GPR, TO_INT(op1_));                                        \
         DEFINE_CHANGE(ch_cf, DPI_CHANGE_FLAG, DPI_SPECT_FLAG_CARRY);                                \
                                                                                                     \
-        PUT_FLAG_TO_CHANGE(ch_cf, old_val, model_->GetCpuFlag(CpuFlagType::CARRY));                 \
-        PUT_GPR_TO_CHANGE(ch_gpr, old_val, model_->GetGpr(TO_INT(op1_)));                           \
+        PUT_FLAG_TO_CHANGE(ch_cf, old_val, model->GetCpuFlag(CpuFlagType::CARRY));                  \
+        PUT_GPR_TO_CHANGE(ch_gpr, old_val, model->GetGpr(TO_INT(op1_)));                            \
                                                                                                     \
-        const uint256_t &op2 = model_->GetGpr(TO_INT(op2_));                                        \
+        const uint256_t &op2 = model->GetGpr(TO_INT(op2_));                                         \
         uint256_t tmp = op2 op_shift n_bits;                                                        \
                                                                                                     \
         if (rotate) {                                                                               \
@@ -284,26 +291,23 @@ bool spect::V2InstructionCBIT::Execute()
             tmp = tmp | rotated;                                                                    \
         }                                                                                           \
         if (op3_in) {                                                                               \
-            const uint256_t &op3 = model_->GetGpr(TO_INT(op3_));                                    \
+            const uint256_t &op3 = model->GetGpr(TO_INT(op3_));                                     \
             uint256_t rotated = op3 op_opposite (256 - n_bits);                                     \
             tmp = tmp | rotated;                                                                    \
         }                                                                                           \
         if (set_carry) {                                                                            \
-            std::string mask_str = std::string("0x") + std::string("8") +                           \
-                                   std::string(62, '0') +                                           \
-                                   std::string("1");                                                \
-            uint256_t mask = uint256_t(mask_str.c_str());                                           \
-            mask = mask op_shift 255;                                                               \
-            bool new_flag_val = ((op2 & mask) == uint256_t("0x0")) ? false : true;                  \
-            model_->SetCpuFlag(CpuFlagType::CARRY, new_flag_val);                                   \
+            /* Carry is the bit shifted out: MSB for left shift, LSB for right shift */              \
+            static const uint256_t mask = ((uint256_t(1U) << 255) | 1U) op_shift 255;               \
+            bool new_flag_val = !(op2 & mask).is_zero();                                            \
+            model->SetCpuFlag(CpuFlagType::CARRY, new_flag_val);                                    \
         }                                                                                           \
-        model_->SetGpr(TO_INT(op1_), tmp);                                                          \
+        model->SetGpr(TO_INT(op1_), tmp);                                                           \
                                                                                                     \
-        PUT_FLAG_TO_CHANGE(ch_cf, new_val, model_->GetCpuFlag(CpuFlagType::CARRY));                 \
-        PUT_GPR_TO_CHANGE(ch_gpr, new_val, model_->GetGpr(TO_INT(op1_)));                           \
-        model_->ReportChange(ch_gpr);                                                               \
+        PUT_FLAG_TO_CHANGE(ch_cf, new_val, model->GetCpuFlag(CpuFlagType::CARRY));                  \
+        PUT_GPR_TO_CHANGE(ch_gpr, new_val, model->GetGpr(TO_INT(op1_)));                            \
+        model->ReportChange(ch_gpr);                                                                \
         if (set_carry)                                                                              \
-            model_->ReportChange(ch_cf);                                                            \
+            model->ReportChange(ch_cf);                                                             \
                                                                                                     \
         return true;                                                                                \
     }
@@ -318,96 +322,90 @@ IMPLEMENT_R_32_SHIFT_OP(V2InstructionROLIN,   <<, >>, 8, false, true,  false)
 IMPLEMENT_R_32_SHIFT_OP(V2InstructionRORIN,   >>, <<, 8, false, true,  false)
 
 
-bool spect::V2InstructionSWE::Execute()
+bool spect::V2InstructionSWE::Execute(CpuModel *model)
 {
     DEFINE_CHANGE(ch_gpr, DPI_CHANGE_GPR, TO_INT(op1_));
 
-    PUT_GPR_TO_CHANGE(ch_gpr, old_val, model_->GetGpr(TO_INT(op1_)));
+    PUT_GPR_TO_CHANGE(ch_gpr, old_val, model->GetGpr(TO_INT(op1_)));
 
-    uint256_t result = uint256_t("0x0");
+    // Swap endianity: Reverse order of limbs and bytes within each limb
+    uint256_t result;
+    const auto &src = model->GetGpr(TO_INT(op2_)).crepresentation();
+    auto &dst = result.representation();
+    for (size_t i = 0; i < src.size(); i++)
+        dst[src.size() - 1 - i] = __builtin_bswap32(src[i]);
 
-    for (int i = 0; i < 32; i++) {
-        uint256_t mask = uint256_t("0xFF");
-        mask = (mask << (8 * i));
-        uint256_t tmp = model_->GetGpr(TO_INT(op2_)) & mask;
-        if (i < 16)
-            tmp = tmp << ((31 - 2 * i) * 8);
-        else
-            tmp = tmp >> ((i - 15) * 16 - 8);
-        result = result | tmp;
-    }
-
-    model_->SetGpr(TO_INT(op1_), result);
+    model->SetGpr(TO_INT(op1_), result);
 
-    PUT_GPR_TO_CHANGE(ch_gpr, new_val, model_->GetGpr(TO_INT(op1_)));
-    model_->ReportChange(ch_gpr);
+    PUT_GPR_TO_CHANGE(ch_gpr, new_val, model->GetGpr(TO_INT(op1_)));
+    model->ReportChange(ch_gpr);
 
     return true;
 }
 
-bool spect::V2InstructionMOV::Execute()
+bool spect::V2InstructionMOV::Execute(CpuModel *model)
 {
     DEFINE_CHANGE(ch_gpr, DPI_CHANGE_GPR, TO_INT(op1_));
-    PUT_GPR_TO_CHANGE(ch_gpr, old_val, model_->GetGpr(TO_INT(op1_)));
+    PUT_GPR_TO_CHANGE(ch_gpr, old_val, model->GetGpr(TO_INT(op1_)));
 
-    model_->SetGpr(TO_INT(op1_), model_->GetGpr(TO_INT(op2_)));
+    model->SetGpr(TO_INT(op1_), model->GetGpr(TO_INT(op2_)));
 
-    PUT_GPR_TO_CHANGE(ch_gpr, new_val, model_->GetGpr(TO_INT(op1_)));
-    model_->ReportChange(ch_gpr);
+    PUT_GPR_TO_CHANGE(ch_gpr, new_val, model->GetGpr(TO_INT(op1_)));
+    model->ReportChange(ch_gpr);
 
     return true;
 }
 
-bool spect::V2InstructionLDR::Execute()
+bool spect::V2InstructionLDR::Execute(CpuModel *model)
 {
     DEFINE_CHANGE(ch_gpr, DPI_CHANGE_GPR, TO_INT(op1_));
-    PUT_GPR_TO_CHANGE(ch_gpr, old_val, model_->GetGpr(TO_INT(op1_)));
+    PUT_GPR_TO_CHANGE(ch_gpr, old_val, model->GetGpr(TO_INT(op1_)));
 
-    uint16_t  addr = static_cast<uint16_t>(model_->GetGpr(TO_INT(op2_)));
+    uint16_t  addr = static_cast<uint16_t>(model->GetGpr(TO_INT(op2_)));
     uint256_t tmp  = 0;
     for (int i = 0; i < 8; i++) {
-        uint32_t buf = model_->ReadMemoryCoreData(addr + (4 * i));
+        uint32_t buf = model->ReadMemoryCoreData(addr + (4 * i));
         tmp = (uint256_t(buf) << (i * 32)) | tmp;
     }
-    model_->SetGpr(TO_INT(op1_), tmp);
+    model->SetGpr(TO_INT(op1_), tmp);
 
-    PUT_GPR_TO_CHANGE(ch_gpr, new_val, model_->GetGpr(TO_INT(op1_)));
-    model_->ReportChange(ch_gpr);
+    PUT_GPR_TO_CHANGE(ch_gpr, new_val, model->GetGpr(TO_INT(op1_)));
+    model->ReportChange(ch_gpr);
 
     return true;
 }
 
-bool spect::V2InstructionSTR::Execute()
+bool spect::V2InstructionSTR::Execute(CpuModel *model)
 {
-    uint16_t  addr = static_cast<uint16_t>(model_->GetGpr(TO_INT(op2_)));
-    uint256_t tmp  = model_->GetGpr(TO_INT(op1_));
+    uint16_t  addr = static_cast<uint16_t>(model->GetGpr(TO_INT(op2_)));
+    uint256_t tmp  = model->GetGpr(TO_INT(op1_));
     for (int i = 0; i < 8; i++) {
-        model_->WriteMemoryCoreData(addr + (i * 4),
-                    static_cast<uint32_t>(tmp & uint256_t("0xFFFFFFFF")));
+        model->WriteMemoryCoreData(addr + (i * 4),
+                    static_cast<uint32_t>(tmp));
         tmp = tmp >> 32;
     }
     return true;
 }
 
 #define IMPLEMENT_SWAP_OP(classname, flag_name)                                                 \
-    bool spect::classname::Execute()                                                            \
+    bool spect::classname::Execute(CpuModel *model)                                             \
     {                                                                                           \
         DEFINE_CHANGE(ch_gpr_1, DPI_CHANGE_GPR, TO_INT(op1_));                                  \
         DEFINE_CHANGE(ch_gpr_2, DPI_CHANGE_GPR, TO_INT(op2_));                                  \
                                                                                                 \
-        PUT_GPR_TO_CHANGE(ch_gpr_1, old_val, model_->GetGpr(TO_INT(op1_)));                     \
-        PUT_GPR_TO_CHANGE(ch_gpr_2, old_val, model_->GetGpr(TO_INT(op2_)));                     \
+        PUT_GPR_TO_CHANGE(ch_gpr_1, old_val, model->GetGpr(TO_INT(op1_)));                      \
+        PUT_GPR_TO_CHANGE(ch_gpr_2, old_val, model->GetGpr(TO_INT(op2_)));                      \
                                                                                                 \
-        if (model_->GetCpuFlags().flag_name){                                                   \
-            uint256_t tmp = model_->GetGpr(TO_INT(op2_));                                       \
-            model_->SetGpr(TO_INT(op2_), model_->GetGpr(TO_INT(op1_)));                         \
-            model_->SetGpr(TO_INT(op1_), tmp);                                                  \
+        if (model->GetCpuFlags().flag_name){                                                    \
+            uint256_t tmp = model->GetGpr(TO_INT(op2_));                                        \
+            model->SetGpr(TO_INT(op2_), model->GetGpr(TO_INT(op1_)));                           \
+            model->SetGpr(TO_INT(op1_), tmp);                                                   \
         }                                                                                       \
                                                                                                 \
-        PUT_GPR_TO_CHANGE(ch_gpr_1, new_val, model_->GetGpr(TO_INT(op1_)));                     \
-        PUT_GPR_TO_CHANGE(ch_gpr_2, new_val, model_->GetGpr(TO_INT(op2_)));                     \
-        model_->ReportChange(ch_gpr_1);                                                         \
-        model_->ReportChange(ch_gpr_2);                                                         \
+        PUT_GPR_TO_CHANGE(ch_gpr_1, new_val, model->GetGpr(TO_INT(op1_)));                      \
+        PUT_GPR_TO_CHANGE(ch_gpr_2, new_val, model->GetGpr(TO_INT(op2_)));                      \
+        model->ReportChange(ch_gpr_1);                                                          \
+        model->ReportChange(ch_gpr_2);                                                          \
                                                                                                 \
         return true;                                                                            \
     }
@@ -416,160 +414,182 @@ IMPLEMENT_SWAP_OP(V2InstructionCSWAP, carry)
 IMPLEMENT_SWAP_OP(V2InstructionZSWAP, zero)
 
 
-bool spect::V2InstructionHASH::Execute()
+bool spect::V2InstructionHASH::Execute(CpuModel *model)
 {
     DEFINE_CHANGE(ch_gpr_1, DPI_CHANGE_GPR, TO_INT(op1_));
     DEFINE_CHANGE(ch_gpr_2, DPI_CHANGE_GPR, (TO_INT(op1_) + 1) % 32);
 
-    PUT_GPR_TO_CHANGE(ch_gpr_1, old_val, model_->GetGpr(TO_INT(op1_)));
-    PUT_GPR_TO_CHANGE(ch_gpr_2, old_val, model_->GetGpr((TO_INT(op1_) + 1) % 32));
+    PUT_GPR_TO_CHANGE(ch_gpr_1, old_val, model->GetGpr(TO_INT(op1_)));
+    PUT_GPR_TO_CHANGE(ch_gpr_2, old_val, model->GetGpr((TO_INT(op1_) + 1) % 32));
 
     // Convert registers op2_ .. op2_+3 to input message (must be character stream)
     unsigned char msg[128];
     for (int i = 3; i >= 0; i--) {
-        uint256_t tmp = model_->GetGpr((TO_INT(op2_) + i) % 32);
+        uint256_t tmp = model->GetGpr((TO_INT(op2_) + i) % 32);
         for (int j = 0; j < 32; j++) {
-            uint8_t byte = (uint8_t)((tmp >> (248 - (j * 8))) & uint256_t("0xFF"));
+            uint8_t byte = (uint8_t)((tmp >> (248 - (j * 8))) & 0xFFU);
             msg[((3 - i) * 32) + j] = byte;
         }
     }
 
     // Print Message
-    model_->DebugInfo(VERBOSITY_HIGH, "Hash input message:");
-    std::stringstream ss;
-    ss << std::hex << std::setw(2);
-    for (int i = 0; i < 128; i++)
-        ss << (int)msg[i] << " ";
-    model_->DebugInfo(VERBOSITY_HIGH, ss.str().c_str());
-    model_->DebugInfo(VERBOSITY_HIGH, "");
+    if (DEBUG_ENABLED(model, VERBOSITY_HIGH)) {
+        DEBUG_INFO(model, VERBOSITY_HIGH, "Hash input message:");
+        std::stringstream ss;
+        ss << std::hex << std::setw(2);
+        for (int i = 0; i < 128; i++)
+            ss << (int)msg[i] << " ";
+        DEBUG_INFO(model, VERBOSITY_HIGH, ss.str().c_str());
+        DEBUG_INFO(model, VERBOSITY_HIGH, "");
+    }
 
     // Print context before, calculate, Print context after
-    model_->DebugInfo(VERBOSITY_HIGH, "Hash context (before):");
-    model_->PrintHashContext(VERBOSITY_HIGH);
-    model_->DebugInfo(VERBOSITY_HIGH, "");
+    DEBUG_INFO(model, VERBOSITY_HIGH, "Hash context (before):");
+    model->PrintHashContext(VERBOSITY_HIGH);
+    DEBUG_INFO(model, VERBOSITY_HIGH, "");
 
-    model_->sha_512_.update((unsigned char*)msg, 128);
+    model->sha_512_.update((unsigned char*)msg, 128);
 
-    model_->DebugInfo(VERBOSITY_HIGH, "Hash context (after):");
-    model_->PrintHashContext(VERBOSITY_HIGH);
-    model_->DebugInfo(VERBOSITY_HIGH, "");
+    DEBUG_INFO(model, VERBOSITY_HIGH, "Hash context (after):");
+    model->PrintHashContext(VERBOSITY_HIGH);
+    DEBUG_INFO(model, VERBOSITY_HIGH, "");
 
     // Put current HASH context to op1_, op1_+1
     for (int i = 0; i < 2; i++) {
         uint256_t reg = uint256_t(0);
 
         for (int j = 0; j < 4; j++) {
-            unsigned long long ctx = model_->sha_512_.getContext((i * 4) + j);
+            unsigned long long ctx = model->sha_512_.getContext((i * 4) + j);
             reg = reg | uint256_t(ctx);
             if (j < 3)
                 reg = reg << 64;
         }
 
-        model_->SetGpr((TO_INT(op1_) + (1 - i)) % 32, reg);
+        model->SetGpr((TO_INT(op1_) + (1 - i)) % 32, reg);
     }
 
-    PUT_GPR_TO_CHANGE(ch_gpr_1, new_val, model_->GetGpr(TO_INT(op1_)));
-    PUT_GPR_TO_CHANGE(ch_gpr_2, new_val, model_->GetGpr((TO_INT(op1_) + 1) % 32));
-    model_->ReportChange(ch_gpr_1);
-    model_->ReportChange(ch_gpr_2);
+    PUT_GPR_TO_CHANGE(ch_gpr_1, new_val, model->GetGpr(TO_INT(op1_)));
+    PUT_GPR_TO_CHANGE(ch_gpr_2, new_val, model->GetGpr((TO_INT(op1_) + 1) % 32));
+    model->ReportChange(ch_gpr_1);
+    model->ReportChange(ch_gpr_2);
 
     return true;
 }
 
-bool spect::V2InstructionGRV::Execute()
+bool spect::V2InstructionGRV::Execute(CpuModel *model)
 {
     DEFINE_CHANGE(ch_gpr, DPI_CHANGE_GPR, TO_INT(op1_));
-    PUT_GPR_TO_CHANGE(ch_gpr, old_val, model_->GetGpr(TO_INT(op1_)));
+    PUT_GPR_TO_CHANGE(ch_gpr, old_val, model->GetGpr(TO_INT(op1_)));
 
     uint256_t tmp = 0;
     for (int i = 0; i < 8; i++) {
         DEFINE_CHANGE(ch_rbus, DPI_CHANGE_RBUS, (i == 0) ? DPI_RBUS_FRESH_ENT : DPI_RBUS_NO_FRESH_ENT);
 
-        uint256_t part = model_->GrvQueuePop();
+        uint256_t part = model->GrvQueuePop();
         part = part << (32 * i);
         tmp = tmp | part;
 
-        model_->ReportChange(ch_rbus);
+        model->ReportChange(ch_rbus);
     }
 
-    model_->SetGpr(TO_INT(op1_), tmp);
+    model->SetGpr(TO_INT(op1_), tmp);
 
-    PUT_GPR_TO_CHANGE(ch_gpr, new_val, model_->GetGpr(TO_INT(op1_)));
-    model_->ReportChange(ch_gpr);
+    PUT_GPR_TO_CHANGE(ch_gpr, new_val, model->GetGpr(TO_INT(op1_)));
+    model->ReportChange(ch_gpr);
 
     return true;
 }
 
-bool spect::V2InstructionSCB::Execute()
+bool spect::V2InstructionSCB::Execute(CpuModel *model)
 {
     DEFINE_CHANGE(ch_gpr_1, DPI_CHANGE_GPR, TO_INT(op1_));
     DEFINE_CHANGE(ch_gpr_2, DPI_CHANGE_GPR, (TO_INT(op1_) + 1) % 32);
 
-    if (model_->change_reporting_){
-        PUT_GPR_TO_CHANGE(ch_gpr_1, old_val, model_->GetGpr(TO_INT(op1_)));
-        PUT_GPR_TO_CHANGE(ch_gpr_2, old_val, model_->GetGpr((TO_INT(op1_) + 1) % 32));
+    if (model->change_reporting_){
+        PUT_GPR_TO_CHANGE(ch_gpr_1, old_val, model->GetGpr(TO_INT(op1_)));
+        PUT_GPR_TO_CHANGE(ch_gpr_2, old_val, model->GetGpr((TO_INT(op1_) + 1) % 32));
     }
 
-    uint512_t tmp = model_->GetGpr(TO_INT(op3_));
-    std::string mask = "0x80000000"; // 2 ^ 255
-    mask += "80000000";              // 2 ^ 223
-    mask += std::string(48, '0');    // Remaining 48 * 4 zeroes.
-    tmp = tmp | uint512_t(mask.c_str());
-    tmp = tmp * uint512_t(model_->GetGpr(TO_INT(CpuGpr::R31)));
-    tmp = tmp + uint512_t(model_->GetGpr(TO_INT(op2_)));
+    uint512_t tmp = model->GetGpr(TO_INT(op3_));
+    tmp = tmp | scb_mask;
+    tmp = tmp * uint512_t(model->GetGpr(TO_INT(CpuGpr::R31)));
+    tmp = tmp + uint512_t(model->GetGpr(TO_INT(op2_)));
 
     // TODO: Check implicit conversion takes LSBS!
-    model_->SetGpr(TO_INT(op1_), tmp);
-    model_->SetGpr((TO_INT(op1_) + 1) % 32, (tmp >> 256));
+    model->SetGpr(TO_INT(op1_), tmp);
+    model->SetGpr((TO_INT(op1_) + 1) % 32, (tmp >> 256));
 
-    PUT_GPR_TO_CHANGE(ch_gpr_1, new_val, model_->GetGpr(TO_INT(op1_)));
-    PUT_GPR_TO_CHANGE(ch_gpr_2, new_val, model_->GetGpr((TO_INT(op1_) + 1) % 32));
-    model_->ReportChange(ch_gpr_1);
-    model_->ReportChange(ch_gpr_2);
+    PUT_GPR_TO_CHANGE(ch_gpr_1, new_val, model->GetGpr(TO_INT(op1_)));
+    PUT_GPR_TO_CHANGE(ch_gpr_2, new_val, model->GetGpr((TO_INT(op1_) + 1) % 32));
+    model->ReportChange(ch_gpr_1);
+    model->ReportChange(ch_gpr_2);
 
     return true;
 }
 
-#define IMPLEMENT_MODULAR_OP(classname,operation, mod_num, check_ops)                           \
-    bool spect::classname::Execute()                                                            \
+#define IMPLEMENT_FIXED_PRIME_MUL_OP(classname, mul_fnc, prime)                                 \
+    bool spect::classname::Execute(CpuModel *model)                                             \
+    {                                                                                           \
+        InstructionR::Execute(model);                                                           \
+                                                                                                \
+        check_modulo_conds(model, this, prime);                                                 \
+                                                                                                \
+        DEFINE_CHANGE(ch_gpr, DPI_CHANGE_GPR, TO_INT(op1_));                                    \
+        PUT_GPR_TO_CHANGE(ch_gpr, old_val, model->GetGpr(TO_INT(op1_)));                        \
+                                                                                                \
+        /* Dedicated reduction for fixed prime, no generic 512 bit division */                  \
+        model->SetGpr(TO_INT(op1_),                                                             \
+                       ModularReduction::mul_fnc(model->GetGpr(TO_INT(op2_)),                   \
+                                                 model->GetGpr(TO_INT(op3_))));                 \
+                                                                                                \
+        PUT_GPR_TO_CHANGE(ch_gpr, new_val, model->GetGpr(TO_INT(op1_)));                        \
+        model->ReportChange(ch_gpr);                                                            \
+                                                                                                \
+        return true;                                                                            \
+    }
+
+IMPLEMENT_FIXED_PRIME_MUL_OP(V2InstructionMUL25519, MulModP25519, p_25519)
+IMPLEMENT_FIXED_PRIME_MUL_OP(V2InstructionMUL256,   MulModP256,   p_256)
+
+#define IMPLEMENT_MODULAR_OP(classname,operation, check_ops)                                    \
+    bool spect::classname::Execute(CpuModel *model)                                             \
     {                                                                                           \
-        InstructionR::Execute();                                                                \
+        InstructionR::Execute(model);                                                           \
                                                                                                 \
         if (check_ops)                                                                          \
-            check_modulo_conds(model_, this, mod_num);                                          \
+            check_modulo_conds(model, this, model->GetGpr(TO_INT(CpuGpr::R31)));                \
                                                                                                 \
         DEFINE_CHANGE(ch_gpr, DPI_CHANGE_GPR, TO_INT(op1_));                                    \
-        PUT_GPR_TO_CHANGE(ch_gpr, old_val, model_->GetGpr(TO_INT(op1_)));                       \
+        PUT_GPR_TO_CHANGE(ch_gpr, old_val, model->GetGpr(TO_INT(op1_)));                        \
                                                                                                 \
-        uint512_t op2 = (int512_t)model_->GetGpr(TO_INT(op2_));                                 \
-        uint512_t op3 = (int512_t)model_->GetGpr(TO_INT(op3_));                                 \
-        uint512_t tmp = operation;                                                              \
-        model_->SetGpr(TO_INT(op1_), (uint256_t)(tmp % ((uint512_t)mod_num)));                  \
+        /* R31 reduction context is cached by model, re-computed only when R31 changes */       \
+        const ModularReduction &red = model->GetR31Reduction();                                 \
+        const uint256_t &op2 = model->GetGpr(TO_INT(op2_));                                     \
+        const uint256_t &op3 = model->GetGpr(TO_INT(op3_));                                     \
+        model->SetGpr(TO_INT(op1_), operation);                                                 \
                                                                                                 \
-        PUT_GPR_TO_CHANGE(ch_gpr, new_val, model_->GetGpr(TO_INT(op1_)));                       \
-        model_->ReportChange(ch_gpr);                                                           \
+        PUT_GPR_TO_CHANGE(ch_gpr, new_val, model->GetGpr(TO_INT(op1_)));                        \
+        model->ReportChange(ch_gpr);                                                            \
                                                                                                 \
         return true;                                                                            \
     }
 
-IMPLEMENT_MODULAR_OP(V2InstructionMUL25519, (op2 * op3),          get_p_25519()                          ,true)
-IMPLEMENT_MODULAR_OP(V2InstructionMUL256,   (op2 * op3),          get_p_256()                            ,true)
-IMPLEMENT_MODULAR_OP(V2InstructionADDP,     (op2 + op3),          model_->GetGpr(TO_INT(CpuGpr::R31))    ,true)
-IMPLEMENT_MODULAR_OP(V2InstructionMULP,     (op2 * op3),          model_->GetGpr(TO_INT(CpuGpr::R31))    ,false)
-IMPLEMENT_MODULAR_OP(V2InstructionREDP,    ((op2 << 256) | op3),  model_->GetGpr(TO_INT(CpuGpr::R31))    ,false)
+IMPLEMENT_MODULAR_OP(V2InstructionADDP,     red.Reduce(uint512_t(op2) + uint512_t(op3)),                true)
+IMPLEMENT_MODULAR_OP(V2InstructionMULP,     red.MulMod(op2, op3),                                      false)
+IMPLEMENT_MODULAR_OP(V2InstructionREDP,     red.Reduce((uint512_t(op2) << 256) | uint512_t(op3)),       false)
 
 
-bool spect::V2InstructionSUBP::Execute()
+bool spect::V2InstructionSUBP::Execute(CpuModel *model)
 {
-    InstructionR::Execute();
+    InstructionR::Execute(model);
 
     DEFINE_CHANGE(ch_gpr, DPI_CHANGE_GPR, TO_INT(op1_));
-    PUT_GPR_TO_CHANGE(ch_gpr, old_val, model_->GetGpr(TO_INT(op1_)));
+    PUT_GPR_TO_CHANGE(ch_gpr, old_val, model->GetGpr(TO_INT(op1_)));
 
-    uint512_t op2 = (uint512_t)model_->GetGpr(TO_INT(op2_));
-    uint512_t op3 = (uint512_t)model_->GetGpr(TO_INT(op3_));
-    uint256_t prime = model_->GetGpr(TO_INT(CpuGpr::R31));
-    check_modulo_conds(model_, this, prime);
+    uint512_t op2 = (uint512_t)model->GetGpr(TO_INT(op2_));
+    uint512_t op3 = (uint512_t)model->GetGpr(TO_INT(op3_));
+    uint256_t prime = model->GetGpr(TO_INT(CpuGpr::R31));
+    check_modulo_conds(model, this, prime);
 
     ///////////////////////////////////////////////////////////////////////////////////////////////
     // uint_wide_t screws up modulo negative number, we do dirty trick where we add the
@@ -581,79 +601,83 @@ bool spect::V2InstructionSUBP::Execute()
     if (op3 > op2)
         lhs += (uint512_t)prime;
     uint512_t tmp = lhs - op3;
-    model_->SetGpr(TO_INT(op1_), (uint256_t)(tmp % ((uint512_t)prime)));
+    model->SetGpr(TO_INT(op1_), model->GetR31Reduction().Reduce(tmp));
 
-    PUT_GPR_TO_CHANGE(ch_gpr, new_val, model_->GetGpr(TO_INT(op1_)));
-    model_->ReportChange(ch_gpr);
+    PUT_GPR_TO_CHANGE(ch_gpr, new_val, model->GetGpr(TO_INT(op1_)));
+    model->ReportChange(ch_gpr);
 
     return true;
 }
 
-bool spect::V2InstructionTMAC_IT::Execute()
+bool spect::V2InstructionTMAC_IT::Execute(CpuModel *model)
 {
     // Initialize Keccak
-    if (KeccakWidth400_SpongeInitialize(&(model_->keccak_inst_), KECCAK_RATE, KECCAK_CAPACITY) != 0) {
+    if (KeccakWidth400_SpongeInitialize(&(model->keccak_inst_), KECCAK_RATE, KECCAK_CAPACITY) != 0) {
         std::stringstream ss;
         ss << "Error: Calling KeccakWidth400_SpongeInitialize() failed.";
-        model_->DebugInfo(VERBOSITY_NONE, ss.str().c_str());
+        DEBUG_INFO(model, VERBOSITY_NONE, ss.str().c_str());
     }
 
     return true;
 }
 
-bool spect::V2InstructionTMAC_UP::Execute()
+bool spect::V2InstructionTMAC_UP::Execute(CpuModel *model)
 {
     unsigned char msg[KECCAK_RATE/8];
     std::stringstream ss;
 
     // Convert register op2_ to input message (must be character stream)
-    uint256_t tmp = model_->GetGpr(TO_INT(op2_));
+    uint256_t tmp = model->GetGpr(TO_INT(op2_));
     for (int i = 0; i < KECCAK_RATE/8; i++) {
-        msg[i] = (uint8_t)((tmp >> (136 - (i * 8))) & uint256_t("0xFF"));
+        msg[i] = (uint8_t)((tmp >> (136 - (i * 8))) & 0xFFU);
     }
 
     // Print Message
-    model_->DebugInfo(VERBOSITY_HIGH, "Keccak input message:");
-    ss << std::hex << std::setw(2);
-    for (int i = 0; i < KECCAK_RATE/8; i++)
-        ss << (int)msg[i] << " ";
-    model_->DebugInfo(VERBOSITY_HIGH, ss.str().c_str());
-    model_->DebugInfo(VERBOSITY_HIGH, "");
+    if (DEBUG_ENABLED(model, VERBOSITY_HIGH)) {
+        DEBUG_INFO(model, VERBOSITY_HIGH, "Keccak input message:");
+        ss << std::hex << std::setw(2);
+        for (int i = 0; i < KECCAK_RATE/8; i++)
+            ss << (int)msg[i] << " ";
+        DEBUG_INFO(model, VERBOSITY_HIGH, ss.str().c_str());
+        DEBUG_INFO(model, VERBOSITY_HIGH, "");
+    }
     ss.str("");
 
     // Process by Keccak
-    if (KeccakWidth400_SpongeAbsorb(&(model_->keccak_inst_), (unsigned char *)msg, KECCAK_RATE/8) != 0) {
+    if (KeccakWidth400_SpongeAbsorb(&(model->keccak_inst_), (unsigned char *)msg, KECCAK_RATE/8) != 0) {
         ss << "Error: Calling KeccakWidth400_SpongeAbsorb() failed.";
-        model_->DebugInfo(VERBOSITY_NONE, ss.str().c_str());
+        DEBUG_INFO(model, VERBOSITY_NONE, ss.str().c_str());
     }
 
     return true;
 }
 
-bool spect::V2InstructionTMAC_RD::Execute()
+bool spect::V2InstructionTMAC_RD::Execute(CpuModel *model)
 {
     unsigned char msg[KECCAK_CAPACITY/8];
     std::stringstream ss;
 
     DEFINE_CHANGE(ch_gpr, DPI_CHANGE_GPR, TO_INT(op1_));
-    PUT_GPR_TO_CHANGE(ch_gpr, old_val, model_->GetGpr(TO_INT(op1_)));
+    PUT_GPR_TO_CHANGE(ch_gpr, old_val, model->GetGpr(TO_INT(op1_)));
 
     // Move to squeezing phase
-    model_->keccak_inst_.squeezing = 1;
+    model->keccak_inst_.squeezing = 1;
 
     // Get Keccak output
-    if (KeccakWidth400_SpongeSqueeze(&(model_->keccak_inst_), (unsigned char *)msg, KECCAK_CAPACITY/8) != 0) {
+    if (KeccakWidth400_SpongeSqueeze(&(model->keccak_inst_), (unsigned char *)msg, KECCAK_CAPACITY/8) != 0) {
         ss << "Error: Calling KeccakWidth400_SpongeSqueeze() failed.";
-        model_->DebugInfo(VERBOSITY_NONE, ss.str().c_str());
+        DEBUG_INFO(model, VERBOSITY_NONE, ss.str().c_str());
     }
 
     // Print Message
-    model_->DebugInfo(VERBOSITY_HIGH, "Keccak output message:");
-    ss << std::hex << std::setw(2);
-    for (int i = 0; i < KECCAK_CAPACITY/8; i++)
-        ss << (int)msg[i] << " ";
-    model_->DebugInfo(VERBOSITY_HIGH, ss.str().c_str());
-    model_->DebugInfo(VERBOSITY_HIGH, "");
+    if (DEBUG_ENABLED(model, VERBOSITY_HIGH)) {
+        DEBUG_INFO(model, VERBOSITY_HIGH, "Keccak output message:");
+        ss << std::hex << std::setw(2);
+        for (int i = 0; i < KECCAK_CAPACITY/8; i++)
+            ss << (int)msg[i] << " ";
+        DEBUG_INFO(model, VERBOSITY_HIGH, ss.str().c_str());
+        DEBUG_INFO(model, VERBOSITY_HIGH, "");
+    }
 
     // Convert output message to register op1_
     uint256_t reg = uint256_t(0);
@@ -662,10 +686,10 @@ bool spect::V2InstructionTMAC_RD::Execute()
         reg = reg | (tmp << (248 - (i * 8)));
     }
 
-    model_->SetGpr(TO_INT(op1_), reg);
+    model->SetGpr(TO_INT(op1_), reg);
 
-    PUT_GPR_TO_CHANGE(ch_gpr, new_val, model_->GetGpr(TO_INT(op1_)));
-    model_->ReportChange(ch_gpr);
+    PUT_GPR_TO_CHANGE(ch_gpr, new_val, model->GetGpr(TO_INT(op1_)));
+    model->ReportChange(ch_gpr);
 
     return true;
 }
@@ -676,25 +700,25 @@ bool spect::V2InstructionTMAC_RD::Execute()
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 #define IMPLEMENT_I_32_AIRTH_OP(classname,operand,store_res)                                    \
-    bool spect::classname::Execute()                                                            \
+    bool spect::classname::Execute(CpuModel *model)                                             \
     {                                                                                           \
         DEFINE_CHANGE(ch_gpr, DPI_CHANGE_GPR, TO_INT(op1_));                                    \
         DEFINE_CHANGE(ch_zf, DPI_CHANGE_FLAG, DPI_SPECT_FLAG_ZERO);                             \
                                                                                                 \
-        PUT_FLAG_TO_CHANGE(ch_zf, old_val, model_->GetCpuFlag(CpuFlagType::ZERO));              \
-        PUT_GPR_TO_CHANGE(ch_gpr, old_val, model_->GetGpr(TO_INT(op1_)));                       \
+        PUT_FLAG_TO_CHANGE(ch_zf, old_val, model->GetCpuFlag(CpuFlagType::ZERO));               \
+        PUT_GPR_TO_CHANGE(ch_gpr, old_val, model->GetGpr(TO_INT(op1_)));                        \
                                                                                                 \
-        const uint256_t& tmp = model_->GetGpr(TO_INT(op2_)) operand uint256_t(immediate_);      \
-        uint256_t mask = tmp & uint256_t("0xFFFFFFFF");                                         \
+        const uint256_t& tmp = model->GetGpr(TO_INT(op2_)) operand uint256_t(immediate_);       \
+        uint256_t mask = mask_n_lsb_digits(tmp, 8);                                             \
         if (store_res)                                                                          \
-            model_->SetGpr(TO_INT(op1_), mask);                                                 \
-        model_->SetCpuFlag(CpuFlagType::ZERO, is_32_lsb_bits_zero(mask));                       \
+            model->SetGpr(TO_INT(op1_), mask);                                                  \
+        model->SetCpuFlag(CpuFlagType::ZERO, is_32_lsb_bits_zero(mask));                        \
                                                                                                 \
-        PUT_FLAG_TO_CHANGE(ch_zf, new_val, model_->GetCpuFlag(CpuFlagType::ZERO));              \
-        PUT_GPR_TO_CHANGE(ch_gpr, new_val, model_->GetGpr(TO_INT(op1_)));                       \
+        PUT_FLAG_TO_CHANGE(ch_zf, new_val, model->GetCpuFlag(CpuFlagType::ZERO));               \
+        PUT_GPR_TO_CHANGE(ch_gpr, new_val, model->GetGpr(TO_INT(op1_)));                        \
         if (store_res)                                                                          \
-            model_->ReportChange(ch_gpr);                                                       \
-        model_->ReportChange(ch_zf);                                                            \
+            model->ReportChange(ch_gpr);                                                        \
+        model->ReportChange(ch_zf);                                                             \
                                                                                                 \
         return true;                                                                            \
     }
@@ -705,29 +729,29 @@ IMPLEMENT_I_32_AIRTH_OP(V2InstructionCMPI,-,false)
 
 
 #define IMPLEMENT_I_LOGIC_OP(classname,operand)                                              \
-    bool spect::classname::Execute()                                                            \
+    bool spect::classname::Execute(CpuModel *model)                                             \
     {                                                                                           \
         DEFINE_CHANGE(ch_gpr, DPI_CHANGE_GPR, TO_INT(op1_));                                    \
         DEFINE_CHANGE(ch_zf, DPI_CHANGE_FLAG, DPI_SPECT_FLAG_ZERO);                             \
                                                                                                 \
-        PUT_FLAG_TO_CHANGE(ch_zf, old_val, model_->GetCpuFlag(CpuFlagType::ZERO));              \
-        PUT_GPR_TO_CHANGE(ch_gpr, old_val, model_->GetGpr(TO_INT(op1_)));                       \
+        PUT_FLAG_TO_CHANGE(ch_zf, old_val, model->GetCpuFlag(CpuFlagType::ZERO));               \
+        PUT_GPR_TO_CHANGE(ch_gpr, old_val, model->GetGpr(TO_INT(op1_)));                        \
                                                                                                 \
-        model_->SetGpr( TO_INT(op1_),                                                           \
-            binary_logic_op_lsb(model_->GetGpr(TO_INT(op2_)),                                   \
+        model->SetGpr( TO_INT(op1_),                                                            \
+            binary_logic_op_lsb(model->GetGpr(TO_INT(op2_)),                                    \
                                 uint256_t(immediate_),                                          \
                                 3,                                                              \
                 [] (const uint256_t &lhs, const uint256_t &rhs) -> uint256_t {                  \
                     return lhs operand rhs;                                                     \
                 }                                                                               \
             ));                                                                                 \
-        bool new_flag_val = (model_->GetGpr(TO_INT(op1_)) == uint256_t("0x0"));                 \
-        model_->SetCpuFlag(CpuFlagType::ZERO, new_flag_val);                                    \
+        bool new_flag_val = model->GetGpr(TO_INT(op1_)).is_zero();                              \
+        model->SetCpuFlag(CpuFlagType::ZERO, new_flag_val);                                     \
                                                                                                 \
-        PUT_FLAG_TO_CHANGE(ch_zf, new_val, model_->GetCpuFlag(CpuFlagType::ZERO));              \
-        PUT_GPR_TO_CHANGE(ch_gpr, new_val, model_->GetGpr(TO_INT(op1_)));                       \
-        model_->ReportChange(ch_gpr);                                                           \
-        model_->ReportChange(ch_zf);                                                            \
+        PUT_FLAG_TO_CHANGE(ch_zf, new_val, model->GetCpuFlag(CpuFlagType::ZERO));               \
+        PUT_GPR_TO_CHANGE(ch_gpr, new_val, model->GetGpr(TO_INT(op1_)));                        \
+        model->ReportChange(ch_gpr);                                                            \
+        model->ReportChange(ch_zf);                                                             \
                                                                                                 \
         return true;                                                                            \
     }
@@ -736,26 +760,26 @@ IMPLEMENT_I_LOGIC_OP(V2InstructionANDI,&)
 IMPLEMENT_I_LOGIC_OP(V2InstructionORI,|)
 IMPLEMENT_I_LOGIC_OP(V2InstructionXORI,^)
 
-bool spect::V2InstructionMOVI::Execute()
+bool spect::V2InstructionMOVI::Execute(CpuModel *model)
 {
     DEFINE_CHANGE(ch_gpr, DPI_CHANGE_GPR, TO_INT(op1_));
-    PUT_GPR_TO_CHANGE(ch_gpr, old_val, model_->GetGpr(TO_INT(op1_)));
+    PUT_GPR_TO_CHANGE(ch_gpr, old_val, model->GetGpr(TO_INT(op1_)));
 
-    model_->SetGpr(TO_INT(op1_), uint256_t(immediate_));
+    model->SetGpr(TO_INT(op1_), uint256_t(immediate_));
 
-    PUT_GPR_TO_CHANGE(ch_gpr, new_val, model_->GetGpr(TO_INT(op1_)));
-    model_->ReportChange(ch_gpr);
+    PUT_GPR_TO_CHANGE(ch_gpr, new_val, model->GetGpr(TO_INT(op1_)));
+    model->ReportChange(ch_gpr);
 
     return true;
 }
 
-bool spect::V2InstructionHASH_IT::Execute()
+bool spect::V2InstructionHASH_IT::Execute(CpuModel *model)
 {
-    model_->sha_512_.init();
+    model->sha_512_.init();
     return true;
 }
 
-bool spect::V2InstructionTMAC_IS::Execute()
+bool spect::V2InstructionTMAC_IS::Execute(CpuModel *model)
 {
     // Init string in format {nonce, key length, key, 0x00, 0x00}
     unsigned char initstr[36];
@@ -766,43 +790,45 @@ bool spect::V2InstructionTMAC_IS::Execute()
     // Key length (0x20)
     initstr[1] = 0x20;
     // Key
-    uint256_t tmp = model_->GetGpr(TO_INT(op2_));
+    uint256_t tmp = model->GetGpr(TO_INT(op2_));
     for (int j = 0; j < 32; j++) {
-        initstr[j+2] = (uint8_t)((tmp >> (248 - (j * 8))) & uint256_t("0xFF"));
+        initstr[j+2] = (uint8_t)((tmp >> (248 - (j * 8))) & 0xFFU);
     }
     // Zero bytes
     initstr[34] = 0x00;
     initstr[35] = 0x00;
 
     // Print Init string
-    model_->DebugInfo(VERBOSITY_HIGH, "Keccak Init string:");
-    ss << std::hex << std::setw(2);
-    for (int i = 0; i < 36; i++)
-        ss << (int)initstr[i] << " ";
-    model_->DebugInfo(VERBOSITY_HIGH, ss.str().c_str());
-    model_->DebugInfo(VERBOSITY_HIGH, "");
+    if (DEBUG_ENABLED(model, VERBOSITY_HIGH)) {
+        DEBUG_INFO(model, VERBOSITY_HIGH, "Keccak Init string:");
+        ss << std::hex << std::setw(2);
+        for (int i = 0; i < 36; i++)
+            ss << (int)initstr[i] << " ";
+        DEBUG_INFO(model, VERBOSITY_HIGH, ss.str().c_str());
+        DEBUG_INFO(model, VERBOSITY_HIGH, "");
+    }
     ss.str("");
 
     // Process by Keccak
     for (int j = 0; j < 2; j++) {
-        if (KeccakWidth400_SpongeAbsorb(&(model_->keccak_inst_), (unsigned char *)(&initstr[j*KECCAK_RATE/8]), KECCAK_RATE/8) != 0) {
+        if (KeccakWidth400_SpongeAbsorb(&(model->keccak_inst_), (unsigned char *)(&initstr[j*KECCAK_RATE/8]), KECCAK_RATE/8) != 0) {
             ss << "Error: Calling KeccakWidth400_SpongeAbsorb() failed.";
-            model_->DebugInfo(VERBOSITY_NONE, ss.str().c_str());
+            DEBUG_INFO(model, VERBOSITY_NONE, ss.str().c_str());
         }
     }
 
     return true;
 }
 
-bool spect::V2InstructionLDK::Execute()
+bool spect::V2InstructionLDK::Execute(CpuModel *model)
 {
-    uint32_t slot   = (uint32_t)(model_->GetGpr(TO_INT(op2_)) & uint256_t("0xFF"));
+    uint32_t slot   = (uint32_t)(model->GetGpr(TO_INT(op2_)) & 0xFFU);
     uint32_t type   = (immediate_ >> 8) & 0xF;
     uint32_t offset = immediate_ & 0x1F;
     bool     error;
 
     DEFINE_CHANGE(ch_gpr, DPI_CHANGE_GPR, TO_INT(op1_));
-    PUT_GPR_TO_CHANGE(ch_gpr, old_val, model_->GetGpr(TO_INT(op1_)));
+    PUT_GPR_TO_CHANGE(ch_gpr, old_val, model->GetGpr(TO_INT(op1_)));
 
     // Read
     uint256_t tmp = 0;
@@ -810,65 +836,65 @@ bool spect::V2InstructionLDK::Execute()
         DEFINE_CHANGE(ch_kbus, DPI_CHANGE_KBUS, KBUS_OBJ_ENCODE(DPI_KBUS_LDK_READ, type, slot, (offset*8+i)<<2));
 
         // If running with CPU Simulator, preload key from simulator Key Memory to queue
-        if (model_->simulator_ != NULL) {
+        if (model->simulator_ != NULL) {
             uint32_t part;
             int      error_flag;
 
-            error_flag = model_->simulator_->key_memory_->Read(type, slot, offset*8+i, part);
-            model_->KbusErrorQueuePush(error_flag == 0 ? false : true);
-            model_->LdkQueuePush(part);
+            error_flag = model->simulator_->key_memory_->Read(type, slot, offset*8+i, part);
+            model->KbusErrorQueuePush(error_flag == 0 ? false : true);
+            model->LdkQueuePush(part);
         }
 
-        uint256_t part = model_->LdkQueuePop();
+        uint256_t part = model->LdkQueuePop();
         part = part << (32 * i);
         tmp = tmp | part;
-        model_->ReportChange(ch_kbus);
+        model->ReportChange(ch_kbus);
 
-        error = model_->KbusErrorQueuePop();
+        error = model->KbusErrorQueuePop();
         DEFINE_CHANGE(ch_ef, DPI_CHANGE_FLAG, DPI_SPECT_FLAG_ERROR);
-        PUT_FLAG_TO_CHANGE(ch_ef, old_val, model_->GetCpuFlag(CpuFlagType::ERROR));
-        model_->SetCpuFlag(CpuFlagType::ERROR, error);
-        PUT_FLAG_TO_CHANGE(ch_ef, new_val, model_->GetCpuFlag(CpuFlagType::ERROR));
-        model_->ReportChange(ch_ef);
+        PUT_FLAG_TO_CHANGE(ch_ef, old_val, model->GetCpuFlag(CpuFlagType::ERROR));
+        model->SetCpuFlag(CpuFlagType::ERROR, error);
+        PUT_FLAG_TO_CHANGE(ch_ef, new_val, model->GetCpuFlag(CpuFlagType::ERROR));
+        model->ReportChange(ch_ef);
 
         if (error)
           return true;
     }
-    model_->SetGpr(TO_INT(op1_), tmp);
+    model->SetGpr(TO_INT(op1_), tmp);
 
-    PUT_GPR_TO_CHANGE(ch_gpr, new_val, model_->GetGpr(TO_INT(op1_)));
-    model_->ReportChange(ch_gpr);
+    PUT_GPR_TO_CHANGE(ch_gpr, new_val, model->GetGpr(TO_INT(op1_)));
+    model->ReportChange(ch_gpr);
 
     return true;
 }
 
 
-bool spect::V2InstructionSTK::Execute()
+bool spect::V2InstructionSTK::Execute(CpuModel *model)
 {
-    uint32_t slot   = (uint32_t)(model_->GetGpr(TO_INT(op2_)) & uint256_t("0xFF"));
+    uint32_t slot   = (uint32_t)(model->GetGpr(TO_INT(op2_)) & 0xFFU);
     uint32_t type   = (immediate_ >> 8) & 0xF;
     uint32_t offset = immediate_ & 0x1F;
     bool     error;
 
     // Write
-    uint256_t tmp = model_->GetGpr(TO_INT(op1_));
+    uint256_t tmp = model->GetGpr(TO_INT(op1_));
     for (int i = 0; i < 8; i++) {
         DEFINE_CHANGE(ch_kbus, DPI_CHANGE_KBUS, KBUS_OBJ_ENCODE(DPI_KBUS_STK_WRITE, type, slot, (offset*8+i)<<2));
         ch_kbus.new_val[0] = uint32_t(tmp >> (32 * i));
-        model_->ReportChange(ch_kbus);
+        model->ReportChange(ch_kbus);
 
         // If running with CPU Simulator, store key to simulator Key Memory
-        if (model_->simulator_ != NULL) {
-            int error_flag = model_->simulator_->key_memory_->Write(offset*8+i, uint32_t(tmp >> (32 * i)));
-            model_->KbusErrorQueuePush(error_flag == 0 ? false : true);
+        if (model->simulator_ != NULL) {
+            int error_flag = model->simulator_->key_memory_->Write(offset*8+i, uint32_t(tmp >> (32 * i)));
+            model->KbusErrorQueuePush(error_flag == 0 ? false : true);
         }
 
-        error = model_->KbusErrorQueuePop();
+        error = model->KbusErrorQueuePop();
         DEFINE_CHANGE(ch_ef, DPI_CHANGE_FLAG, DPI_SPECT_FLAG_ERROR);
-        PUT_FLAG_TO_CHANGE(ch_ef, old_val, model_->GetCpuFlag(CpuFlagType::ERROR));
-        model_->SetCpuFlag(CpuFlagType::ERROR, error);
-        PUT_FLAG_TO_CHANGE(ch_ef, new_val, model_->GetCpuFlag(CpuFlagType::ERROR));
-        model_->ReportChange(ch_ef);
+        PUT_FLAG_TO_CHANGE(ch_ef, old_val, model->GetCpuFlag(CpuFlagType::ERROR));
+        model->SetCpuFlag(CpuFlagType::ERROR, error);
+        PUT_FLAG_TO_CHANGE(ch_ef, new_val, model->GetCpuFlag(CpuFlagType::ERROR));
+        model->ReportChange(ch_ef);
 
         if (error)
           return true;
@@ -877,44 +903,44 @@ bool spect::V2InstructionSTK::Execute()
     return true;
 }
 
-bool spect::V2InstructionKBO::Execute()
+bool spect::V2InstructionKBO::Execute(CpuModel *model)
 {
-    uint32_t slot   = (uint32_t)(model_->GetGpr(TO_INT(op2_)) & uint256_t("0xFF"));
+    uint32_t slot   = (uint32_t)(model->GetGpr(TO_INT(op2_)) & 0xFFU);
     uint32_t type   = (immediate_ >> 8) & 0xF;
     uint32_t opcode = static_cast<dpi_kbus_change_kind_t>(immediate_ & 0xF);
     bool     error;
 
     DEFINE_CHANGE(ch_kbus, DPI_CHANGE_KBUS, KBUS_OBJ_ENCODE(opcode, type, slot, 0));
-    model_->ReportChange(ch_kbus);
+    model->ReportChange(ch_kbus);
 
     // If running with CPU Simulator, update simulator Key Memory
-    if (model_->simulator_ != NULL) {
+    if (model->simulator_ != NULL) {
         uint32_t data;
         int      error_flag;
 
         if (opcode == DPI_KBUS_WRITE)
-            error_flag = model_->simulator_->key_memory_->Write(0, 0x0BAD1DEA);
+            error_flag = model->simulator_->key_memory_->Write(0, 0x0BAD1DEA);
         else if (opcode == DPI_KBUS_READ)
-            error_flag = model_->simulator_->key_memory_->Read(type, slot, 0, data);
+            error_flag = model->simulator_->key_memory_->Read(type, slot, 0, data);
         else if (opcode == DPI_KBUS_PROGRAM)
-            error_flag = model_->simulator_->key_memory_->Program(type, slot);
+            error_flag = model->simulator_->key_memory_->Program(type, slot);
         else if (opcode == DPI_KBUS_ERASE)
-            error_flag = model_->simulator_->key_memory_->Erase(type, slot);
+            error_flag = model->simulator_->key_memory_->Erase(type, slot);
         else if (opcode == DPI_KBUS_VERIFY)
-            error_flag = model_->simulator_->key_memory_->VerifyErase(type, slot);
+            error_flag = model->simulator_->key_memory_->VerifyErase(type, slot);
         else if (opcode == DPI_KBUS_FLUSH)
-            error_flag = model_->simulator_->key_memory_->Flush();
+            error_flag = model->simulator_->key_memory_->Flush();
 
-        model_->KbusErrorQueuePush(error_flag == 0 ? false : true);
+        model->KbusErrorQueuePush(error_flag == 0 ? false : true);
     }
 
-    error = model_->KbusErrorQueuePop();
+    error = model->KbusErrorQueuePop();
 
     DEFINE_CHANGE(ch_ef, DPI_CHANGE_FLAG, DPI_SPECT_FLAG_ERROR);
-    PUT_FLAG_TO_CHANGE(ch_ef, old_val, model_->GetCpuFlag(CpuFlagType::ERROR));
-    model_->SetCpuFlag(CpuFlagType::ERROR, error);
-    PUT_FLAG_TO_CHANGE(ch_ef, new_val, model_->GetCpuFlag(CpuFlagType::ERROR));
-    model_->ReportChange(ch_ef);
+    PUT_FLAG_TO_CHANGE(ch_ef, old_val, model->GetCpuFlag(CpuFlagType::ERROR));
+    model->SetCpuFlag(CpuFlagType::ERROR, error);
+    PUT_FLAG_TO_CHANGE(ch_ef, new_val, model->GetCpuFlag(CpuFlagType::ERROR));
+    model->ReportChange(ch_ef);
 
     return true;
 }
@@ -924,30 +950,30 @@ bool spect::V2InstructionKBO::Execute()
 // M Instructions
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-bool spect::V2InstructionLD::Execute()
+bool spect::V2InstructionLD::Execute(CpuModel *model)
 {
     DEFINE_CHANGE(ch_gpr, DPI_CHANGE_GPR, TO_INT(op1_));
-    PUT_GPR_TO_CHANGE(ch_gpr, old_val, model_->GetGpr(TO_INT(op1_)));
+    PUT_GPR_TO_CHANGE(ch_gpr, old_val, model->GetGpr(TO_INT(op1_)));
 
     uint256_t tmp = 0;
     for (int i = 0; i < 8; i++) {
-        uint32_t buf = model_->ReadMemoryCoreData(addr_ + (4 * i));
+        uint32_t buf = model->ReadMemoryCoreData(addr_ + (4 * i));
         tmp = (uint256_t(buf) << (i * 32)) | tmp;
     }
-    model_->SetGpr(TO_INT(op1_), tmp);
+    model->SetGpr(TO_INT(op1_), tmp);
 
-    PUT_GPR_TO_CHANGE(ch_gpr, new_val, model_->GetGpr(TO_INT(op1_)));
-    model_->ReportChange(ch_gpr);
+    PUT_GPR_TO_CHANGE(ch_gpr, new_val, model->GetGpr(TO_INT(op1_)));
+    model->ReportChange(ch_gpr);
 
     return true;
 }
 
-bool spect::V2InstructionST::Execute()
+bool spect::V2InstructionST::Execute(CpuModel *model)
 {
-    uint256_t tmp = model_->GetGpr(TO_INT(op1_));
+    uint256_t tmp = model->GetGpr(TO_INT(op1_));
     for (int i = 0; i < 8; i++) {
-        model_->WriteMemoryCoreData(addr_ + (i * 4),
-                    static_cast<uint32_t>(tmp & uint256_t("0xFFFFFFFF")));
+        model->WriteMemoryCoreData(addr_ + (i * 4),
+                    static_cast<uint32_t>(tmp));
         tmp = tmp >> 32;
     }
     return true;
@@ -958,38 +984,38 @@ bool spect::V2InstructionST::Execute()
 // J Instructions
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-bool spect::V2InstructionCALL::Execute()
+bool spect::V2InstructionCALL::Execute(CpuModel *model)
 {
     DEFINE_CHANGE(ch_rar, DPI_CHANGE_RAR, DPI_RAR_PUSH);
 
-    uint16_t ret_addr = model_->GetPc() + 0x4;
-    model_->RarPush(ret_addr);
-    model_->SetPc(new_pc_);
+    uint16_t ret_addr = model->GetPc() + 0x4;
+    model->RarPush(ret_addr);
+    model->SetPc(new_pc_);
 
     ch_rar.new_val[0] = ret_addr;
-    model_->ReportChange(ch_rar);
+    model->ReportChange(ch_rar);
 
     return false;
 }
 
-bool spect::V2InstructionRET::Execute()
+bool spect::V2InstructionRET::Execute(CpuModel *model)
 {
     DEFINE_CHANGE(ch_rar, DPI_CHANGE_RAR, DPI_RAR_POP);
 
-    uint16_t ret_addr = model_->RarPop();
-    model_->SetPc(ret_addr);
+    uint16_t ret_addr = model->RarPop();
+    model->SetPc(ret_addr);
 
     ch_rar.new_val[0] = ret_addr;
-    model_->ReportChange(ch_rar);
+    model->ReportChange(ch_rar);
 
     return false;
 }
 
 #define IMPLEMENT_COND_JUMP_OP(classname,flag_name,value)                                   \
-    bool spect::classname::Execute()                                                        \
+    bool spect::classname::Execute(CpuModel *model)                                         \
     {                                                                                       \
-        if (model_->GetCpuFlags().flag_name == value){                                      \
-            model_->SetPc(new_pc_);                                                         \
+        if (model->GetCpuFlags().flag_name == value){                                       \
+            model->SetPc(new_pc_);                                                          \
             return false;                                                                   \
         }                                                                                   \
         return true;                                                                        \
@@ -1002,21 +1028,21 @@ IMPLEMENT_COND_JUMP_OP(V2InstructionBRNC,carry,false)
 IMPLEMENT_COND_JUMP_OP(V2InstructionBRE,error,true)
 IMPLEMENT_COND_JUMP_OP(V2InstructionBRNE,error,false)
 
-bool spect::V2InstructionJMP::Execute()
+bool spect::V2InstructionJMP::Execute(CpuModel *model)
 {
-    model_->SetPc(new_pc_);
+    model->SetPc(new_pc_);
     return false;
 }
 
-bool spect::V2InstructionEND::Execute()
+bool spect::V2InstructionEND::Execute(CpuModel *model)
 {
-    model_->Finish(0);
-    model_->UpdateInterrupts();
+    model->Finish(0);
+    model->UpdateInterrupts();
 
     return false;
 }
 
-bool spect::V2InstructionNOP::Execute()
+bool spect::V2InstructionNOP::Execute(A_UNUSED CpuModel *model)
 {
     return true;
 }
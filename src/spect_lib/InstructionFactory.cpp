@@ -11,9 +11,11 @@
 **************************************************************************************************/
 
 #include <iostream>
+#include <iterator>
 
 #include "InstructionDefs.h"
 #include "InstructionFactory.h"
+#include "PerfectHash.h"
 
 #define REGISTER_R_INSTRUCTION(version, name)                                               \
     InstructionFactory::Register(version, new name(CpuGpr::R0, CpuGpr::R0, CpuGpr::R0));
@@ -27,12 +29,40 @@
 #define REGISTER_J_INSTRUCTION(version, name)                                               \
     InstructionFactory::Register(version, new name(0x0));
 
+/////////////////////////////////////////////////////////////////////////////////////
+// List of macros defined by CMake from InstructionDefs.txt, mnemonics of all
+// instructions of ISA version in order of registration.
+/////////////////////////////////////////////////////////////////////////////////////
+static constexpr const char *MNEMONICS_V1[] = { SPECT_MNEMONICS_V1 };
+static constexpr const char *MNEMONICS_V2[] = { SPECT_MNEMONICS_V2 };
 
+static constexpr spect::PerfectHash<std::size(MNEMONICS_V1)> MNEMONIC_HASH_V1(MNEMONICS_V1);
+static constexpr spect::PerfectHash<std::size(MNEMONICS_V2)> MNEMONIC_HASH_V2(MNEMONICS_V2);
+
+static int FindMnemonic(int isa_version, const std::string &mnemonic)
+{
+    switch (isa_version) {
+    case 1:
+        return MNEMONIC_HASH_V1.Find(mnemonic);
+    case 2:
+        return MNEMONIC_HASH_V2.Find(mnemonic);
+    default:
+        return -1;
+    }
+}
 
 void spect::InstructionFactory::Register(int isa_version, spect::Instruction *instr)
 {
     assert(isa_version > 0 && isa_version <= NUM_ISA_VERSIONS);
 
+    instr->id_ = instructions_.size();
+    instructions_.push_back(instr);
+
+    // Instructions are registered in the same order as mnemonics are listed
+    assert(FindMnemonic(isa_version, instr->mnemonic_) ==
+           static_cast<int>(mnemonic_tables_[isa_version - 1].size()));
+    mnemonic_tables_[isa_version - 1].push_back(instr);
+
     mnemonic_maps_[isa_version - 1][instr->mnemonic_] = instr;
     uint32_t enc = INSTR_ENCODE(instr->func_, instr->opcode_, instr->itype_);
     encoding_maps_[isa_version - 1][enc] = instr;
@@ -53,63 +83,71 @@ bool spect::InstructionFactory::Initialize()
     SPECT_REGISTER_INSTRUCTIONS_V1
     SPECT_REGISTER_INSTRUCTIONS_V2
 
-    // By default start from latest ISA version
-    SetActiveISAVersion(NUM_ISA_VERSIONS);
-
     return true;
 }
 
 spect::InstructionFactory::~InstructionFactory()
 {
-    for (auto &instr : mnemonic_maps_[active_isa_map_index])
-        delete instr.second;
+    for (auto &instr : instructions_)
+        delete instr;
 }
 
-spect::Instruction* spect::InstructionFactory::GetInstruction(uint32_t enc)
+spect::Instruction* spect::InstructionFactory::GetInstruction(int isa_version, uint32_t enc)
 {
-    auto it = encoding_maps_[active_isa_map_index].find(enc);
-    if (it == encoding_maps_[active_isa_map_index].end())
-        return nullptr;
+    assert(isa_version > 0 && isa_version <= NUM_ISA_VERSIONS);
 
-    return encoding_maps_[active_isa_map_index][enc];
+    auto it = encoding_maps_[isa_version - 1].find(enc);
+    if (it == encoding_maps_[isa_version - 1].end())
+        return nullptr;
+    return it->second;
 }
 
-spect::Instruction* spect::InstructionFactory::GetInstruction(std::string mnemonic)
+spect::Instruction* spect::InstructionFactory::GetInstruction(int isa_version,
+                                                              const std::string &mnemonic)
 {
-    auto it = mnemonic_maps_[active_isa_map_index].find(mnemonic);
-    if (it == mnemonic_maps_[active_isa_map_index].end())
+    assert(isa_version > 0 && isa_version <= NUM_ISA_VERSIONS);
+
+    int i = FindMnemonic(isa_version, mnemonic);
+    if (i < 0)
         return nullptr;
-    return mnemonic_maps_[active_isa_map_index][mnemonic];
+    return mnemonic_tables_[isa_version - 1][i];
 }
 
-std::map<std::string, spect::Instruction*>::iterator spect::InstructionFactory::GetInstructionIterator()
+spect::Instruction* spect::InstructionFactory::GetInstructionById(int id)
 {
-    return mnemonic_maps_[active_isa_map_index].begin();
+    assert(id >= 0 && id < GetInstructionCount());
+
+    return instructions_[id];
 }
 
-bool spect::InstructionFactory::IteratorIsLast(
-    std::map<std::string, spect::Instruction*>::iterator &it)
+int spect::InstructionFactory::GetInstructionCount(void)
 {
-    return (it == mnemonic_maps_[active_isa_map_index].end());
+    return instructions_.size();
 }
 
-void spect::InstructionFactory::SetActiveISAVersion(int isa_version)
+std::map<std::string, spect::Instruction*>::const_iterator
+    spect::InstructionFactory::GetInstructionIterator(int isa_version)
 {
     assert(isa_version > 0 && isa_version <= NUM_ISA_VERSIONS);
 
-    // ISA versions starts from 1. Map arrays are indexed from 0
-    active_isa_map_index = isa_version - 1;
+    return mnemonic_maps_[isa_version - 1].cbegin();
 }
 
-int spect::InstructionFactory::GetActiveISAVersion(void)
+bool spect::InstructionFactory::IteratorIsLast(int isa_version,
+    std::map<std::string, spect::Instruction*>::const_iterator &it)
 {
-    return active_isa_map_index + 1;
+    assert(isa_version > 0 && isa_version <= NUM_ISA_VERSIONS);
+
+    return (it == mnemonic_maps_[isa_version - 1].cend());
 }
 
+std::vector<spect::Instruction*> spect::InstructionFactory::instructions_;
+
 std::map<std::string, spect::Instruction*> spect::InstructionFactory::mnemonic_maps_[NUM_ISA_VERSIONS];;
 
+std::vector<spect::Instruction*> spect::InstructionFactory::mnemonic_tables_[NUM_ISA_VERSIONS];
+
 std::map<uint32_t, spect::Instruction*> spect::InstructionFactory::encoding_maps_[NUM_ISA_VERSIONS];;
 
 bool spect::InstructionFactory::initialized_ = spect::InstructionFactory::Initialize();
 
-int spect::InstructionFactory::active_isa_map_index = 0;
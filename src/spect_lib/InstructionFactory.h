@@ -14,6 +14,7 @@
 #define SPECT_LIB_INSTRUCTION_FACTORY_H_
 
 #include <map>
+#include <vector>
 
 #include "spect.h"
 
@@ -25,6 +26,8 @@ class spect::InstructionFactory
         ///////////////////////////////////////////////////////////////////////////////////////////
         /// @brief Initialize instruction factory.
         ///        This method registers all instructions defined in InstructionDefs.txt
+        /// @note Registered instructions are prototypes shared by all models and compilers.
+        ///       They are never modified after registration, users clone them.
         ///////////////////////////////////////////////////////////////////////////////////////////
         static bool Initialize();
 
@@ -35,40 +38,48 @@ class spect::InstructionFactory
 
         ///////////////////////////////////////////////////////////////////////////////////////////
         /// @return Instruction object from factory
+        /// @param isa_version ISA version to search in
         /// @param enc Unique encoding of the instruction given by
         ///             INSTR_ENCODE(func, opcode, itype)
         /// @returns Pointer to instruction matching the encoding, nullptr if no instruction with
-        ///          'enc' encoding has been registered.
+        ///          'enc' encoding has been registered in 'isa_version'.
         ///////////////////////////////////////////////////////////////////////////////////////////
-        static spect::Instruction* GetInstruction(uint32_t enc);
+        static spect::Instruction* GetInstruction(int isa_version, uint32_t enc);
 
         ///////////////////////////////////////////////////////////////////////////////////////////
         /// @return Instruction object from factory
-        /// @param enc Instruction mnemonic (as seen in .s file)
+        /// @param isa_version ISA version to search in
+        /// @param mnemonic Instruction mnemonic (as seen in .s file)
         /// @returns Pointer to instruction matching the mnemonic, nullptr if no instruction with
-        ///          'mnemonic' has been registered.
+        ///          'mnemonic' has been registered in 'isa_version'.
         ///////////////////////////////////////////////////////////////////////////////////////////
-        static spect::Instruction* GetInstruction(std::string mnemonic);
+        static spect::Instruction* GetInstruction(int isa_version, const std::string &mnemonic);
 
         ///////////////////////////////////////////////////////////////////////////////////////////
-        /// @return Instruction iterator over all registered instructions.
+        /// @return Instruction object from factory
+        /// @param id Dense index of the instruction (Instruction::id_)
+        /// @returns Pointer to instruction with 'id', regardless of ISA version.
         ///////////////////////////////////////////////////////////////////////////////////////////
-        static std::map<std::string, spect::Instruction*>::iterator GetInstructionIterator();
+        static spect::Instruction* GetInstructionById(int id);
 
         ///////////////////////////////////////////////////////////////////////////////////////////
-        /// @returns True if iterator is at the last instruction
+        /// @returns Number of instructions registered within factory (over all ISA versions)
         ///////////////////////////////////////////////////////////////////////////////////////////
-        static bool IteratorIsLast(std::map<std::string, spect::Instruction*>::iterator &it);
+        static int GetInstructionCount(void);
 
         ///////////////////////////////////////////////////////////////////////////////////////////
-        /// @param isa_version Version of ISA under which to register an Instruction
+        /// @param isa_version ISA version to iterate over
+        /// @return Instruction iterator over all instructions registered in 'isa_version'.
         ///////////////////////////////////////////////////////////////////////////////////////////
-        static void SetActiveISAVersion(int isa_version);
+        static std::map<std::string, spect::Instruction*>::const_iterator
+            GetInstructionIterator(int isa_version);
 
         ///////////////////////////////////////////////////////////////////////////////////////////
-        /// @returns Current active ISA version
+        /// @param isa_version ISA version iterated over
+        /// @returns True if iterator is past the last instruction of 'isa_version'
         ///////////////////////////////////////////////////////////////////////////////////////////
-        static int GetActiveISAVersion(void);
+        static bool IteratorIsLast(int isa_version,
+                                   std::map<std::string, spect::Instruction*>::const_iterator &it);
 
     private:
 
@@ -80,18 +91,21 @@ class spect::InstructionFactory
         static void Register(int isa_version, spect::Instruction *instr);
 
         // True - Factory is initialized (All instructions registered), False otherwise
+        // Tables below are filled during static initialization and only read afterwards, so
+        // factory can be used by any number of threads without locking.
         static bool initialized_;
 
-        // Current active version of ISA
-        // Used to select a mnemonic map from array of mnemonic maps, each holding instructions
-        // for a single ISA version.
-        //  active_isa_map_index = isa_version - 1
-        static int active_isa_map_index;
-
         // Hash maps with instructions: mnemonic -> *Instruction
         // Single map for each ISA version
         static std::map<std::string, spect::Instruction*> mnemonic_maps_[NUM_ISA_VERSIONS];
 
+        // Instructions indexed by key of perfect hash of mnemonics (see PerfectHash.h), used
+        // to look-up instructions by mnemonic. Single table for each ISA version.
+        static std::vector<spect::Instruction*> mnemonic_tables_[NUM_ISA_VERSIONS];
+
+        // All registered instructions (over all ISA versions), indexed by Instruction::id_
+        static std::vector<spect::Instruction*> instructions_;
+
         // Hash maps with instructions: encoding -> *Instruction
         // Single map for each ISA version
         static std::map<uint32_t, spect::Instruction*> encoding_maps_[NUM_ISA_VERSIONS];
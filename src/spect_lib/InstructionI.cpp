@@ -49,7 +49,7 @@ uint32_t spect::InstructionI::Assemble()
 }
 
 
-spect::Instruction* spect::InstructionI::DisAssemble(uint32_t wrd)
+spect::Instruction* spect::InstructionI::DisAssemble(int isa_version, uint32_t wrd)
 {
     uint32_t immediate = (wrd >> IENC_IMMEDIATE_OFFSET) & IENC_IMMEDIATE_MASK;
     uint32_t op1       = (wrd >> IENC_OP1_OFFSET)       & IENC_OP_MASK;
@@ -59,7 +59,7 @@ spect::Instruction* spect::InstructionI::DisAssemble(uint32_t wrd)
     uint32_t itype     = (wrd >> IENC_TYPE_OFFSET)      & IENC_TYPE_MASK;
 
     spect::Instruction *instr = spect::InstructionFactory::
-                                GetInstruction(INSTR_ENCODE(func, opcode, itype));
+                                GetInstruction(isa_version, INSTR_ENCODE(func, opcode, itype));
     spect::InstructionI *cln = nullptr;
     if (instr) {
         cln = (spect::InstructionI*) instr->Clone();
@@ -83,20 +83,23 @@ void spect::InstructionI::Dump(std::ostream& os)
         }
 }
 
-bool spect::InstructionI::Execute()
+bool spect::InstructionI::Execute(CpuModel *model)
 {
-    model_->DebugInfo(VERBOSITY_MEDIUM, "Inputs before execution:");
+    if (!DEBUG_ENABLED(model, VERBOSITY_MEDIUM))
+        return true;
+
+    DEBUG_INFO(model, VERBOSITY_MEDIUM, "Inputs before execution:");
 
     if (op_mask_ & 0x2) {
         std::stringstream ss;
-        ss << "    " << op2_ << ": " << std::hex << "0x" << model_->GetGpr(TO_INT(op2_));
-        model_->DebugInfo(VERBOSITY_MEDIUM, ss.str().c_str());
+        ss << "    " << op2_ << ": " << std::hex << "0x" << model->GetGpr(TO_INT(op2_));
+        DEBUG_INFO(model, VERBOSITY_MEDIUM, ss.str().c_str());
     }
 
     if (op_mask_ & 0x1) {
         std::stringstream ss;
         ss << "    " << "Immediate:" << std::hex << "0x" << immediate_;
-        model_->DebugInfo(VERBOSITY_MEDIUM, ss.str().c_str());
+        DEBUG_INFO(model, VERBOSITY_MEDIUM, ss.str().c_str());
     }
 
     return true;
@@ -26,8 +26,8 @@ class spect::InstructionI : public Instruction
         void Dump(std::ostream& os);
         spect::Symbol* Relocate();
         uint32_t Assemble();
-        static Instruction* DisAssemble(uint32_t wrd);
-        bool Execute();
+        static Instruction* DisAssemble(int isa_version, uint32_t wrd);
+        bool Execute(CpuModel *model);
         void SampleInputs(dpi_instruction_t *dpi_instr, CpuModel *model);
         void SampleOutputs(dpi_instruction_t *dpi_instr, CpuModel *model);
 
@@ -42,7 +42,7 @@ uint32_t spect::InstructionJ::Assemble()
            );
 }
 
-spect::Instruction* spect::InstructionJ::DisAssemble(uint32_t wrd)
+spect::Instruction* spect::InstructionJ::DisAssemble(int isa_version, uint32_t wrd)
 {
     uint32_t new_pc = (wrd >> IENC_NEW_PC_OFFSET) & IENC_NEW_PC_MASK;
     uint32_t func   = (wrd >> IENC_FUNC_OFFSET)   & IENC_FUNC_MASK;
@@ -50,7 +50,7 @@ spect::Instruction* spect::InstructionJ::DisAssemble(uint32_t wrd)
     uint32_t itype  = (wrd >> IENC_TYPE_OFFSET)   & IENC_TYPE_MASK;
 
     spect::Instruction *instr = spect::InstructionFactory::
-                                GetInstruction(INSTR_ENCODE(func, opcode, itype));
+                                GetInstruction(isa_version, INSTR_ENCODE(func, opcode, itype));
     spect::InstructionJ *cln = nullptr;
     if (instr) {
         cln = (spect::InstructionJ*) instr->Clone();
@@ -70,14 +70,17 @@ void spect::InstructionJ::Dump(std::ostream& os)
         }
 }
 
-bool spect::InstructionJ::Execute()
+bool spect::InstructionJ::Execute(CpuModel *model)
 {
-    model_->DebugInfo(VERBOSITY_MEDIUM, "Inputs before execution:");
+    if (!DEBUG_ENABLED(model, VERBOSITY_MEDIUM))
+        return true;
+
+    DEBUG_INFO(model, VERBOSITY_MEDIUM, "Inputs before execution:");
 
     if (op_mask_ & 0x4) {
         std::stringstream ss;
         ss << "    " << "NewPC:" << std::hex << "0x" << new_pc_;
-        model_->DebugInfo(VERBOSITY_MEDIUM, ss.str().c_str());
+        DEBUG_INFO(model, VERBOSITY_MEDIUM, ss.str().c_str());
     }
 
     return true;
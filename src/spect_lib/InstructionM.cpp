@@ -44,7 +44,7 @@ uint32_t spect::InstructionM::Assemble()
            );
 }
 
-spect::Instruction* spect::InstructionM::DisAssemble(uint32_t wrd)
+spect::Instruction* spect::InstructionM::DisAssemble(int isa_version, uint32_t wrd)
 {
     uint32_t addr   = (wrd >> IENC_ADDR_OFFSET)   & IENC_ADDR_MASK;
     uint32_t op1    = (wrd >> IENC_OP1_OFFSET)    & IENC_OP_MASK;
@@ -53,7 +53,7 @@ spect::Instruction* spect::InstructionM::DisAssemble(uint32_t wrd)
     uint32_t itype  = (wrd >> IENC_TYPE_OFFSET)   & IENC_TYPE_MASK;
 
     spect::Instruction *instr = spect::InstructionFactory::
-                                GetInstruction(INSTR_ENCODE(func, opcode, itype));
+                                GetInstruction(isa_version, INSTR_ENCODE(func, opcode, itype));
     spect::InstructionM *cln = nullptr;
     if (instr) {
         cln = (spect::InstructionM*) instr->Clone();
@@ -74,20 +74,23 @@ void spect::InstructionM::Dump(std::ostream& os)
         }
 }
 
-bool spect::InstructionM::Execute()
+bool spect::InstructionM::Execute(CpuModel *model)
 {
-    model_->DebugInfo(VERBOSITY_MEDIUM, "Inputs before execution:");
+    if (!DEBUG_ENABLED(model, VERBOSITY_MEDIUM))
+        return true;
+
+    DEBUG_INFO(model, VERBOSITY_MEDIUM, "Inputs before execution:");
 
     if (op_mask_ & 0x4) {
         std::stringstream ss;
-        ss << "    " << op1_ << ": " << std::hex << "0x" << model_->GetGpr(TO_INT(op1_));
-        model_->DebugInfo(VERBOSITY_MEDIUM, ss.str().c_str());
+        ss << "    " << op1_ << ": " << std::hex << "0x" << model->GetGpr(TO_INT(op1_));
+        DEBUG_INFO(model, VERBOSITY_MEDIUM, ss.str().c_str());
     }
 
     if (op_mask_ & 0x2) {
         std::stringstream ss;
         ss << "    " << "Addr:" << std::hex << "0x" << addr_;
-        model_->DebugInfo(VERBOSITY_MEDIUM, ss.str().c_str());
+        DEBUG_INFO(model, VERBOSITY_MEDIUM, ss.str().c_str());
     }
 
     return true;
@@ -41,7 +41,7 @@ uint32_t spect::InstructionR::Assemble()
            );
 }
 
-spect::Instruction* spect::InstructionR::DisAssemble(uint32_t wrd)
+spect::Instruction* spect::InstructionR::DisAssemble(int isa_version, uint32_t wrd)
 {
     uint32_t op1    = (wrd >> IENC_OP1_OFFSET)    & IENC_OP_MASK;
     uint32_t op2    = (wrd >> IENC_OP2_OFFSET)    & IENC_OP_MASK;
@@ -51,7 +51,7 @@ spect::Instruction* spect::InstructionR::DisAssemble(uint32_t wrd)
     uint32_t itype  = (wrd >> IENC_TYPE_OFFSET)   & IENC_TYPE_MASK;
 
     spect::Instruction *instr = spect::InstructionFactory::
-                                GetInstruction(INSTR_ENCODE(func, opcode, itype));
+                                GetInstruction(isa_version, INSTR_ENCODE(func, opcode, itype));
     spect::InstructionR *cln = nullptr;
     if (instr) {
         cln = (spect::InstructionR*) instr->Clone();
@@ -76,26 +76,29 @@ void spect::InstructionR::Dump(std::ostream& os)
         }
 }
 
-bool spect::InstructionR::Execute()
+bool spect::InstructionR::Execute(CpuModel *model)
 {
-    model_->DebugInfo(VERBOSITY_MEDIUM, "Inputs before execution:");
+    if (!DEBUG_ENABLED(model, VERBOSITY_MEDIUM))
+        return true;
+
+    DEBUG_INFO(model, VERBOSITY_MEDIUM, "Inputs before execution:");
 
     if (op_mask_ & 0x2) {
         std::stringstream ss;
-        ss << "    " << op2_ << ": " << std::hex << "0x" << model_->GetGpr(TO_INT(op2_));
-        model_->DebugInfo(VERBOSITY_MEDIUM, ss.str().c_str());
+        ss << "    " << op2_ << ": " << std::hex << "0x" << model->GetGpr(TO_INT(op2_));
+        DEBUG_INFO(model, VERBOSITY_MEDIUM, ss.str().c_str());
     }
 
     if (op_mask_ & 0x1) {
         std::stringstream ss;
-        ss << "    " << op3_ << ": " << std::hex << "0x" << model_->GetGpr(TO_INT(op3_));
-        model_->DebugInfo(VERBOSITY_MEDIUM, ss.str().c_str());
+        ss << "    " << op3_ << ": " << std::hex << "0x" << model->GetGpr(TO_INT(op3_));
+        DEBUG_INFO(model, VERBOSITY_MEDIUM, ss.str().c_str());
     }
 
     if (r31_dep_) {
         std::stringstream ss;
-        ss << "    " << "R31" << ": " << std::hex << "0x" << model_->GetGpr(31);
-        model_->DebugInfo(VERBOSITY_MEDIUM, ss.str().c_str());
+        ss << "    " << "R31" << ": " << std::hex << "0x" << model->GetGpr(31);
+        DEBUG_INFO(model, VERBOSITY_MEDIUM, ss.str().c_str());
     }
 
     return true;
@@ -6,6 +6,7 @@
 ** Author: Marek Santa
 **************************************************************************************************/
 
+#include <algorithm>
 #include <regex>
 #include <fstream>
 #include <iostream>
@@ -14,83 +15,81 @@
 #include "KeyMemory.h"
 
 spect::KeyMemory::KeyMemory()
-{
-    // Initialize Key Memory to all 1s and Slot Status to empty
-    for (uint32_t type = 0; type < KEY_MEM_TYPE_NUM; type++) {
-        for (uint32_t slot = 0; slot < KEY_MEM_SLOT_NUM; slot++) {
-            slot_status_[type][slot] = SlotStatus::EMPTY;
-            for (uint32_t offset = 0; offset < KEY_MEM_OFFSET_NUM; offset++) {
-                key_mem_[type][slot][offset] = 0xFFFFFFFF;
-            }
-        }
-    }
-}
+{}
 
 spect::KeyMemory::~KeyMemory()
 {}
 
 uint32_t spect::KeyMemory::Get(uint8_t type, uint8_t slot, uint8_t offset)
 {
-    return key_mem_[type][slot][offset];
+    const Slot *s = FindSlot(type, slot);
+    return s ? s->data[offset] : 0xFFFFFFFF;
 }
 
 void spect::KeyMemory::Set(uint8_t type, uint8_t slot, uint8_t offset, uint32_t data)
 {
-    key_mem_[type][slot][offset] = data;
-    slot_status_[type][slot] = SlotStatus::FULL;
+    Slot &s = WriteSlot(type, slot);
+    s.data[offset] = data;
+    s.status = SlotStatus::FULL;
 }
 
 int spect::KeyMemory::Read(uint32_t type, uint32_t slot, uint32_t offset, uint32_t &data)
 {
-    DebugInfo(VERBOSITY_HIGH, "Reading Key Memory type", type, ", slot", tohexs(slot, 4), "and offset", tohexs(offset, 4));
-    if (slot_status_[type][slot] == SlotStatus::EMPTY) {
-        DebugInfo(VERBOSITY_HIGH, "Key Memory type", type, "and slot", tohexs(slot, 4), "is empty, reading failed");
+    DEBUG_INFO(this, VERBOSITY_HIGH, "Reading Key Memory type", type, ", slot", tohexs(slot, 4), "and offset", tohexs(offset, 4));
+    auto it = slots_.find(type * KEY_MEM_SLOT_NUM + slot);
+    if (it == slots_.end() || it->second->status == SlotStatus::EMPTY) {
+        DEBUG_INFO(this, VERBOSITY_HIGH, "Key Memory type", type, "and slot", tohexs(slot, 4), "is empty, reading failed");
         return 1;
     }
 
-    for (uint32_t ofst = 0; ofst < KEY_MEM_OFFSET_NUM; ofst++)
-        ram_buffer_[ofst] = key_mem_[type][slot][ofst];
-    data = ram_buffer_[offset];
+    // Whole slot is read to RAM Buffer, copy is deferred till RAM Buffer is modified
+    latched_ = it->second;
+    data = latched_->data[offset];
     return 0;
 }
 
 int spect::KeyMemory::Write(uint32_t offset, uint32_t data)
 {
-    DebugInfo(VERBOSITY_HIGH, "Writing RAM Buffer[", tohexs(offset, 4), "] =", tohexs(data, 8));
+    DEBUG_INFO(this, VERBOSITY_HIGH, "Writing RAM Buffer[", tohexs(offset, 4), "] =", tohexs(data, 8));
+    UnlatchRamBuffer();
     ram_buffer_[offset] = data;
     return 0;
 }
 
 int spect::KeyMemory::Program(uint32_t type, uint32_t slot)
 {
-    DebugInfo(VERBOSITY_HIGH, "Erasing Key Memory type", type, "and slot", tohexs(slot, 4));
-    if (slot_status_[type][slot] == SlotStatus::FULL) {
-        DebugInfo(VERBOSITY_HIGH, "Key Memory type", type, "and slot", slot, "is full, programming failed");
+    DEBUG_INFO(this, VERBOSITY_HIGH, "Erasing Key Memory type", type, "and slot", tohexs(slot, 4));
+    const Slot *found = FindSlot(type, slot);
+    if (found && found->status == SlotStatus::FULL) {
+        DEBUG_INFO(this, VERBOSITY_HIGH, "Key Memory type", type, "and slot", slot, "is full, programming failed");
         return 1;
     }
 
+    UnlatchRamBuffer();
+    Slot &s = WriteSlot(type, slot);
     for (uint32_t offset = 0; offset < KEY_MEM_OFFSET_NUM; offset++)
-        key_mem_[type][slot][offset] = ram_buffer_[offset];
-    slot_status_[type][slot] = SlotStatus::FULL;
+        s.data[offset] = ram_buffer_[offset];
+    s.status = SlotStatus::FULL;
     return 0;
 }
 
 int spect::KeyMemory::Erase(uint32_t type, uint32_t slot)
 {
-    DebugInfo(VERBOSITY_HIGH, "Erasing Key Memory type", type, "and slot", tohexs(slot, 4));
-    for (uint32_t offset = 0; offset < KEY_MEM_OFFSET_NUM; offset++) {
-        key_mem_[type][slot][offset] = 0xFFFFFFFF;
-    }
-    slot_status_[type][slot] = SlotStatus::EMPTY;
+    DEBUG_INFO(this, VERBOSITY_HIGH, "Erasing Key Memory type", type, "and slot", tohexs(slot, 4));
+    // Erased slot is all 1s and empty, same as not allocated
+    slots_.erase(type * KEY_MEM_SLOT_NUM + slot);
     return 0;
 }
 
 int spect::KeyMemory::VerifyErase(uint32_t type, uint32_t slot)
 {
-    DebugInfo(VERBOSITY_HIGH, "Verifying erase of Key Memory type", type, "and slot", tohexs(slot, 4));
+    DEBUG_INFO(this, VERBOSITY_HIGH, "Verifying erase of Key Memory type", type, "and slot", tohexs(slot, 4));
+    const Slot *s = FindSlot(type, slot);
+    if (!s)
+        return 0;
     for (uint32_t offset = 0; offset < KEY_MEM_OFFSET_NUM; offset++) {
-        if (key_mem_[type][slot][offset] != 0xFFFFFFFF) {
-            DebugInfo(VERBOSITY_HIGH, "Verifying erase of Key Memory failed");
+        if (s->data[offset] != 0xFFFFFFFF) {
+            DEBUG_INFO(this, VERBOSITY_HIGH, "Verifying erase of Key Memory failed");
             return 1;
         }
     }
@@ -99,7 +98,8 @@ int spect::KeyMemory::VerifyErase(uint32_t type, uint32_t slot)
 
 int spect::KeyMemory::Flush()
 {
-    DebugInfo(VERBOSITY_HIGH, "Flushing RAM Buffer");
+    DEBUG_INFO(this, VERBOSITY_HIGH, "Flushing RAM Buffer");
+    latched_.reset();
     for (uint32_t offset = 0; offset < KEY_MEM_OFFSET_NUM; offset++) {
         ram_buffer_[offset] = rand();
     }
@@ -115,14 +115,14 @@ int spect::KeyMemory::Flush()
     for (int i = 0; i < 3; i++)     \
         std::getline(ifs, line);
 
-void spect::KeyMemory::Dump(const std::string &path)
+void spect::KeyMemory::Dump(const std::string &path, bool sparse)
 {
     std::ofstream ofs;
     std::stringstream ss;
     ofs.open(path);
 
     if (ofs.is_open()) {
-        DebugInfo(VERBOSITY_LOW, "Dumping Key Memory to: ", path);
+        DEBUG_INFO(this, VERBOSITY_LOW, "Dumping Key Memory to: ", path);
 
         ofs << std::hex;
         ofs << std::setfill('0');
@@ -130,20 +130,23 @@ void spect::KeyMemory::Dump(const std::string &path)
         PUT_COMMENT_LINE("Key Memory:");
         for (uint32_t type = 0; type < KEY_MEM_TYPE_NUM; type++) {
             for (uint32_t slot = 0; slot < KEY_MEM_SLOT_NUM; slot++) {
+                const Slot *s = FindSlot(type, slot);
+                if (sparse && !s)
+                    continue;
                 ss << "Type: " << type << " Slot: " << slot;
                 PUT_COMMENT_LINE(ss.str());
-                ofs << "Status: " << ((slot_status_[type][slot] == SlotStatus::EMPTY) ? "EMPTY" : "FULL") << "\n";
-                if (slot_status_[type][slot] == SlotStatus::FULL) {
+                ofs << "Status: " << ((!s || s->status == SlotStatus::EMPTY) ? "EMPTY" : "FULL") << "\n";
+                if (s && s->status == SlotStatus::FULL) {
                     for (uint32_t offset = 0; offset < KEY_MEM_OFFSET_NUM; offset++) {
-                      ofs << std::setw(8) << key_mem_[type][slot][offset] << "\n";
+                      ofs << std::setw(8) << s->data[offset] << "\n";
                     }
                 }
                 ss.str("");
             }
         }
 
-        DebugInfo(VERBOSITY_LOW, "Finished dumping Key Memory.");
-        DebugInfo(VERBOSITY_LOW, "\n");
+        DEBUG_INFO(this, VERBOSITY_LOW, "Finished dumping Key Memory.");
+        DEBUG_INFO(this, VERBOSITY_LOW, "\n");
 
         ofs.close();
     } else
@@ -156,36 +159,90 @@ void spect::KeyMemory::Load(const std::string &path)
     std::string line;
 
     if (ifs.is_open()) {
-        DebugInfo(VERBOSITY_LOW, "Loading Key Memory to: ", path);
-
-        // Key Memory
-        SKIP_COMMENT_LINES
-        for (uint32_t type = 0; type < KEY_MEM_TYPE_NUM; type++) {
-            for (uint32_t slot = 0; slot < KEY_MEM_SLOT_NUM; slot++) {
-                SKIP_COMMENT_LINES
-                std::getline(ifs, line);
+        DEBUG_INFO(this, VERBOSITY_LOW, "Loading Key Memory to: ", path);
+        slots_.clear();
+
+        // Slot header ("Type: <type> Slot: <slot>") is followed by slot status and data of
+        // full slot. Other lines are comments.
+        uint32_t type = 0;
+        uint32_t slot = 0;
+        while (std::getline(ifs, line)) {
+            if (line.compare(0, 5, "Type:") == 0) {
+                std::string tmp;
+                std::istringstream iss(line);
+                iss >> tmp >> type >> tmp >> slot;
+                if (!iss || type >= KEY_MEM_TYPE_NUM || slot >= KEY_MEM_SLOT_NUM)
+                    throw std::runtime_error("Invalid Key Memory slot: " + line);
+            } else if (line.compare(0, 7, "Status:") == 0) {
                 std::string i_str = line.substr(8, line.size() - 1);
-                slot_status_[type][slot] = (i_str == "EMPTY") ? SlotStatus::EMPTY : SlotStatus::FULL;
-                if (slot_status_[type][slot] == SlotStatus::FULL) {
-                    for (uint32_t offset = 0; offset < KEY_MEM_OFFSET_NUM; offset++) {
-                        std::getline(ifs, line);
-                        uint32_t num;
-                        std::istringstream iss(line);
-                        iss >> std::hex >> num;
-                        key_mem_[type][slot][offset] = num;
-                    }
+                if (i_str == "EMPTY")
+                    continue;
+                Slot &s = WriteSlot(type, slot);
+                s.status = SlotStatus::FULL;
+                for (uint32_t offset = 0; offset < KEY_MEM_OFFSET_NUM; offset++) {
+                    std::getline(ifs, line);
+                    uint32_t num;
+                    std::istringstream iss(line);
+                    iss >> std::hex >> num;
+                    s.data[offset] = num;
                 }
             }
         }
 
-        DebugInfo(VERBOSITY_LOW, "Finished loading Key Memory.");
-        DebugInfo(VERBOSITY_LOW, "\n");
+        DEBUG_INFO(this, VERBOSITY_LOW, "Finished loading Key Memory.");
+        DEBUG_INFO(this, VERBOSITY_LOW, "\n");
 
         ifs.close();
     } else
         throw std::runtime_error("Unable to open a file: " + path);
 }
 
+std::shared_ptr<const spect::KeyMemory::State> spect::KeyMemory::Snapshot()
+{
+    auto state = std::make_shared<State>();
+    UnlatchRamBuffer();
+    state->slots = slots_;
+    std::copy_n(ram_buffer_, KEY_MEM_OFFSET_NUM, state->ram_buffer);
+    return state;
+}
+
+void spect::KeyMemory::Restore(const State &state)
+{
+    slots_ = state.slots;
+    latched_.reset();
+    std::copy_n(state.ram_buffer, KEY_MEM_OFFSET_NUM, ram_buffer_);
+}
+
+void spect::KeyMemory::UnlatchRamBuffer()
+{
+    if (!latched_)
+        return;
+    std::copy_n(latched_->data, KEY_MEM_OFFSET_NUM, ram_buffer_);
+    latched_.reset();
+}
+
+const spect::KeyMemory::Slot* spect::KeyMemory::FindSlot(uint32_t type, uint32_t slot)
+{
+    auto it = slots_.find(type * KEY_MEM_SLOT_NUM + slot);
+    return (it == slots_.end()) ? nullptr : it->second.get();
+}
+
+spect::KeyMemory::Slot& spect::KeyMemory::WriteSlot(uint32_t type, uint32_t slot)
+{
+    std::shared_ptr<Slot> &s = slots_[type * KEY_MEM_SLOT_NUM + slot];
+
+    if (!s) {
+        s = std::make_shared<Slot>();
+        s->status = SlotStatus::EMPTY;
+        std::fill_n(s->data, KEY_MEM_OFFSET_NUM, 0xFFFFFFFF);
+    } else if (s.use_count() > 1) {
+        // Slot is shared with snapshot, modify own copy
+        s = std::make_shared<Slot>(*s);
+    }
+
+    return *s;
+}
+
 void spect::KeyMemory::PrintArgs()
 {
     printf("\n");
@@ -9,9 +9,19 @@
 #ifndef SPECT_LIB_KEY_MEMORY_H_
 #define SPECT_LIB_KEY_MEMORY_H_
 
+#include <map>
+#include <memory>
 #include <vector>
 #include <iostream>
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Key Memory
+//  Slots are allocated lazily. Slot which is not allocated is empty and erased (all 1s). Slot
+//  is allocated on first write, and released when erased, so memory and Dump / Load of
+//  sparse file cost only slots which are used. Allocated slots are shared copy-on-write by
+//  snapshots and by Key Memories restored from them.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
 class spect::KeyMemory
 {
     public:
@@ -101,15 +111,48 @@ class spect::KeyMemory
         ///////////////////////////////////////////////////////////////////////////////////////////
         /// @brief Dump Key Memory
         /// @param path File where to dump memory content
+        /// @param sparse False - Dump status of all slots
+        ///               True  - Dump only allocated slots (slots not in the file are empty)
         ///////////////////////////////////////////////////////////////////////////////////////////
-        void Dump(const std::string &path);
+        void Dump(const std::string &path, bool sparse = false);
 
         ///////////////////////////////////////////////////////////////////////////////////////////
         /// @brief Load Key Memory
-        /// @param path File from where to load memory content
+        /// @param path File from where to load memory content (full or sparse dump). Slots which
+        ///             are not in the file are empty.
         ///////////////////////////////////////////////////////////////////////////////////////////
         void Load(const std::string &path);
 
+        // Allocated slot
+        struct Slot {
+            SlotStatus status;
+            uint32_t data[KEY_MEM_OFFSET_NUM];
+        };
+
+        // Allocated slots indexed by (type * KEY_MEM_SLOT_NUM + slot)
+        typedef std::map<uint32_t, std::shared_ptr<Slot>> Slots;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        // Key Memory state saved by 'Snapshot'. Slots are shared with other snapshots (and with
+        // other Key Memories restored from them) until they are modified.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        struct State {
+            Slots slots;
+            uint32_t ram_buffer[KEY_MEM_OFFSET_NUM];
+        };
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Take snapshot of Key Memory
+        /// @returns Key Memory state
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        std::shared_ptr<const State> Snapshot();
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Restore Key Memory from snapshot
+        /// @param state Key Memory state taken by 'Snapshot' of this or other Key Memory
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void Restore(const State &state);
+
         ///////////////////////////////////////////////////////////////////////////////////////////
         /// @brief Print debug message in the model
         /// @param verbosity_level Verbosity of the message
@@ -132,14 +175,25 @@ class spect::KeyMemory
 
     private:
 
-        // Key memory
-        uint32_t key_mem_[KEY_MEM_TYPE_NUM][KEY_MEM_SLOT_NUM][KEY_MEM_OFFSET_NUM];
+        // Key memory, allocated slots only
+        Slots slots_;
 
         // RAM Buffer
-        uint32_t ram_buffer_[KEY_MEM_OFFSET_NUM];
+        uint32_t ram_buffer_[KEY_MEM_OFFSET_NUM] = {};
+
+        // Slot latched to RAM Buffer by 'Read', nullptr if RAM Buffer holds its own content.
+        // Slot is copied to RAM Buffer only when RAM Buffer is written or programmed. Latched
+        // slot is shared, so later writes to the slot copy it and latched content is kept.
+        std::shared_ptr<Slot> latched_;
+
+        // Copy latched slot to RAM Buffer
+        void UnlatchRamBuffer();
+
+        // Get allocated slot, nullptr if slot is not allocated (empty and erased)
+        const Slot* FindSlot(uint32_t type, uint32_t slot);
 
-        // Slot Status
-        SlotStatus slot_status_[KEY_MEM_TYPE_NUM][KEY_MEM_SLOT_NUM];
+        // Get slot for modification. Allocates the slot, or copies it when it is shared.
+        Slot& WriteSlot(uint32_t type, uint32_t slot);
 
         void PrintArgs();
 
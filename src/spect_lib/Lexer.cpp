@@ -0,0 +1,195 @@
+/**************************************************************************************************
+*
+* SPECT Compiler
+* Copyright (C) 2022-present Tropic Square
+*
+* @todo: License
+*
+**************************************************************************************************/
+
+#include <cassert>
+#include <cstring>
+
+#include "Lexer.h"
+
+static inline bool IsWordChar(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+static inline bool IsDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static inline bool IsHexDigit(char c)
+{
+    return IsDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+spect::Lexer::Lexer(const std::string &line)
+{
+    line_.reserve(line.size());
+
+    for (size_t i = 0; i < line.size(); i++) {
+        char c = line[i];
+
+        // Comment lasts till end of line
+        if (c == ';') {
+            while (i + 1 < line.size() && line[i + 1] != '\r' && line[i + 1] != '\n')
+                i++;
+            continue;
+        }
+
+        // Leading spaces
+        if (c == ' ' && tokens_.empty())
+            continue;
+
+        TokenType type;
+        if (IsWordChar(c))
+            type = TokenType::WORD;
+        else if (c == ' ')
+            type = TokenType::SPACE;
+        else if (c == '.')
+            type = TokenType::DIRECTIVE;
+        else if (c == ':')
+            type = TokenType::COLON;
+        else if (c == ',')
+            type = TokenType::COMMA;
+        else
+            type = TokenType::OTHER;
+
+        // Word characters extend words and directives, spaces extend spaces
+        if (!tokens_.empty()) {
+            Token &last = tokens_.back();
+            if (last.pos + last.len == line_.size() &&
+                ((type == TokenType::WORD && (last.type == TokenType::WORD ||
+                                              last.type == TokenType::DIRECTIVE)) ||
+                 (type == TokenType::SPACE && last.type == TokenType::SPACE))) {
+                line_.push_back(c);
+                last.len++;
+                continue;
+            }
+        }
+
+        tokens_.push_back({type, line_.size(), 1});
+        line_.push_back(c);
+    }
+
+    // Trailing spaces
+    if (!tokens_.empty() && tokens_.back().type == TokenType::SPACE)
+        tokens_.pop_back();
+}
+
+void spect::Lexer::Advance(size_t n)
+{
+    assert(n <= Remaining());
+    cursor_ += n;
+}
+
+void spect::Lexer::SkipSpaces()
+{
+    while (Match(0, TokenType::SPACE))
+        cursor_++;
+}
+
+bool spect::Lexer::Match(size_t i, TokenType type) const
+{
+    return i < Remaining() && tokens_[cursor_ + i].type == type;
+}
+
+bool spect::Lexer::Match(size_t i, TokenType type, const char *text) const
+{
+    if (!Match(i, type))
+        return false;
+
+    const Token &t = tokens_[cursor_ + i];
+    return t.len == std::strlen(text) && line_.compare(t.pos, t.len, text) == 0;
+}
+
+bool spect::Lexer::MatchIdent(size_t i) const
+{
+    return Match(i, TokenType::WORD) && !IsDigit(line_[tokens_[cursor_ + i].pos]);
+}
+
+size_t spect::Lexer::Find(TokenType type) const
+{
+    size_t i = 0;
+    while (i < Remaining() && !Match(i, type))
+        i++;
+    return i;
+}
+
+std::string spect::Lexer::Text(size_t i, size_t n) const
+{
+    if (n == 0)
+        return std::string("");
+
+    assert(i + n <= Remaining());
+    const Token &first = tokens_[cursor_ + i];
+    const Token &last = tokens_[cursor_ + i + n - 1];
+    return line_.substr(first.pos, last.pos + last.len - first.pos);
+}
+
+bool spect::Lexer::HasLineTerminator(size_t i) const
+{
+    for (; i < Remaining(); i++) {
+        const Token &t = tokens_[cursor_ + i];
+        if (t.type == TokenType::OTHER && (line_[t.pos] == '\r' || line_[t.pos] == '\n'))
+            return true;
+    }
+    return false;
+}
+
+bool spect::Lexer::IsIdent(const std::string &str)
+{
+    if (str.empty() || IsDigit(str[0]))
+        return false;
+    for (const char c : str)
+        if (!IsWordChar(c))
+            return false;
+    return true;
+}
+
+bool spect::Lexer::IsRegister(const std::string &str)
+{
+    return stogpr(str) >= 0;
+}
+
+bool spect::Lexer::IsNumber(const std::string &str)
+{
+    if (str.empty())
+        return false;
+
+    size_t first = 0;
+    bool (*is_digit)(char) = IsDigit;
+
+    if (str.size() > 2 && str[0] == '0' && str[1] == 'x') {
+        first = 2;
+        is_digit = IsHexDigit;
+    } else if (str.size() > 2 && str[0] == '0' && str[1] == 'b') {
+        first = 2;
+        is_digit = [](char c) { return c == '0' || c == '1'; };
+    }
+
+    for (size_t i = first; i < str.size(); i++)
+        if (!is_digit(str[i]))
+            return false;
+    return true;
+}
+
+bool spect::Lexer::IsValue(const std::string &str)
+{
+    // Any number of '0x' / '0b' prefixes followed by at least one hex digit. Prefix
+    // characters may be hex digits too ("0b"), so try hex digits after each prefix.
+    for (size_t first = 0; first < str.size(); first += 2) {
+        size_t i = first;
+        while (i < str.size() && IsHexDigit(str[i]))
+            i++;
+        if (i == str.size())
+            return true;
+        if (str.compare(first, 2, "0x") != 0 && str.compare(first, 2, "0b") != 0)
+            return false;
+    }
+    return false;
+}
@@ -0,0 +1,163 @@
+/**************************************************************************************************
+*
+* SPECT Compiler
+* Copyright (C) 2022-present Tropic Square
+*
+* @todo: License
+*
+**************************************************************************************************/
+
+#ifndef SPECT_LIB_LEXER_H_
+#define SPECT_LIB_LEXER_H_
+
+#include <string>
+#include <vector>
+
+#include "spect.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Tokenizer of single line of SPECT assembly
+//  Line is split to tokens in single pass by constructor. Comments (';' till end of line) are
+//  dropped, leading and trailing spaces are not part of any token. Tokens are:
+//      WORD        - Run of [a-zA-Z0-9_] characters (identifier, register, mnemonic, number)
+//      DIRECTIVE   - '.' followed by run of WORD characters (.eq, .include, .ifdef, ...)
+//      SPACE       - Run of ' ' characters
+//      COLON       - ':'
+//      COMMA       - ','
+//      OTHER       - Any other single character
+//
+//  Compiler consumes tokens from the cursor. Token positions passed to query functions
+//  are relative to the cursor.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+class spect::Lexer
+{
+    public:
+
+        enum class TokenType {
+            WORD,
+            DIRECTIVE,
+            SPACE,
+            COLON,
+            COMMA,
+            OTHER
+        };
+
+        struct Token {
+            TokenType type;
+            size_t pos;
+            size_t len;
+        };
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief New Lexer constructor. Tokenizes the line.
+        /// @param line Line of SPECT assembly source file
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        Lexer(const std::string &line);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @returns Number of tokens from cursor till end of line
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        size_t Remaining() const
+        {
+            return tokens_.size() - cursor_;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @returns true if there are no tokens left
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        bool Empty() const
+        {
+            return cursor_ == tokens_.size();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Move cursor forward
+        /// @param n Number of tokens to skip
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void Advance(size_t n = 1);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Move cursor over SPACE tokens
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void SkipSpaces();
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Check type of token
+        /// @param i Index of token (relative to cursor)
+        /// @param type Expected token type
+        /// @returns true if token exists and is of 'type'
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        bool Match(size_t i, TokenType type) const;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Check type and text of token
+        /// @param i Index of token (relative to cursor)
+        /// @param type Expected token type
+        /// @param text Expected text of token
+        /// @returns true if token exists, is of 'type' and its text equals to 'text'
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        bool Match(size_t i, TokenType type, const char *text) const;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Check if token is an identifier
+        /// @param i Index of token (relative to cursor)
+        /// @returns true if token exists and is a WORD which does not start with a digit
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        bool MatchIdent(size_t i) const;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Find first token of given type
+        /// @param type Token type to find
+        /// @returns Index of token (relative to cursor), 'Remaining()' if not found
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        size_t Find(TokenType type) const;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Get text of tokens
+        /// @param i Index of first token (relative to cursor)
+        /// @param n Number of tokens
+        /// @returns Text of 'n' consecutive tokens
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        std::string Text(size_t i, size_t n = 1) const;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Check for line terminators (CR, LF) which are part of tokens
+        /// @param i Index of first token checked (relative to cursor)
+        /// @returns true if any token from 'i' till end of line contains line terminator
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        bool HasLineTerminator(size_t i) const;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @returns true if 'str' is an identifier ([a-zA-Z_][a-zA-Z_0-9]*)
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        static bool IsIdent(const std::string &str);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @returns true if 'str' is register operand (R0 ... R31, r0 ... r31)
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        static bool IsRegister(const std::string &str);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @returns true if 'str' is numeric literal (0x<hex>, 0b<bin> or <dec>)
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        static bool IsNumber(const std::string &str);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @returns true if 'str' is value of constant (any '0x'/'0b' prefixes followed by hex
+        ///          digits)
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        static bool IsValue(const std::string &str);
+
+    private:
+        // Line without comments
+        std::string line_;
+
+        // Tokens of the line
+        std::vector<Token> tokens_;
+
+        // Index of first unconsumed token
+        size_t cursor_ = 0;
+};
+
+#endif
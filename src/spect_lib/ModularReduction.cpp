@@ -0,0 +1,373 @@
+/**************************************************************************************************
+*
+* SPECT Compiler
+* Copyright (C) 2022-present Tropic Square
+*
+* @todo: License
+*
+**************************************************************************************************/
+
+#include "spect.h"
+#include "ModularReduction.h"
+
+spect::ModularReduction::ModularReduction() :
+    modulus_(0U)
+{}
+
+const uint256_t& spect::ModularReduction::GetModulus() const
+{
+    return modulus_;
+}
+
+#if defined(__SIZEOF_INT128__)
+
+typedef unsigned __int128 uint128_t;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Number of 32-bit limbs in uint256_t and number of 64-bit words in 256 bit value
+///////////////////////////////////////////////////////////////////////////////////////////////////
+#define LIMBS_32 8
+#define WORDS_64 4
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Convert uint256_t (32-bit limbs, LS limb first) to 64-bit words (LS word first)
+///////////////////////////////////////////////////////////////////////////////////////////////////
+static inline void to_words(const uint256_t &val, uint64_t *w)
+{
+    const auto &limbs = val.crepresentation();
+    for (int i = 0; i < WORDS_64; i++)
+        w[i] = uint64_t(limbs[2 * i]) | (uint64_t(limbs[2 * i + 1]) << 32);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Convert 64-bit words (LS word first) to uint256_t
+///////////////////////////////////////////////////////////////////////////////////////////////////
+static inline uint256_t from_words(const uint64_t *w)
+{
+    uint256_t rv;
+    auto &limbs = rv.representation();
+    for (int i = 0; i < WORDS_64; i++) {
+        limbs[2 * i]     = uint32_t(w[i]);
+        limbs[2 * i + 1] = uint32_t(w[i] >> 32);
+    }
+    return rv;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Full 256 x 256 -> 512 bit multiplication
+/// @param a First operand (4 words)
+/// @param b Second operand (4 words)
+/// @param t Product (8 words)
+///////////////////////////////////////////////////////////////////////////////////////////////////
+static inline void mul_256x256(const uint64_t *a, const uint64_t *b, uint64_t *t)
+{
+    for (int i = 0; i < 2 * WORDS_64; i++)
+        t[i] = 0;
+
+    for (int i = 0; i < WORDS_64; i++) {
+        uint64_t carry = 0;
+        for (int j = 0; j < WORDS_64; j++) {
+            uint128_t acc = uint128_t(a[i]) * b[j] + t[i + j] + carry;
+            t[i + j] = uint64_t(acc);
+            carry = uint64_t(acc >> 64);
+        }
+        t[i + WORDS_64] = carry;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Barrett reduction with fixed 2^512 shift:
+//  mu = floor((2^512 - 1) / m), q = floor(x * mu / 2^512)
+//  q is at most 2 below floor(x / m) for any x < 2^512, so r = x - q * m < 3 * m and at most
+//  two final subtractions are needed.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void spect::ModularReduction::SetModulus(const uint256_t &modulus)
+{
+    modulus_ = modulus;
+    barrett_ = (modulus > 1U);
+    if (!barrett_)
+        return;
+
+    uint512_t mu = (~uint512_t(0U)) / uint512_t(modulus);
+    const auto &limbs = mu.crepresentation();
+    mu_len_ = 0;
+    for (int i = 0; i < 2 * WORDS_64; i++) {
+        mu_[i] = uint64_t(limbs[2 * i]) | (uint64_t(limbs[2 * i + 1]) << 32);
+        if (mu_[i])
+            mu_len_ = i + 1;
+    }
+    to_words(modulus, mod_);
+}
+
+uint256_t spect::ModularReduction::Reduce(const uint512_t &val) const
+{
+    if (!barrett_)
+        return uint256_t(val % uint512_t(modulus_));
+
+    uint64_t x[2 * WORDS_64];
+    const auto &limbs = val.crepresentation();
+    for (int i = 0; i < 2 * WORDS_64; i++)
+        x[i] = uint64_t(limbs[2 * i]) | (uint64_t(limbs[2 * i + 1]) << 32);
+
+    return ReduceWords(x);
+}
+
+uint256_t spect::ModularReduction::MulMod(const uint256_t &a, const uint256_t &b) const
+{
+    if (!barrett_)
+        return uint256_t((uint512_t(a) * uint512_t(b)) % uint512_t(modulus_));
+
+    uint64_t aw[WORDS_64], bw[WORDS_64], x[2 * WORDS_64];
+    to_words(a, aw);
+    to_words(b, bw);
+    mul_256x256(aw, bw, x);
+
+    return ReduceWords(x);
+}
+
+uint256_t spect::ModularReduction::ReduceWords(const uint64_t *x) const
+{
+    // q = upper half of x * mu
+    uint64_t t[4 * WORDS_64] = {};
+    for (int i = 0; i < mu_len_; i++) {
+        uint64_t carry = 0;
+        for (int j = 0; j < 2 * WORDS_64; j++) {
+            uint128_t acc = uint128_t(mu_[i]) * x[j] + t[i + j] + carry;
+            t[i + j] = uint64_t(acc);
+            carry = uint64_t(acc >> 64);
+        }
+        t[i + 2 * WORDS_64] = carry;
+    }
+    const uint64_t *q = &t[2 * WORDS_64];
+
+    // r < 3 * m fits to 5 words, so q * m and x - q * m are only needed modulo 2^320
+    const int r_words = WORDS_64 + 1;
+    uint64_t qm[r_words] = {};
+    for (int i = 0; i < r_words; i++) {
+        uint64_t carry = 0;
+        for (int j = 0; j < WORDS_64 && i + j < r_words; j++) {
+            uint128_t acc = uint128_t(q[i]) * mod_[j] + qm[i + j] + carry;
+            qm[i + j] = uint64_t(acc);
+            carry = uint64_t(acc >> 64);
+        }
+        if (i == 0)
+            qm[WORDS_64] = carry;
+    }
+
+    uint64_t r[r_words];
+    uint64_t borrow = 0;
+    for (int i = 0; i < r_words; i++) {
+        uint128_t d = uint128_t(x[i]) - qm[i] - borrow;
+        r[i] = uint64_t(d);
+        borrow = (d >> 64) ? 1 : 0;
+    }
+
+    while (true) {
+        bool ge_m = (r[WORDS_64] != 0);
+        if (!ge_m) {
+            ge_m = true;
+            for (int i = WORDS_64 - 1; i >= 0; i--) {
+                if (r[i] != mod_[i]) {
+                    ge_m = (r[i] > mod_[i]);
+                    break;
+                }
+            }
+        }
+        if (!ge_m)
+            break;
+
+        borrow = 0;
+        for (int i = 0; i < r_words; i++) {
+            uint64_t m_word = (i < WORDS_64) ? mod_[i] : 0;
+            uint128_t d = uint128_t(r[i]) - m_word - borrow;
+            r[i] = uint64_t(d);
+            borrow = (d >> 64) ? 1 : 0;
+        }
+    }
+
+    return from_words(r);
+}
+
+uint256_t spect::ModularReduction::MulModP25519(const uint256_t &a, const uint256_t &b)
+{
+    uint64_t aw[WORDS_64], bw[WORDS_64], t[2 * WORDS_64];
+    to_words(a, aw);
+    to_words(b, bw);
+    mul_256x256(aw, bw, t);
+
+    // 2^256 = 38 (mod p): r = T[255:0] + 38 * T[511:256]
+    uint64_t r[WORDS_64];
+    uint64_t carry = 0;
+    for (int i = 0; i < WORDS_64; i++) {
+        uint128_t acc = uint128_t(t[i + WORDS_64]) * 38 + t[i] + carry;
+        r[i] = uint64_t(acc);
+        carry = uint64_t(acc >> 64);
+    }
+
+    // Fold carry (< 39) the same way. Carry out of this fold can occur only when r is
+    // very small afterwards, so second fold can't overflow.
+    for (int k = 0; k < 2 && carry; k++) {
+        uint128_t acc = uint128_t(carry) * 38;
+        for (int i = 0; i < WORDS_64; i++) {
+            acc += r[i];
+            r[i] = uint64_t(acc);
+            acc >>= 64;
+        }
+        carry = uint64_t(acc);
+    }
+
+    // 2^255 = 19 (mod p): r < 2^255 + 19 after this fold
+    uint64_t top = r[3] >> 63;
+    r[3] &= 0x7FFFFFFFFFFFFFFFULL;
+    uint128_t acc = uint128_t(top) * 19;
+    for (int i = 0; i < WORDS_64; i++) {
+        acc += r[i];
+        r[i] = uint64_t(acc);
+        acc >>= 64;
+    }
+
+    // Final conditional subtraction: r >= p <=> r + 19 >= 2^255
+    uint64_t s[WORDS_64];
+    acc = 19;
+    for (int i = 0; i < WORDS_64; i++) {
+        acc += r[i];
+        s[i] = uint64_t(acc);
+        acc >>= 64;
+    }
+    if (s[3] >> 63) {
+        s[3] &= 0x7FFFFFFFFFFFFFFFULL;
+        return from_words(s);
+    }
+    return from_words(r);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// NIST P256 fast reduction (FIPS 186-4, D.2.3)
+//  Product is split to 32-bit words c0 - c15. Result is:
+//      s1 + 2*s2 + 2*s3 + s4 + s5 - s6 - s7 - s8 - s9 (mod p)
+//  where each s<n> is 256 bit number composed of words c0 - c15. Table holds index of word 'c'
+//  placed at each 32-bit word (LS word first) of s<n>, -1 stands for zero word.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+static const int p256_terms[9][LIMBS_32] = {
+    {  0,  1,  2,  3,  4,  5,  6,  7 },     // s1
+    { -1, -1, -1, 11, 12, 13, 14, 15 },     // s2
+    { -1, -1, -1, 12, 13, 14, 15, -1 },     // s3
+    {  8,  9, 10, -1, -1, -1, 14, 15 },     // s4
+    {  9, 10, 11, 13, 14, 15, 13,  8 },     // s5
+    { 11, 12, 13, -1, -1, -1,  8, 10 },     // s6
+    { 12, 13, 14, 15, -1, -1,  9, 11 },     // s7
+    { 13, 14, 15,  8,  9, 10, -1, 12 },     // s8
+    { 14, 15, -1,  9, 10, 11, -1, 13 },     // s9
+};
+
+static const int p256_coefs[9] = { 1, 2, 2, 1, 1, -1, -1, -1, -1 };
+
+static const uint32_t p256_limbs[LIMBS_32] = {
+    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x00000000,
+    0x00000000, 0x00000000, 0x00000001, 0xFFFFFFFF
+};
+
+uint256_t spect::ModularReduction::MulModP256(const uint256_t &a, const uint256_t &b)
+{
+    uint64_t aw[WORDS_64], bw[WORDS_64], t[2 * WORDS_64];
+    to_words(a, aw);
+    to_words(b, bw);
+    mul_256x256(aw, bw, t);
+
+    uint32_t c[2 * LIMBS_32];
+    for (int i = 0; i < 2 * WORDS_64; i++) {
+        c[2 * i]     = uint32_t(t[i]);
+        c[2 * i + 1] = uint32_t(t[i] >> 32);
+    }
+
+    // Signed sum of terms, word by word, with carry propagation
+    uint32_t r[LIMBS_32];
+    int64_t carry = 0;
+    for (int j = 0; j < LIMBS_32; j++) {
+        int64_t acc = carry;
+        for (int k = 0; k < 9; k++) {
+            int idx = p256_terms[k][j];
+            if (idx >= 0)
+                acc += p256_coefs[k] * int64_t(c[idx]);
+        }
+        r[j] = uint32_t(acc);
+        carry = (acc - int64_t(r[j])) >> 32;
+    }
+
+    // Result is carry * 2^256 + r, with carry within (-5, 7). Bring to [0, p)
+    while (true) {
+        bool ge_p = (carry > 0);
+        if (carry == 0) {
+            ge_p = true;
+            for (int j = LIMBS_32 - 1; j >= 0; j--) {
+                if (r[j] != p256_limbs[j]) {
+                    ge_p = (r[j] > p256_limbs[j]);
+                    break;
+                }
+            }
+        }
+
+        if (carry < 0) {
+            int64_t acc = 0;
+            for (int j = 0; j < LIMBS_32; j++) {
+                acc += int64_t(r[j]) + int64_t(p256_limbs[j]);
+                r[j] = uint32_t(acc);
+                acc >>= 32;
+            }
+            carry += acc;
+        } else if (ge_p) {
+            int64_t acc = 0;
+            for (int j = 0; j < LIMBS_32; j++) {
+                acc += int64_t(r[j]) - int64_t(p256_limbs[j]);
+                r[j] = uint32_t(acc);
+                acc >>= 32;
+            }
+            carry += acc;
+        } else {
+            break;
+        }
+    }
+
+    uint256_t rv;
+    auto &limbs = rv.representation();
+    for (int j = 0; j < LIMBS_32; j++)
+        limbs[j] = r[j];
+    return rv;
+}
+
+#else
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// No 128-bit integer support, use generic reduction
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void spect::ModularReduction::SetModulus(const uint256_t &modulus)
+{
+    modulus_ = modulus;
+}
+
+uint256_t spect::ModularReduction::Reduce(const uint512_t &val) const
+{
+    return uint256_t(val % uint512_t(modulus_));
+}
+
+uint256_t spect::ModularReduction::MulMod(const uint256_t &a, const uint256_t &b) const
+{
+    return uint256_t((uint512_t(a) * uint512_t(b)) % uint512_t(modulus_));
+}
+
+uint256_t spect::ModularReduction::MulModP25519(const uint256_t &a, const uint256_t &b)
+{
+    static const uint512_t p = (uint512_t(1U) << 255) - 19U;
+    return uint256_t((uint512_t(a) * uint512_t(b)) % p);
+}
+
+uint256_t spect::ModularReduction::MulModP256(const uint256_t &a, const uint256_t &b)
+{
+    static const uint512_t p = (uint512_t(1U) << 256) - (uint512_t(1U) << 224) +
+                               (uint512_t(1U) << 192) + (uint512_t(1U) << 96) - 1U;
+    return uint256_t((uint512_t(a) * uint512_t(b)) % p);
+}
+
+#endif
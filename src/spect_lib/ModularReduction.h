@@ -0,0 +1,95 @@
+/**************************************************************************************************
+*
+* SPECT Compiler
+* Copyright (C) 2022-present Tropic Square
+*
+* @todo: License
+*
+**************************************************************************************************/
+
+#ifndef SPECT_LIB_MODULAR_REDUCTION_H_
+#define SPECT_LIB_MODULAR_REDUCTION_H_
+
+#include "spect.h"
+
+class spect::ModularReduction
+{
+    public:
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Modular reduction context constructor. Modulus is set to 0 (no context).
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        ModularReduction();
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Set modulus and pre-compute Barrett constant for it.
+        /// @param modulus Modulus for subsequent reductions
+        /// @note Modulus 0 and 1 have no Barrett context, reduction falls back to generic '%'.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void SetModulus(const uint256_t &modulus);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @returns Modulus of the reduction context
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        const uint256_t& GetModulus() const;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Reduce value by modulus of the context
+        /// @param val Value to reduce (any 512 bit value)
+        /// @returns val mod modulus
+        /// @note Result is bit-identical to generic 'val % modulus'.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        uint256_t Reduce(const uint512_t &val) const;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Modular multiplication by modulus of the context
+        /// @param a First operand (any 256 bit value)
+        /// @param b Second operand (any 256 bit value)
+        /// @returns (a * b) mod modulus
+        /// @note Result is bit-identical to generic '(uint512_t(a) * b) % modulus'.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        uint256_t MulMod(const uint256_t &a, const uint256_t &b) const;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Modular multiplication by P25519 prime (2^255 - 19)
+        /// @param a First operand (any 256 bit value)
+        /// @param b Second operand (any 256 bit value)
+        /// @returns (a * b) mod P25519
+        /// @note Result is bit-identical to generic '(uint512_t(a) * b) % P25519'. Operands
+        ///       are not required to be reduced.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        static uint256_t MulModP25519(const uint256_t &a, const uint256_t &b);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Modular multiplication by NIST P256 prime (2^256 - 2^224 + 2^192 + 2^96 - 1)
+        /// @param a First operand (any 256 bit value)
+        /// @param b Second operand (any 256 bit value)
+        /// @returns (a * b) mod P256
+        /// @note Result is bit-identical to generic '(uint512_t(a) * b) % P256'. Operands
+        ///       are not required to be reduced.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        static uint256_t MulModP256(const uint256_t &a, const uint256_t &b);
+
+    private:
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Barrett reduction of 512 bit value given as 64-bit words (LS word first)
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        uint256_t ReduceWords(const uint64_t *x) const;
+
+        // Modulus
+        uint256_t modulus_;
+
+        // True - Barrett context below is valid, False - Use generic reduction
+        bool barrett_ = false;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        // Barrett context, 64-bit words, LS word first:
+        //  mu_     - floor((2^512 - 1) / modulus)
+        //  mu_len_ - Number of non-zero words of mu_
+        //  mod_    - Modulus
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        uint64_t mu_[8];
+        int mu_len_ = 0;
+        uint64_t mod_[4];
+};
+
+#endif
@@ -0,0 +1,143 @@
+/**************************************************************************************************
+*
+* SPECT Compiler
+* Copyright (C) 2022-present Tropic Square
+*
+* @todo: License
+*
+**************************************************************************************************/
+
+#ifndef SPECT_LIB_PERFECT_HASH_H_
+#define SPECT_LIB_PERFECT_HASH_H_
+
+#include <stdexcept>
+#include <string>
+
+#include "spect.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Perfect hash of fixed set of strings
+//  Built at compile time from array of string literals (instruction mnemonics, register names
+//  generated by CMake). Constructor searches for hash seed which maps each key to different
+//  slot of the table. Lookup then costs single hash and single string compare.
+//
+//  Object shall be declared 'constexpr', so that the seed search runs during compilation.
+//  Duplicate keys make the search fail, which is reported as compile error.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace spect {
+    // Number of slots of perfect hash table for 'n' keys (power of two)
+    constexpr size_t PerfectHashSize(size_t n)
+    {
+        size_t size = 1;
+        while (size < 8 * n)
+            size <<= 1;
+        return size;
+    }
+}
+
+template <size_t N>
+class spect::PerfectHash
+{
+    public:
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Perfect hash constructor
+        /// @param keys Unique keys, not copied (shall be string literals)
+        /// @throws std::logic_error when no perfect hash is found for 'keys'
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        constexpr PerfectHash(const char *const (&keys)[N]) :
+            keys_(),
+            seed_(0),
+            slots_()
+        {
+            for (size_t i = 0; i < N; i++)
+                keys_[i] = keys[i];
+
+            for (uint32_t seed = 0; seed < MAX_SEED; seed++) {
+                if (Build(seed)) {
+                    seed_ = seed;
+                    return;
+                }
+            }
+            throw std::logic_error("Perfect hash not found, keys are not unique!");
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Find key
+        /// @param str String to search for
+        /// @param len Length of 'str'
+        /// @returns Index of key equal to 'str' in array passed to constructor, -1 if 'str' is
+        ///          none of the keys.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        int Find(const char *str, size_t len) const
+        {
+            int i = slots_[Hash(str, len, seed_) & (SIZE - 1)];
+            if (i < 0)
+                return -1;
+
+            const char *key = keys_[i];
+            for (size_t j = 0; j < len; j++)
+                if (key[j] == '\0' || key[j] != str[j])
+                    return -1;
+
+            return (key[len] == '\0') ? i : -1;
+        }
+
+        int Find(const std::string &str) const
+        {
+            return Find(str.data(), str.size());
+        }
+
+    private:
+
+        // Table size, at least 8 slots per key keeps the seed search short
+        static constexpr size_t SIZE = spect::PerfectHashSize(N);
+        static constexpr uint32_t MAX_SEED = 4096;
+
+        // Seeded FNV-1a with final mixing of low bits (used as slot index)
+        static constexpr uint32_t Hash(const char *str, size_t len, uint32_t seed)
+        {
+            uint32_t h = 2166136261u ^ (seed * 0x9E3779B9u);
+            for (size_t i = 0; i < len; i++)
+                h = (h ^ static_cast<uint8_t>(str[i])) * 16777619u;
+            h ^= h >> 16;
+            h *= 0x7FEB352Du;
+            h ^= h >> 15;
+            return h;
+        }
+
+        static constexpr size_t Length(const char *str)
+        {
+            size_t len = 0;
+            while (str[len] != '\0')
+                len++;
+            return len;
+        }
+
+        // Place all keys with 'seed', returns false on collision
+        constexpr bool Build(uint32_t seed)
+        {
+            for (size_t i = 0; i < SIZE; i++)
+                slots_[i] = -1;
+
+            for (size_t i = 0; i < N; i++) {
+                size_t slot = Hash(keys_[i], Length(keys_[i]), seed) & (SIZE - 1);
+                if (slots_[slot] >= 0)
+                    return false;
+                slots_[slot] = static_cast<int16_t>(i);
+            }
+            return true;
+        }
+
+        // Keys (pointers to string literals)
+        const char *keys_[N];
+
+        // Seed of the hash
+        uint32_t seed_;
+
+        // Index of key placed in each slot, -1 for empty slot
+        int16_t slots_[SIZE];
+};
+
+#endif
@@ -0,0 +1,132 @@
+/**************************************************************************************************
+*
+* SPECT Compiler
+* Copyright (C) 2022-present Tropic Square
+*
+* @todo: License
+*
+**************************************************************************************************/
+
+#include <cassert>
+#include <vector>
+
+#include "ProgramImage.h"
+
+#include "Compiler.h"
+#include "CpuProgram.h"
+#include "HexHandler.h"
+#include "Instruction.h"
+#include "Symbol.h"
+#include "SymbolTable.h"
+
+spect::ProgramImage::ProgramImage(int isa_version, ParityType parity_type) :
+    isa_version_(isa_version),
+    parity_type_(parity_type)
+{
+    assert(isa_version > 0 && isa_version <= NUM_ISA_VERSIONS);
+
+    instr_mem_pages_ = instr_mem_.Snapshot();
+    const_rom_pages_ = const_rom_.Snapshot();
+    Decode();
+}
+
+spect::ProgramImage::~ProgramImage()
+{
+    for (int i = 0; i < (SPECT_INSTR_MEM_SIZE / 4); i++)
+        delete instr_[i];
+    delete compiler_;
+}
+
+void spect::ProgramImage::LoadProgram(const std::string &path, uint32_t first_addr)
+{
+    delete compiler_;
+    compiler_ = new spect::Compiler(isa_version_);
+    compiler_->CompileInit(first_addr);
+    compiler_->Compile(path);
+    compiler_->CompileFinish();
+
+    // Program is assembled to whole memory space, only Instruction memory is kept
+    std::vector<uint32_t> mem(SPECT_TOTAL_MEM_SIZE / 4, 0);
+    compiler_->program_->Assemble(mem.data() + (first_addr >> 2), parity_type_);
+    instr_mem_.Write(0, mem.data() + (SPECT_INSTR_MEM_BASE >> 2), SPECT_INSTR_MEM_SIZE / 4);
+    instr_mem_pages_ = instr_mem_.Snapshot();
+
+    if (compiler_->symbols_->IsDefined(START_SYMBOL))
+        start_pc_ = compiler_->symbols_->GetSymbol(START_SYMBOL)->val_;
+
+    Decode();
+}
+
+void spect::ProgramImage::LoadInstrMemHex(const std::string &path)
+{
+    std::vector<uint32_t> mem(SPECT_TOTAL_MEM_SIZE / 4, 0);
+    spect::HexHandler::LoadHexFile(path, mem.data(), SPECT_INSTR_MEM_BASE);
+    instr_mem_.Write(0, mem.data() + (SPECT_INSTR_MEM_BASE >> 2), SPECT_INSTR_MEM_SIZE / 4);
+    instr_mem_pages_ = instr_mem_.Snapshot();
+
+    Decode();
+}
+
+void spect::ProgramImage::LoadConstRomHex(const std::string &path)
+{
+    std::vector<uint32_t> mem(SPECT_TOTAL_MEM_SIZE / 4, 0);
+    spect::HexHandler::LoadHexFile(path, mem.data(), SPECT_CONST_ROM_BASE);
+    const_rom_.Write(0, mem.data() + (SPECT_CONST_ROM_BASE >> 2), SPECT_CONST_ROM_SIZE / 4);
+    const_rom_pages_ = const_rom_.Snapshot();
+}
+
+int spect::ProgramImage::GetIsaVersion() const
+{
+    return isa_version_;
+}
+
+spect::ParityType spect::ProgramImage::GetParityType() const
+{
+    return parity_type_;
+}
+
+uint16_t spect::ProgramImage::GetStartPc() const
+{
+    return start_pc_;
+}
+
+spect::SymbolTable* spect::ProgramImage::GetSymbols() const
+{
+    return compiler_ ? compiler_->symbols_ : nullptr;
+}
+
+const spect::CowMemory::Pages& spect::ProgramImage::GetInstrMem() const
+{
+    return instr_mem_pages_;
+}
+
+const spect::CowMemory::Pages& spect::ProgramImage::GetConstRom() const
+{
+    return const_rom_pages_;
+}
+
+uint32_t spect::ProgramImage::GetInstrMemWord(int index) const
+{
+    return instr_mem_.Read(index);
+}
+
+spect::Instruction* spect::ProgramImage::GetInstruction(int index) const
+{
+    return instr_[index];
+}
+
+const spect::FastEngine::DecodedPage* spect::ProgramImage::GetDecodedPage(int page) const
+{
+    return &decoded_pages_[page];
+}
+
+void spect::ProgramImage::Decode()
+{
+    for (int i = 0; i < (SPECT_INSTR_MEM_SIZE / 4); i++) {
+        delete instr_[i];
+        instr_[i] = spect::Instruction::DisAssemble(isa_version_, parity_type_, instr_mem_.Read(i));
+    }
+
+    for (int i = 0; i < (SPECT_INSTR_MEM_SIZE / 4 / SPECT_SNAPSHOT_PAGE_SIZE); i++)
+        FastEngine::BuildPage(decoded_pages_[i], &instr_[i * SPECT_SNAPSHOT_PAGE_SIZE]);
+}
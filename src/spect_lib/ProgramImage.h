@@ -0,0 +1,153 @@
+/**************************************************************************************************
+*
+* SPECT Compiler
+* Copyright (C) 2022-present Tropic Square
+*
+* @todo: License
+*
+**************************************************************************************************/
+
+#ifndef SPECT_LIB_PROGRAM_IMAGE_H_
+#define SPECT_LIB_PROGRAM_IMAGE_H_
+
+#include <string>
+
+#include "spect.h"
+#include "CowMemory.h"
+#include "FastEngine.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Program image
+//  Holds program compiled (or loaded) once: content of Instruction memory and Constant ROM,
+//  symbol table, start address, each word of Instruction memory pre-decoded to instruction and
+//  each page of Instruction memory decoded for fast engine (FastEngine::DecodedPage).
+//
+//  Image is built by Load* functions and then attached read-only to any number of models
+//  (CpuModel::SetProgramImage), typically via std::shared_ptr<const ProgramImage>. Memory
+//  content is held as copy-on-write pages which models share, model copies only page it
+//  writes to. Models execute pre-decoded instructions and decoded pages of the image on pages
+//  they share with it. Const functions do not modify the image, and can be called from
+//  multiple threads at the same time.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+class spect::ProgramImage
+{
+    public:
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Program image constructor. Creates empty image (all memory words zero).
+        /// @param isa_version SPECT ISA version of the program
+        /// @param parity_type Parity of Instruction memory words
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        ProgramImage(int isa_version, ParityType parity_type);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Program image destructor
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        ~ProgramImage();
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Compile program and place it to Instruction memory of the image
+        /// @param path Path to .s file with the program
+        /// @param first_addr Address of first instruction of the program
+        /// @throws std::system_error on compilation error
+        /// @note Start address is set to address of '_start' symbol.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void LoadProgram(const std::string &path, uint32_t first_addr);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Load assembled program to Instruction memory of the image
+        /// @param path Path to .hex file. Non-addressed file is placed from start of Instruction
+        ///             memory.
+        /// @throws std::runtime_error when file can't be loaded
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void LoadInstrMemHex(const std::string &path);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Load Constant ROM content of the image
+        /// @param path Path to .hex file. Non-addressed file is placed from start of Constant ROM.
+        /// @throws std::runtime_error when file can't be loaded
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void LoadConstRomHex(const std::string &path);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @returns SPECT ISA version of the program
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        int GetIsaVersion() const;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @returns Parity type of Instruction memory words
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        ParityType GetParityType() const;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @returns Address of first instruction to be executed
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        uint16_t GetStartPc() const;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @returns Symbol table of compiled program, nullptr if program was loaded from .hex file
+        /// @note Symbol table shall be only queried (GetSymbol, IsDefined, Print).
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        SymbolTable* GetSymbols() const;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @returns Pages with content of Instruction memory (SPECT_INSTR_MEM_SIZE bytes)
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        const CowMemory::Pages& GetInstrMem() const;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @returns Pages with content of Constant ROM (SPECT_CONST_ROM_SIZE bytes)
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        const CowMemory::Pages& GetConstRom() const;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @param index Index of word within Instruction memory
+        /// @returns Word of Instruction memory
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        uint32_t GetInstrMemWord(int index) const;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @param index Index of word within Instruction memory
+        /// @returns Instruction pre-decoded from the word, nullptr if word is not valid
+        ///          instruction. Instruction is owned by the image.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        Instruction* GetInstruction(int index) const;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @param page Index of page (SPECT_SNAPSHOT_PAGE_SIZE words) within Instruction memory
+        /// @returns Page decoded for fast engine
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        const FastEngine::DecodedPage* GetDecodedPage(int page) const;
+
+    private:
+        // Pre-decode all words of Instruction memory
+        void Decode();
+
+        // SPECT ISA version of the program
+        const int isa_version_;
+
+        // Parity type of Instruction memory words
+        const ParityType parity_type_;
+
+        // Address of first instruction to be executed
+        uint16_t start_pc_ = SPECT_INSTR_MEM_BASE;
+
+        // Compiler which compiled the program (holds symbol table), nullptr for .hex program
+        Compiler *compiler_ = nullptr;
+
+        // Content of Instruction memory and its pages shared with models
+        CowMemory instr_mem_{SPECT_INSTR_MEM_SIZE / 4, SPECT_SNAPSHOT_PAGE_SIZE};
+        CowMemory::Pages instr_mem_pages_;
+
+        // Content of Constant ROM and its pages shared with models
+        CowMemory const_rom_{SPECT_CONST_ROM_SIZE / 4, SPECT_SNAPSHOT_PAGE_SIZE};
+        CowMemory::Pages const_rom_pages_;
+
+        // Pre-decoded Instruction memory, single entry for each word
+        Instruction *instr_[SPECT_INSTR_MEM_SIZE / 4] = {};
+
+        // Instruction memory decoded for fast engine
+        FastEngine::DecodedPage decoded_pages_[SPECT_INSTR_MEM_SIZE / 4 / SPECT_SNAPSHOT_PAGE_SIZE];
+};
+
+#endif
@@ -6,6 +6,7 @@
 ** Author: Ondrej Ille
 **************************************************************************************************/
 
+#include <algorithm>
 #include <cassert>
 
 #include "Symbol.h"
@@ -16,65 +17,135 @@ spect::SymbolTable::SymbolTable()
 
 spect::SymbolTable::~SymbolTable()
 {
-    for (const auto &sym : symbol_map_)
-        delete sym.second;
+    for (const auto &sym : symbols_)
+        delete sym;
+}
+
+spect::Symbol* spect::SymbolTable::InsertSymbol(spect::Symbol *s)
+{
+    symbols_.push_back(s);
+
+    // Re-defined symbol replaces previous one (which stays owned by the table)
+    symbol_map_.erase(s->identifier_);
+    symbol_map_[s->identifier_] = s;
+
+    std::lock_guard<std::mutex> lock(addr_index_mutex_);
+    addr_index_valid_ = false;
+
+    return s;
 }
 
 spect::Symbol* spect::SymbolTable::AddSymbol(std::string identifier, spect::SymbolType type, int line_nr)
 {
-    std::cout << "Adding symbol: " << identifier << std::endl;
-    symbol_map_[identifier] = new spect::Symbol(identifier, type, curr_file_, line_nr);
-    return symbol_map_[identifier];
+    if (verbose_)
+        std::cout << "Adding symbol: " << identifier << std::endl;
+    return InsertSymbol(new spect::Symbol(identifier, type, curr_file_, line_nr));
 }
 
 spect::Symbol* spect::SymbolTable::AddSymbol(std::string identifier, spect::SymbolType type, uint32_t val, int line_nr)
 {
-    std::cout << "Adding symbol: " << identifier << "(" << val << ")" << std::endl;
-    symbol_map_[identifier] = new spect::Symbol(identifier, type, val, curr_file_, line_nr);
-    return symbol_map_[identifier];
+    if (verbose_)
+        std::cout << "Adding symbol: " << identifier << "(" << val << ")" << std::endl;
+    return InsertSymbol(new spect::Symbol(identifier, type, val, curr_file_, line_nr));
 }
 
 void spect::SymbolTable::ResolveSymbol(spect::Symbol *s, spect::SymbolType type, uint32_t val)
 {
     assert (!s->resolved_);
 
-    std::cout << "Resolving symbol: " << s->identifier_ << "(" << val << ")" << std::endl;
+    if (verbose_)
+        std::cout << "Resolving symbol: " << s->identifier_ << "(" << val << ")" << std::endl;
     s->f_ = curr_file_;
     s->resolved_ = true;
     s->type_ = type;
     s->val_ = val;
+
+    std::lock_guard<std::mutex> lock(addr_index_mutex_);
+    addr_index_valid_ = false;
 }
 
-bool spect::SymbolTable::IsDefined(const std::string &identifier)
+bool spect::SymbolTable::IsDefined(std::string_view identifier)
+{
+    return symbol_map_.find(identifier) != symbol_map_.end();
+}
+
+spect::Symbol* spect::SymbolTable::GetSymbol(std::string_view identifier)
 {
     auto it = symbol_map_.find(identifier);
     if (it == symbol_map_.end())
-        return false;
-    return true;
+        return nullptr;
+    return it->second;
 }
 
-spect::Symbol* spect::SymbolTable::GetSymbol(const std::string &identifier)
+void spect::SymbolTable::BuildAddrIndex()
 {
-    if (IsDefined(identifier))
-        return symbol_map_[identifier];
-    return nullptr;
+    addr_index_.clear();
+    addr_index_.reserve(symbol_map_.size());
+    for (const auto &elem : symbol_map_)
+        addr_index_.push_back(elem.second);
+
+    std::sort(addr_index_.begin(), addr_index_.end(), [](const Symbol *a, const Symbol *b) {
+        if (a->val_ != b->val_)
+            return a->val_ < b->val_;
+        return a->identifier_ < b->identifier_;
+    });
+    addr_index_valid_ = true;
 }
 
 spect::Symbol* spect::SymbolTable::GetSymbol(const uint32_t val, spect::SymbolType type)
 {
-    for (const auto &elem : symbol_map_) {
-        Symbol *s = (Symbol*)elem.second;
-        if (s->val_ == val && s->type_ == type)
-            return s;
-    }
+    std::lock_guard<std::mutex> lock(addr_index_mutex_);
+    if (!addr_index_valid_)
+        BuildAddrIndex();
+
+    auto it = std::lower_bound(addr_index_.begin(), addr_index_.end(), val,
+                               [](const Symbol *s, uint32_t v) { return s->val_ < v; });
+
+    // Symbols with equal value are ordered by identifier
+    for (; it != addr_index_.end() && (*it)->val_ == val; it++)
+        if ((*it)->type_ == type)
+            return *it;
     return nullptr;
 }
 
+spect::Symbol* spect::SymbolTable::GetNearestSymbol(const uint32_t val, spect::SymbolType type)
+{
+    std::lock_guard<std::mutex> lock(addr_index_mutex_);
+    if (!addr_index_valid_)
+        BuildAddrIndex();
+
+    auto it = std::upper_bound(addr_index_.begin(), addr_index_.end(), val,
+                               [](uint32_t v, const Symbol *s) { return v < s->val_; });
+
+    // Walk down to the first symbol (by identifier) of highest value with matching type
+    Symbol *rv = nullptr;
+    while (it != addr_index_.begin()) {
+        it--;
+        if (rv && (*it)->val_ != rv->val_)
+            break;
+        if ((*it)->type_ == type)
+            rv = *it;
+    }
+    return rv;
+}
+
+std::vector<spect::Symbol*> spect::SymbolTable::SortedByIdentifier()
+{
+    std::vector<Symbol*> rv;
+    rv.reserve(symbol_map_.size());
+    for (const auto &elem : symbol_map_)
+        rv.push_back(elem.second);
+
+    std::sort(rv.begin(), rv.end(), [](const Symbol *a, const Symbol *b) {
+        return a->identifier_ < b->identifier_;
+    });
+    return rv;
+}
+
 void spect::SymbolTable::Dump(std::ostream& os)
 {
-    for (const auto &elem : symbol_map_) {
-        Symbol *s = (Symbol*)elem.second;
-        os << elem.first << std::hex << " .eq 0x" << s->val_;
+    for (const Symbol *s : SortedByIdentifier()) {
+        os << s->identifier_ << std::hex << " .eq 0x" << s->val_;
         os << "     ; " << s->type_ << "\n";
     }
 }
@@ -84,14 +155,13 @@ void spect::SymbolTable::Print(std::ostream& os)
     using namespace std;
 
     os << hex << setw(4);
-    for (const auto &elem : symbol_map_) {
-        Symbol *s = (Symbol*)elem.second;
+    for (const Symbol *s : SortedByIdentifier()) {
         os << "    ";
-        os << left  << setw(15) << elem.first << " = ";
+        os << left  << setw(15) << s->identifier_ << " = ";
         stringstream ss;
         ss << "0x" << hex << s->val_;
         os << left << setw(10) << ss.str();
         os << " - " << s->type_;
         os << "\n";
     }
-}
\ No newline at end of file
+}
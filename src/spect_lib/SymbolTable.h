@@ -9,8 +9,11 @@
 #ifndef SPECT_LIB_SYMBOL_TABLE_H_
 #define SPECT_LIB_SYMBOL_TABLE_H_
 
-#include <map>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 #include "Instruction.h"
 
@@ -22,15 +25,42 @@ class spect::SymbolTable
         Symbol* AddSymbol(std::string identifier, spect::SymbolType type, int line_nr);
         Symbol* AddSymbol(std::string identifier, spect::SymbolType type, uint32_t val, int line_nr);
         void ResolveSymbol(spect::Symbol *s, spect::SymbolType type, uint32_t val);
-        Symbol* GetSymbol(const std::string &identifier);
+
+        // Symbol with 'identifier', nullptr if not defined
+        Symbol* GetSymbol(std::string_view identifier);
+
+        // Symbol of 'type' with value 'val', nullptr if there is none
         Symbol* GetSymbol(const uint32_t val, spect::SymbolType type);
-        bool IsDefined(const std::string &identifier);
+
+        // Symbol of 'type' with highest value lower or equal to 'val' (e.g. label of function
+        // which contains address 'val'), nullptr if there is none
+        Symbol* GetNearestSymbol(const uint32_t val, spect::SymbolType type);
+
+        bool IsDefined(std::string_view identifier);
         void Dump(std::ostream& os);
         void Print(std::ostream& os);
         spect::SourceFile *curr_file_;
 
+        // Print symbols as they are added and resolved
+        bool verbose_ = false;
+
     private:
-        std::map<std::string, spect::Symbol*> symbol_map_;
+        Symbol* InsertSymbol(spect::Symbol *s);
+        std::vector<spect::Symbol*> SortedByIdentifier();
+        void BuildAddrIndex();
+
+        // All symbols created by the table (owned)
+        std::vector<spect::Symbol*> symbols_;
+
+        // Symbols by identifier. Identifier is stored only once (in the symbol), keys are views
+        // of it.
+        std::unordered_map<std::string_view, spect::Symbol*> symbol_map_;
+
+        // Symbols sorted by value (and identifier), built on first query by value after symbols
+        // changed. Mutex allows querying by multiple threads (symbols of program image).
+        std::vector<spect::Symbol*> addr_index_;
+        bool addr_index_valid_ = false;
+        std::mutex addr_index_mutex_;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,79 @@
+/**************************************************************************************************
+*
+* SPECT Compiler
+* Copyright (C) 2022-present Tropic Square
+*
+* @todo: License
+*
+**************************************************************************************************/
+
+#include <thread>
+#include <vector>
+
+#include "ThreadPool.h"
+
+spect::ThreadPool::ThreadPool(unsigned num_threads)
+{
+    if (num_threads == 0)
+        num_threads = std::thread::hardware_concurrency();
+    if (num_threads == 0)
+        num_threads = 1;
+
+    num_threads_ = num_threads;
+    queues_ = std::make_unique<WorkQueue[]>(num_threads);
+}
+
+unsigned spect::ThreadPool::GetThreadCount() const
+{
+    return num_threads_;
+}
+
+void spect::ThreadPool::Run(size_t num_tasks, const Task &task)
+{
+    for (unsigned i = 0; i < num_threads_; i++) {
+        size_t first = num_tasks * i / num_threads_;
+        size_t last = num_tasks * (i + 1) / num_threads_;
+        for (size_t t = first; t < last; t++)
+            queues_[i].tasks.push_back(t);
+    }
+
+    auto worker_loop = [this, &task] (unsigned worker) {
+        size_t t;
+        while (GetTask(worker, t))
+            task(worker, t);
+    };
+
+    // Calling thread is worker 0
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < num_threads_; i++)
+        threads.emplace_back(worker_loop, i);
+    worker_loop(0);
+
+    for (auto &t : threads)
+        t.join();
+}
+
+bool spect::ThreadPool::GetTask(unsigned worker, size_t &task)
+{
+    {
+        std::lock_guard<std::mutex> guard(queues_[worker].lock);
+        if (!queues_[worker].tasks.empty()) {
+            task = queues_[worker].tasks.front();
+            queues_[worker].tasks.pop_front();
+            return true;
+        }
+    }
+
+    // No new tasks are added during Run, so single pass over other queues is enough
+    for (unsigned i = 1; i < num_threads_; i++) {
+        WorkQueue &victim = queues_[(worker + i) % num_threads_];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.back();
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,79 @@
+/**************************************************************************************************
+*
+* SPECT Compiler
+* Copyright (C) 2022-present Tropic Square
+*
+* @todo: License
+*
+**************************************************************************************************/
+
+#ifndef SPECT_LIB_THREAD_POOL_H_
+#define SPECT_LIB_THREAD_POOL_H_
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "spect.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Work-stealing thread pool
+//  Tasks are identified by index. On start, indices are split to contiguous ranges, one per
+//  worker thread. Worker executes tasks from the front of its own range. When its range is
+//  exhausted, it steals tasks from the back of ranges of other workers. Tasks of uneven
+//  duration are therefore balanced without central queue.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+class spect::ThreadPool
+{
+    public:
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Task executed by the pool
+        /// @param worker Index of worker thread executing the task (0 ... GetThreadCount() - 1).
+        ///               Allows task to use per-worker state without locking.
+        /// @param task Index of the task
+        /// @note Task shall not throw.
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        typedef std::function<void(unsigned worker, size_t task)> Task;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Thread pool constructor
+        /// @param num_threads Number of worker threads, 0 - Number of hardware threads
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        ThreadPool(unsigned num_threads);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @returns Number of worker threads
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        unsigned GetThreadCount() const;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Execute tasks 0 ... num_tasks - 1, returns when all tasks are finished.
+        /// @param num_tasks Number of tasks
+        /// @param task Task to execute
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        void Run(size_t num_tasks, const Task &task);
+
+    private:
+        struct WorkQueue {
+            std::mutex lock;
+            std::deque<size_t> tasks;
+        };
+
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Get next task for worker, steal from other workers when own queue is empty.
+        /// @param worker Index of worker thread
+        /// @param task Next task
+        /// @returns True if task was found, False when all queues are empty
+        ///////////////////////////////////////////////////////////////////////////////////////////
+        bool GetTask(unsigned worker, size_t &task);
+
+        // Number of worker threads
+        unsigned num_threads_;
+
+        // Queue of tasks of each worker
+        std::unique_ptr<WorkQueue[]> queues_;
+};
+
+#endif
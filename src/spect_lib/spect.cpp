@@ -10,7 +10,10 @@
 *
 *****************************************************************************/
 
+#include <iterator>
+
 #include "spect.h"
+#include "PerfectHash.h"
 
 namespace spect {
 
@@ -47,6 +50,46 @@ std::ostream& operator << ( std::ostream& os, const spect::ParityType& parity_ty
     }
 }
 
+std::ostream& operator << ( std::ostream& os, const spect::ExecEngine& exec_engine)
+{
+    switch (exec_engine) {
+    case ExecEngine::REFERENCE:
+        return os << "Reference";
+    case ExecEngine::FAST:
+        return os << "Fast";
+    default:
+        return os << "Invalid execution engine!";
+    }
+}
+
+std::ostream& operator << ( std::ostream& os, const spect::ChangeQueueOverflow& overflow)
+{
+    switch (overflow) {
+    case ChangeQueueOverflow::BLOCK:
+        return os << "Block";
+    case ChangeQueueOverflow::DROP_OLDEST:
+        return os << "Drop oldest";
+    case ChangeQueueOverflow::ERROR:
+        return os << "Error";
+    case ChangeQueueOverflow::GROW:
+        return os << "Grow";
+    default:
+        return os << "Invalid change queue overflow policy!";
+    }
+}
+
+std::ostream& operator << ( std::ostream& os, const spect::ContextFormat& format)
+{
+    switch (format) {
+    case ContextFormat::BINARY:
+        return os << "Binary";
+    case ContextFormat::TEXT:
+        return os << "Text";
+    default:
+        return os << "Invalid context format!";
+    }
+}
+
 inline uint32_t stou (const std::string& str, std::size_t* pos = nullptr, int base = 10)
 {
     return uint32_t(std::stoul(str, pos, base));
@@ -70,6 +113,19 @@ uint32_t stoint(std::string str)
     }
 }
 
+// Register names generated by CMake: R0 ... R31, r0 ... r31
+static constexpr const char *GPR_NAMES[] = { SPECT_GPR_NAMES };
+static constexpr PerfectHash<std::size(GPR_NAMES)> GPR_HASH(GPR_NAMES);
+static_assert(std::size(GPR_NAMES) == 2 * SPECT_GPR_CNT, "Register names do not match GPR count!");
+
+int stogpr(const std::string &str)
+{
+    int i = GPR_HASH.Find(str);
+    if (i < 0)
+        return -1;
+    return i % SPECT_GPR_CNT;
+}
+
 std::string tohexs(uint64_t i, int width)
 {
     std::stringstream ss;
@@ -142,6 +142,42 @@ namespace spect {
 
     std::ostream& operator << ( std::ostream& os, const spect::ParityType& parity_type);
 
+    enum class ExecEngine {
+        // Each instruction executed via Instruction::Execute(), full debug and DPI support
+        REFERENCE,
+
+        // Pre-decoded instructions dispatched over handler table (see FastEngine.h)
+        FAST
+    };
+
+    std::ostream& operator << ( std::ostream& os, const spect::ExecEngine& exec_engine);
+
+    enum class ChangeQueueOverflow {
+        // Producer waits till consumer frees space in the queue
+        BLOCK,
+
+        // Oldest change in the queue is dropped
+        DROP_OLDEST,
+
+        // std::runtime_error is thrown
+        ERROR,
+
+        // Capacity of the queue is doubled
+        GROW
+    };
+
+    std::ostream& operator << ( std::ostream& os, const spect::ChangeQueueOverflow& overflow);
+
+    enum class ContextFormat {
+        // Versioned binary image of model state with checksum (see CpuModel::DumpContext)
+        BINARY,
+
+        // Line-oriented hex text, one value per line
+        TEXT
+    };
+
+    std::ostream& operator << ( std::ostream& os, const spect::ContextFormat& format);
+
     class Instruction;
     class InstructionFactory;
     class InstructionR;
@@ -154,16 +190,28 @@ namespace spect {
 
     class CpuModel;
     class CpuSimulator;
+    class FastEngine;
     class CpuProgram;
     class HexHandler;
     class KeyMemory;
+    class ModularReduction;
+    class ChangeQueue;
+    class ThreadPool;
+    class ProgramImage;
+    class CowMemory;
+    class CpuSnapshot;
 
     class Compiler;
     class Symbol;
     class SymbolTable;
     class SourceFile;
+    class Lexer;
+
+    template <size_t N>
+    class PerfectHash;
 
     uint32_t stoint(std::string str);
+    int stogpr(const std::string &str);
     std::string tohexs(uint64_t i, int width);
     std::string tohexs(uint256_t val);
 
@@ -172,29 +220,56 @@ namespace spect {
 
     #define NUM_ISA_VERSIONS 2
 
+    // ISA version used when none is selected (latest)
+    #define DEFAULT_ISA_VERSION NUM_ISA_VERSIONS
+
     #define INSTR_ENCODE(func, opcode, itype)                                   \
         ((func           & IENC_FUNC_MASK)      << IENC_FUNC_OFFSET)        |   \
         ((opcode         & IENC_OPCODE_MASK)    << IENC_OPCODE_OFFSET)      |   \
         ((TO_INT(itype)  & IENC_TYPE_MASK)      << IENC_TYPE_OFFSET)
 
-    #define IDENT_REGEX "([a-zA-Z_][a-zA-Z_0-9]*)"
-    #define FILE_REGEX ".+"
     #define VAL_REGEX "(0x|0b)*[0-9a-fA-F]+"
-    #define OP_REGEX "(r|R)(0|1|2|3|4|5|6|7|8|9|10|11|12|13|14|15|16|17|18|19|20|21|22|23|24|25|26|27|28|29|30|31)"
     #define NUM_REGEX "(0x[a-fA-F0-9]+|0b[0-1]+|[0-9]+)"
     #define START_SYMBOL "_start"
-    #define INCLUDE_KEYWORD "(\\.include)"
-    #define EQ_KEYWORD "(\\.eq)"
-    #define IFDEF_KEYWORD "(\\.ifdef)"
-    #define ELSE_KEYWORD "(\\.else)"
-    #define ENDIF_KEYWORD "(\\.endif)"
-    #define DEFINE_KEYWORD "(\\.define)"
+    #define INCLUDE_KEYWORD ".include"
+    #define EQ_KEYWORD ".eq"
+    #define IFDEF_KEYWORD ".ifdef"
+    #define ELSE_KEYWORD ".else"
+    #define ENDIF_KEYWORD ".endif"
+    #define DEFINE_KEYWORD ".define"
 
     #define VERBOSITY_NONE 0
     #define VERBOSITY_LOW 1
     #define VERBOSITY_MEDIUM 2
     #define VERBOSITY_HIGH 3
 
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Highest verbosity of debug messages compiled into the model. Messages with higher
+    // verbosity are removed at compile time (e.g. -DSPECT_MAX_VERBOSITY=VERBOSITY_LOW for
+    // release builds).
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    #ifndef SPECT_MAX_VERBOSITY
+        #define SPECT_MAX_VERBOSITY VERBOSITY_HIGH
+    #endif
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // True when debug message of 'verbosity_level' will be printed by 'obj' (CpuModel or
+    // KeyMemory). Use to guard code that only prepares debug messages.
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    #define DEBUG_ENABLED(obj, verbosity_level)                                                 \
+        ((verbosity_level) <= SPECT_MAX_VERBOSITY &&                                            \
+         int((obj)->verbosity_) >= int(verbosity_level))
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Print debug message via 'obj->DebugInfo'. Arguments of the message are evaluated only
+    // when the message will be printed.
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    #define DEBUG_INFO(obj, verbosity_level, ...)                                               \
+        do {                                                                                    \
+            if (DEBUG_ENABLED(obj, verbosity_level))                                            \
+                (obj)->DebugInfo(verbosity_level, __VA_ARGS__);                                 \
+        } while (0)
+
     #define MODEL_LABEL "SPECT_MODEL: "
 
     #define KECCAK_CAPACITY 256
@@ -126,6 +126,14 @@
 #define KEY_MEM_OFFSET_NUM 256
 #endif
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Model parameters
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Initial capacity of processor state change queue (number of changes)
+#ifndef SPECT_CHANGE_Q_SIZE
+#define SPECT_CHANGE_Q_SIZE 65536
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // Internal defines
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,24 @@
+; Keccak (TMAC) state is initialized only after first few instructions. Job stopped by
+; instruction limit before that must not see Keccak state left by previous job.
+
+_start:
+    MOVI    r1, 0x5A3
+    MOVI    r2, 0x1C7
+    MOVI    r3, 0x2E9
+    MOVI    r4, 0x0F1
+    MOVI    r5, 0x7B4
+    MOVI    r30, 500
+
+    TMAC_IT r1
+    TMAC_IS r2, 0x34
+
+_loop:
+    ROL8    r1, r1
+    XOR     r1, r1, r3
+    TMAC_UP r1
+    TMAC_RD r4
+    ADD     r5, r5, r4
+    SUBI    r30, r30, 1
+    BRNZ    _loop
+
+    END
@@ -0,0 +1,80 @@
+#!/bin/bash
+
+# Check if the correct number of arguments are provided
+if [ "$#" -lt 4 ]; then
+    echo "Usage: $0 <spect_iss> <spect_batch> <program> <output_dir> [<spect_batch options>]"
+    exit 1
+fi
+
+# Assign arguments to variables
+ISS="$1"
+BATCH="$2"
+PROGRAM="$3"
+OUT_DIR="$4"
+shift 4
+
+# Instruction limits of jobs, 0 - No limit
+LIMITS="0 1237 5 0 3001 0 777 1"
+NUM_RUNS=4
+
+mkdir -p $OUT_DIR
+rm -f $OUT_DIR/manifest.txt
+
+echo "*************************************************************************"
+echo "* Running reference simulations of $PROGRAM"
+echo "*************************************************************************"
+for LIMIT in $LIMITS; do
+    if [ "$LIMIT" -eq 0 ]; then
+        LIMIT_OPT=""
+    else
+        LIMIT_OPT="--max-instr-cnt=$LIMIT"
+    fi
+
+    $ISS --program=$PROGRAM $LIMIT_OPT --dump-context=$OUT_DIR/ref_$LIMIT.ctx \
+         --data-ram-out=$OUT_DIR/ref_$LIMIT.hex > $OUT_DIR/ref_$LIMIT.log
+    if [ "$?" -ne 0 ]; then
+        echo "Reference simulation failed, see $OUT_DIR/ref_$LIMIT.log"
+        exit 1
+    fi
+done
+
+# Each job dumps to its own context
+JOB=0
+for RUN in $(seq $NUM_RUNS); do
+    for LIMIT in $LIMITS; do
+        if [ "$LIMIT" -eq 0 ]; then
+            LIMIT_OPT=""
+        else
+            LIMIT_OPT="--max-instr-cnt=$LIMIT"
+        fi
+        echo "--program=$PROGRAM $LIMIT_OPT --dump-context=$OUT_DIR/job_$JOB.ctx" \
+             "--expect-data-ram-out=$OUT_DIR/ref_$LIMIT.hex" >> $OUT_DIR/manifest.txt
+        JOB=$((JOB + 1))
+    done
+done
+
+echo "*************************************************************************"
+echo "* Running $JOB jobs by spect_batch"
+echo "*************************************************************************"
+$BATCH --manifest=$OUT_DIR/manifest.txt --jobs=4 "$@" > $OUT_DIR/batch.log
+if [ "$?" -ne 0 ]; then
+    echo "Batch run failed, see $OUT_DIR/batch.log"
+    exit 1
+fi
+
+echo "*************************************************************************"
+echo "* Comparing model context"
+echo "*************************************************************************"
+JOB=0
+for RUN in $(seq $NUM_RUNS); do
+    for LIMIT in $LIMITS; do
+        if ! diff $OUT_DIR/ref_$LIMIT.ctx $OUT_DIR/job_$JOB.ctx; then
+            echo "Model context of job $JOB does not match"
+            exit 1
+        fi
+        JOB=$((JOB + 1))
+    done
+done
+
+echo "Model context matches"
+exit 0
@@ -0,0 +1,150 @@
+/**************************************************************************************************
+**
+**
+** TODO: License
+**
+** Author: Ondrej Ille
+**************************************************************************************************/
+
+#include <stdio.h>
+
+#include <stdexcept>
+#include <thread>
+
+#include "spect.h"
+#include "ChangeQueue.h"
+
+#define NUM_CHANGES         1000000
+#define QUEUE_CAPACITY      64
+
+static int errors = 0;
+
+// Change with all words derived from its index, torn copy of the change is detected
+static dpi_state_change_t make_change(uint32_t index)
+{
+    dpi_state_change_t change;
+    change.obj = index;
+    for (int i = 0; i < 8; i++) {
+        change.old_val[i] = index + i;
+        change.new_val[i] = index * (i + 1);
+    }
+    return change;
+}
+
+static bool check_change(const dpi_state_change_t &change)
+{
+    uint32_t index = change.obj;
+    bool ok = true;
+    for (int i = 0; i < 8; i++)
+        ok = ok && (change.old_val[i] == index + i) && (change.new_val[i] == index * (i + 1));
+    return ok;
+}
+
+static void error(const char *policy, const char *msg, uint64_t val)
+{
+    printf("%s: %s (%llu)\n", policy, msg, static_cast<unsigned long long>(val));
+    errors++;
+}
+
+// Producer pushes on separate thread, consumer pops on this thread. All changes shall be popped
+// in order (BLOCK), or in order with some of them dropped (DROP_OLDEST).
+static void test_two_threads(spect::ChangeQueueOverflow overflow, const char *policy)
+{
+    spect::ChangeQueue q(QUEUE_CAPACITY, overflow);
+
+    std::thread producer([&q]() {
+        for (uint32_t i = 0; i < NUM_CHANGES; i++)
+            q.Push(make_change(i));
+    });
+
+    dpi_state_change_t change;
+    uint64_t popped = 0;
+    int64_t last = -1;
+    while (true) {
+        if (!q.Pop(change)) {
+            if (last == NUM_CHANGES - 1)
+                break;
+            std::this_thread::yield();
+            continue;
+        }
+        popped++;
+        if (!check_change(change))
+            error(policy, "Torn change popped", change.obj);
+        if (static_cast<int64_t>(change.obj) <= last)
+            error(policy, "Change popped out of order", change.obj);
+        if (overflow == spect::ChangeQueueOverflow::BLOCK && change.obj != last + 1)
+            error(policy, "Change lost", last + 1);
+        last = change.obj;
+    }
+    producer.join();
+
+    if (popped + q.GetDropCount() != NUM_CHANGES)
+        error(policy, "Popped and dropped changes do not match pushed changes", popped);
+    if (!q.Empty())
+        error(policy, "Queue not empty", popped);
+
+    printf("%s: popped %llu, dropped %llu\n", policy, static_cast<unsigned long long>(popped),
+           static_cast<unsigned long long>(q.GetDropCount()));
+}
+
+// Push to full queue throws, queued changes are kept
+static void test_error()
+{
+    spect::ChangeQueue q(QUEUE_CAPACITY, spect::ChangeQueueOverflow::ERROR);
+
+    for (uint32_t i = 0; i < QUEUE_CAPACITY; i++)
+        q.Push(make_change(i));
+
+    bool thrown = false;
+    try {
+        q.Push(make_change(QUEUE_CAPACITY));
+    } catch (std::runtime_error &err) {
+        thrown = true;
+    }
+    if (!thrown)
+        error("ERROR", "Push to full queue did not throw", QUEUE_CAPACITY);
+
+    dpi_state_change_t change;
+    for (uint32_t i = 0; i < QUEUE_CAPACITY; i++)
+        if (!q.Pop(change) || !check_change(change) || change.obj != i)
+            error("ERROR", "Queued change lost", i);
+    if (q.Pop(change))
+        error("ERROR", "Change pushed to full queue popped", change.obj);
+}
+
+// Interleaved pushes and pops wrap around the buffer, then the queue grows
+static void test_grow()
+{
+    spect::ChangeQueue q(4, spect::ChangeQueueOverflow::GROW);
+    dpi_state_change_t change;
+    uint32_t pushed = 0;
+    uint32_t popped = 0;
+
+    for (int round = 0; round < 2000; round++) {
+        for (int i = 0; i < (round * 7) % 13 + 1; i++)
+            q.Push(make_change(pushed++));
+        for (int i = 0; i < (round * 5) % 11 && q.Pop(change); i++)
+            if (!check_change(change) || change.obj != popped++)
+                error("GROW", "Change popped out of order", change.obj);
+    }
+    while (q.Pop(change))
+        if (!check_change(change) || change.obj != popped++)
+            error("GROW", "Change popped out of order", change.obj);
+
+    if (popped != pushed)
+        error("GROW", "Changes lost", pushed - popped);
+    if (q.GetDropCount() != 0)
+        error("GROW", "Changes dropped", q.GetDropCount());
+
+    printf("GROW: popped %u, capacity %zu\n", popped, q.GetCapacity());
+}
+
+int main()
+{
+    test_two_threads(spect::ChangeQueueOverflow::BLOCK, "BLOCK");
+    test_two_threads(spect::ChangeQueueOverflow::DROP_OLDEST, "DROP_OLDEST");
+    test_error();
+    test_grow();
+
+    return errors ? 1 : 0;
+}
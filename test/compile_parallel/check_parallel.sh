@@ -0,0 +1,52 @@
+#!/bin/bash
+
+# Check if the correct number of arguments are provided
+if [ "$#" -ne 3 ]; then
+    echo "Usage: $0 <spect_compiler> <source_dir> <output_dir>"
+    exit 1
+fi
+
+# Assign arguments to variables
+COMPILER="$1"
+SRC_DIR="$2"
+OUT_DIR="$3"
+
+mkdir -p $OUT_DIR
+
+# Top-level files, order matters (symbols and conditional defines are shared)
+PROGRAM="$SRC_DIR/parallel_test_main.s $SRC_DIR/parallel_test_mul.s $SRC_DIR/parallel_test_add.s"
+
+# Runs spect_compiler, exits on failure
+run_compiler() {
+    local NAME=$1
+    shift
+    $COMPILER --first-address=0x8000 --hex-file=$OUT_DIR/$NAME.hex \
+              --dump-symbols=$OUT_DIR/$NAME.sym "$@" $PROGRAM > $OUT_DIR/$NAME.log
+    if [ "$?" -ne 0 ]; then
+        echo "Compilation failed, see $OUT_DIR/$NAME.log"
+        exit 1
+    fi
+    # Log holds path of the HEX file
+    sed -i "s|$OUT_DIR/$NAME|$OUT_DIR/out|" $OUT_DIR/$NAME.log
+}
+
+echo "*************************************************************************"
+echo "* Compiling $PROGRAM by single and multiple threads"
+echo "*************************************************************************"
+run_compiler jobs_1 --jobs=1
+run_compiler jobs_4 --jobs=4
+
+if ! diff $SRC_DIR/parallel_test.hex $OUT_DIR/jobs_1.hex; then
+    echo "Program compiled by single thread does not match expected program"
+    exit 1
+fi
+
+for ext in hex sym log; do
+    if ! diff $OUT_DIR/jobs_1.$ext $OUT_DIR/jobs_4.$ext; then
+        echo "Program compiled by multiple threads differs: $OUT_DIR/jobs_4.$ext"
+        exit 1
+    fi
+done
+
+echo "Parallel compilation matches"
+exit 0
@@ -0,0 +1,9 @@
+; ==============================================================================
+;   Third top-level file of parallel compile test. Uses label of first top-level
+;   file and constants of file included by it.
+; ==============================================================================
+
+add_func:
+    ADDI    r1, r1, SEED_VAL
+    BRNZ    main_done
+    RET
@@ -0,0 +1,7 @@
+; ==============================================================================
+;   Constants of parallel compile test
+; ==============================================================================
+
+SEED_VAL  .eq 0x3
+FAST_STEP .eq 0x10
+SLOW_STEP .eq 0x8
@@ -0,0 +1,18 @@
+; ==============================================================================
+;   First top-level file of parallel compile test. Calls functions placed by
+;   other top-level files, defines conditional define used by them.
+; ==============================================================================
+
+.define PARALLEL_TEST_FAST
+
+.include parallel_test_consts.s
+
+_start:
+    MOVI    r1, SEED_VAL
+    CALL    mul_func
+    CALL    add_func
+    CMPI    r1, 0x40
+    BRZ     main_done
+    NOP
+main_done:
+    END
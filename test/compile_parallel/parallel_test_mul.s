@@ -0,0 +1,13 @@
+; ==============================================================================
+;   Second top-level file of parallel compile test. Code depends on conditional
+;   define from first top-level file.
+; ==============================================================================
+
+mul_func:
+.ifdef PARALLEL_TEST_FAST
+    ADDI    r1, r1, FAST_STEP
+.else
+    ADDI    r1, r1, SLOW_STEP
+    ADDI    r1, r1, SLOW_STEP
+.endif
+    RET
@@ -0,0 +1,85 @@
+#!/bin/bash
+
+# Check if the correct number of arguments are provided
+if [ "$#" -ne 4 ]; then
+    echo "Usage: $0 <spect_iss> <program> <load_program> <output_dir>"
+    exit 1
+fi
+
+# Assign arguments to variables
+ISS="$1"
+PROGRAM="$2"
+LOAD_PROGRAM="$3"
+OUT_DIR="$4"
+
+mkdir -p $OUT_DIR
+
+# Runs spect_iss, exits on failure
+run_iss() {
+    LOG=$1
+    shift
+    $ISS "$@" > $OUT_DIR/$LOG.log
+    if [ "$?" -ne 0 ]; then
+        echo "Simulation failed, see $OUT_DIR/$LOG.log"
+        exit 1
+    fi
+}
+
+echo "*************************************************************************"
+echo "* Dumping context of $PROGRAM in both formats"
+echo "*************************************************************************"
+run_iss dump_bin --program=$PROGRAM --max-instr-cnt=1237 --dump-context=$OUT_DIR/orig.bin
+run_iss dump_txt --program=$PROGRAM --max-instr-cnt=1237 --dump-context=$OUT_DIR/orig.txt \
+        --context-format=text
+
+echo "*************************************************************************"
+echo "* Converting context between formats"
+echo "*************************************************************************"
+run_iss bin_to_txt --program=$LOAD_PROGRAM --load-context=$OUT_DIR/orig.bin \
+        --dump-context=$OUT_DIR/conv.txt --context-format=text
+run_iss txt_to_bin --program=$LOAD_PROGRAM --load-context=$OUT_DIR/orig.txt \
+        --dump-context=$OUT_DIR/conv.bin
+
+if ! diff $OUT_DIR/orig.txt $OUT_DIR/conv.txt; then
+    echo "Text context converted from binary context does not match"
+    exit 1
+fi
+if ! cmp $OUT_DIR/orig.bin $OUT_DIR/conv.bin; then
+    echo "Binary context converted from text context does not match"
+    exit 1
+fi
+
+echo "*************************************************************************"
+echo "* Applying context delta on top of base context"
+echo "*************************************************************************"
+run_iss dump_base --program=$LOAD_PROGRAM --dump-context=$OUT_DIR/base.bin
+run_iss dump_delta --program=$PROGRAM --max-instr-cnt=1237 --dump-context-delta=$OUT_DIR/orig.dlt
+run_iss apply_delta --program=$LOAD_PROGRAM --load-context=$OUT_DIR/base.bin \
+        --load-context-delta=$OUT_DIR/orig.dlt --dump-context=$OUT_DIR/delta.bin
+
+if ! cmp $OUT_DIR/orig.bin $OUT_DIR/delta.bin; then
+    echo "Context with applied delta does not match"
+    exit 1
+fi
+
+# Delta applies only on top of its baseline
+$ISS --program=$LOAD_PROGRAM --load-context=$OUT_DIR/orig.bin \
+     --load-context-delta=$OUT_DIR/orig.dlt > $OUT_DIR/wrong_base.log
+if [ "$?" -eq 0 ]; then
+    echo "Context delta was applied on top of wrong context"
+    exit 1
+fi
+
+echo "*************************************************************************"
+echo "* Loading corrupted binary context"
+echo "*************************************************************************"
+cp $OUT_DIR/orig.bin $OUT_DIR/corrupt.bin
+printf '\xAA' | dd of=$OUT_DIR/corrupt.bin bs=1 seek=100 conv=notrunc 2> /dev/null
+$ISS --program=$LOAD_PROGRAM --load-context=$OUT_DIR/corrupt.bin > $OUT_DIR/corrupt.log
+if [ "$?" -eq 0 ]; then
+    echo "Corrupted binary context was loaded"
+    exit 1
+fi
+
+echo "Model context matches"
+exit 0
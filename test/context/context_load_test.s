@@ -0,0 +1,6 @@
+; ==============================================================================
+;   Finishes immediately. Used to load context and dump it again unchanged.
+; ==============================================================================
+
+_start:
+    END
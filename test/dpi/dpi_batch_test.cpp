@@ -0,0 +1,113 @@
+/**************************************************************************************************
+**
+**
+** TODO: License
+**
+** Author: Ondrej Ille
+**************************************************************************************************/
+
+#include <stdio.h>
+#include <stdarg.h>
+
+#include <cassert>
+#include <cstring>
+#include <stdint.h>
+#include <vector>
+
+#include "spect_iss_dpi.h"
+#include "spect_defs.h"
+
+extern "C" {
+    // Dummy replacement of simulator specific printf
+    int vpi_printf(const char *fmt, ...){
+        va_list args;
+        va_start(args, fmt);
+        int rv = vprintf(fmt, args);
+        va_end(args);
+        return rv;
+    }
+}
+
+// Creates instance with compiled test program, started with change reporting enabled
+static spect_dpi_ctx_t* create_started()
+{
+    spect_dpi_ctx_t *ctx = spect_dpi_create(2);
+    assert(ctx != nullptr);
+
+    uint32_t rv = spect_dpi_ctx_compile_program(ctx, DPI_TEST_FW, "dpi_batch_test.hex",
+                                                DPI_HEX_ISS_WORD, DPI_PARITY_NONE,
+                                                SPECT_INSTR_MEM_BASE);
+    assert(rv == 0);
+    spect_dpi_ctx_load_hex_file(ctx, "dpi_batch_test.hex", SPECT_INSTR_MEM_BASE);
+    spect_dpi_ctx_set_model_start_pc(ctx, spect_dpi_ctx_get_compiled_program_start_address(ctx));
+    spect_dpi_ctx_set_change_reporting(ctx, 1);
+    spect_dpi_ctx_start(ctx);
+
+    return ctx;
+}
+
+int main()
+{
+    std::vector<dpi_state_change_t> single;
+    std::vector<dpi_state_change_t> batched;
+    std::vector<dpi_state_change_t> clamped;
+    dpi_state_change_t change;
+    uint32_t count;
+
+    // Changes drained one by one after each instruction
+    spect_dpi_ctx_t *ctx = create_started();
+    while (!spect_dpi_ctx_is_program_finished(ctx)) {
+        spect_dpi_ctx_program_step(ctx, 0);
+        while (spect_dpi_ctx_get_model_change(ctx, &change) == 0)
+            single.push_back(change);
+    }
+    spect_dpi_destroy(ctx);
+
+    // Changes collected with each instruction, rest drained in batches
+    dpi_state_change_t buf[SPECT_DPI_CHANGE_BATCH];
+    ctx = create_started();
+    while (!spect_dpi_ctx_is_program_finished(ctx)) {
+        spect_dpi_ctx_program_step_collect(ctx, 0, buf, SPECT_DPI_CHANGE_BATCH, &count);
+        batched.insert(batched.end(), buf, buf + count);
+        uint32_t more = 1;
+        while (more) {
+            more = spect_dpi_ctx_get_model_changes(ctx, buf, SPECT_DPI_CHANGE_BATCH, &count);
+            batched.insert(batched.end(), buf, buf + count);
+        }
+    }
+    spect_dpi_destroy(ctx);
+
+    // Whole program executed, changes drained with 'max' above SPECT_DPI_CHANGE_BATCH. Only
+    // SPECT_DPI_CHANGE_BATCH elements of the buffer can be written.
+    const uint8_t fill = 0xA5;
+    std::vector<dpi_state_change_t> big(4 * SPECT_DPI_CHANGE_BATCH);
+    ctx = create_started();
+    spect_dpi_ctx_program_run(ctx, 0);
+    uint32_t more = 1;
+    while (more) {
+        memset(static_cast<void*>(big.data()), fill, big.size() * sizeof(dpi_state_change_t));
+        more = spect_dpi_ctx_get_model_changes(ctx, big.data(), big.size(), &count);
+        assert(count <= SPECT_DPI_CHANGE_BATCH && "Number of popped changes clamped");
+
+        const uint8_t *tail = reinterpret_cast<const uint8_t*>(&big[SPECT_DPI_CHANGE_BATCH]);
+        size_t tail_size = (big.size() - SPECT_DPI_CHANGE_BATCH) * sizeof(dpi_state_change_t);
+        for (size_t i = 0; i < tail_size; i++)
+            assert(tail[i] == fill && "Buffer not written beyond SPECT_DPI_CHANGE_BATCH");
+
+        clamped.insert(clamped.end(), big.begin(), big.begin() + count);
+    }
+    spect_dpi_destroy(ctx);
+
+    printf("Changes: %zu single, %zu batched, %zu clamped\n", single.size(), batched.size(),
+           clamped.size());
+
+    assert(single.size() > SPECT_DPI_CHANGE_BATCH);
+    assert(batched.size() == single.size());
+    assert(clamped.size() == single.size());
+    for (size_t i = 0; i < single.size(); i++) {
+        assert(memcmp(&single[i], &batched[i], sizeof(dpi_state_change_t)) == 0);
+        assert(memcmp(&single[i], &clamped[i], sizeof(dpi_state_change_t)) == 0);
+    }
+
+    return 0;
+}
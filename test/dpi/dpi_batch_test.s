@@ -0,0 +1,23 @@
+; Loop causing GPR, flag, memory and RAR stack changes, drained by dpi_batch_test.cpp
+
+_start:
+    MOVI    r1, 0x123
+    MOVI    r2, 0x010
+    MOVI    r30, 40
+
+_loop:
+    ADD     r1, r1, r2
+    XOR     r3, r1, r30
+    ROL8    r4, r3
+    ST      r4, 0x1000
+    LD      r5, 0x1000
+    CALL    _sub
+    SUBI    r30, r30, 1
+    BRNZ    _loop
+
+    END
+
+_sub:
+    SWE     r6, r5
+    CMP     r6, r1
+    RET
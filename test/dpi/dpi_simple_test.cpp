@@ -12,6 +12,7 @@
 #include <cassert>
 #include <stdint.h>
 
+#include "spect.h"
 #include "spect_iss_dpi.h"
 #include "spect_defs.h"
 
@@ -44,4 +45,13 @@ int main()
     assert(rv == 0);
 
     spect_dpi_exit();
+
+    // Instance of each ISA version can be created, invalid ISA version is refused
+    for (int isa_version = 1; isa_version <= NUM_ISA_VERSIONS; isa_version++) {
+        spect_dpi_ctx_t *ctx = spect_dpi_create(isa_version);
+        assert(ctx != nullptr);
+        spect_dpi_destroy(ctx);
+    }
+    assert(spect_dpi_create(0) == nullptr);
+    assert(spect_dpi_create(NUM_ISA_VERSIONS + 1) == nullptr);
 }
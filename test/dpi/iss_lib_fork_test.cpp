@@ -0,0 +1,83 @@
+/**************************************************************************************************
+**
+**
+** TODO: License
+**
+** Author: Ondrej Ille
+**************************************************************************************************/
+
+#include <stdio.h>
+#include <stdarg.h>
+
+#include <cassert>
+#include <sstream>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+#include "spect_iss_lib.h"
+
+#define NUM_THREADS     8
+#define NUM_PREFIX      150
+
+// Returns true when R1 holds final result of the program
+static bool check_result(spect_iss_ctx_t *ctx)
+{
+    std::stringstream ss;
+    std::string r1;
+    spect_iss_cmd_get(ctx, ss, "R1");
+    ss >> r1;
+    return uint256_t(r1.c_str()) == uint256_t(300);
+}
+
+// Runs forked instance till the end, returns non-zero on wrong result
+static void run_fork(spect_iss_ctx_t *ctx, int *rv)
+{
+    std::stringstream log;
+    spect_iss_cmd_run(ctx, log);
+    if (!check_result(ctx))
+        *rv = 1;
+}
+
+int main()
+{
+    std::vector<std::thread> threads;
+    spect_iss_ctx_t *forks[NUM_THREADS];
+    int rv[NUM_THREADS] = {};
+    std::stringstream log;
+
+    // Run part of the program, and take snapshot in the middle of the loop
+    spect_iss_ctx_t *ctx = spect_iss_create(2);
+    spect_iss_load_s_file(ctx, DPI_TEST_FW);
+    spect_iss_cmd_start(ctx, log);
+    spect_iss_cmd_step(ctx, log, NUM_PREFIX);
+    spect_iss_snapshot_t *snapshot = spect_iss_snapshot_take(ctx);
+
+    // Forks continue from the same point in parallel
+    for (int i = 0; i < NUM_THREADS; i++)
+        forks[i] = spect_iss_fork(ctx);
+    for (int i = 0; i < NUM_THREADS; i++)
+        threads.emplace_back(run_fork, forks[i], &rv[i]);
+
+    // Parent is independent of forks
+    spect_iss_cmd_run(ctx, log);
+    assert(check_result(ctx) && "Parent computed correct result");
+
+    for (auto &t : threads)
+        t.join();
+
+    for (int i = 0; i < NUM_THREADS; i++) {
+        assert(rv[i] == 0 && "Fork computed correct result");
+        spect_iss_destroy(forks[i]);
+    }
+
+    // Restored instance continues from the snapshot again, including Data RAM In content
+    spect_iss_restore(ctx, snapshot);
+    spect_iss_cmd_run(ctx, log);
+    assert(check_result(ctx) && "Restored instance computed correct result");
+
+    spect_iss_snapshot_destroy(snapshot);
+    spect_iss_destroy(ctx);
+
+    return 0;
+}
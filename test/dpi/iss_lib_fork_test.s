@@ -0,0 +1,30 @@
+; ==============================================================================
+;   Adds 3 to accumulator in Data RAM In 100 times, result is in r1.
+;   Used to check that instances forked from (or restored to) snapshot
+;   taken in the middle of the loop continue from the same memory state.
+;   Key Memory slot programmed before the snapshot is re-programmed at
+;   the end, so that forks modify slot they share.
+; ==============================================================================
+
+_start:
+    MOVI    r0, 100
+    MOVI    r1, 0
+    MOVI    r2, 3
+    ST      r1, 0x0100
+
+    MOVI    r3, 1
+    STK     r2, r3, 0x400
+    KBO     r3, 0x402
+
+_loop:
+    LD      r1, 0x0100
+    ADD     r1, r1, r2
+    ST      r1, 0x0100
+    SUBI    r0, r0, 1
+    BRNZ    _loop
+
+    ST      r1, 0x1000
+    KBO     r3, 0x403
+    STK     r1, r3, 0x400
+    KBO     r3, 0x402
+    END
@@ -0,0 +1,61 @@
+/**************************************************************************************************
+**
+**
+** TODO: License
+**
+** Author: Ondrej Ille
+**************************************************************************************************/
+
+#include <stdio.h>
+#include <stdarg.h>
+
+#include <cassert>
+#include <sstream>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+#include "spect_iss_lib.h"
+
+#define NUM_THREADS     8
+#define NUM_RUNS        4
+
+// Runs program several times on a private instance, returns non-zero on wrong result
+static void run_instance(int isa_version, int *rv)
+{
+    for (int i = 0; i < NUM_RUNS; i++) {
+        spect_iss_ctx_t *ctx = spect_iss_create(isa_version);
+
+        std::stringstream log;
+        spect_iss_load_s_file(ctx, DPI_TEST_FW);
+        spect_iss_cmd_start(ctx, log);
+        spect_iss_cmd_run(ctx, log);
+
+        std::stringstream ss;
+        std::string r1;
+        spect_iss_cmd_get(ctx, ss, "R1");
+        ss >> r1;
+        if (uint256_t(r1.c_str()) != uint256_t(1000 * isa_version))
+            *rv = 1;
+
+        spect_iss_destroy(ctx);
+    }
+}
+
+int main()
+{
+    std::vector<std::thread> threads;
+    int rv[NUM_THREADS] = {};
+
+    // ISA version 1 and 2 instances run side by side
+    for (int i = 0; i < NUM_THREADS; i++)
+        threads.emplace_back(run_instance, (i % NUM_ISA_VERSIONS) + 1, &rv[i]);
+
+    for (auto &t : threads)
+        t.join();
+
+    for (int i = 0; i < NUM_THREADS; i++)
+        assert(rv[i] == 0 && "Instance computed correct result");
+
+    return 0;
+}
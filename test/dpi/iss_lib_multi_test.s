@@ -0,0 +1,23 @@
+; ==============================================================================
+;   Sums ISA version (1 or 2) 1000 times to r1.
+;   Used to check that instances of different ISA versions can run
+;   concurrently, each compiled with its own SPECT_ISA_VERSION_X define.
+; ==============================================================================
+
+_start:
+    MOVI    r0, 1000
+    MOVI    r1, 0
+.ifdef SPECT_ISA_VERSION_1
+    MOVI    r2, 1
+.endif
+.ifdef SPECT_ISA_VERSION_2
+    MOVI    r2, 2
+.endif
+
+_loop:
+    ADD     r1, r1, r2
+    SUBI    r0, r0, 1
+    BRNZ    _loop
+
+    ST      r1, 0x1000
+    END
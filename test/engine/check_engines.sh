@@ -0,0 +1,38 @@
+#!/bin/bash
+
+# Check if the correct number of arguments are provided
+if [ "$#" -lt 3 ]; then
+    echo "Usage: $0 <spect_iss> <program> <output_dir> [<spect_iss options>]"
+    exit 1
+fi
+
+# Assign arguments to variables
+ISS="$1"
+PROGRAM="$2"
+OUT_DIR="$3"
+shift 3
+
+mkdir -p $OUT_DIR
+
+for ENGINE in reference fast; do
+    echo "*************************************************************************"
+    echo "* Running test $PROGRAM with $ENGINE engine"
+    echo "*************************************************************************"
+    $ISS --program=$PROGRAM --engine=$ENGINE --dump-context=$OUT_DIR/$ENGINE.ctx \
+         --data-ram-out=$OUT_DIR/$ENGINE.hex "$@" > $OUT_DIR/$ENGINE.log
+    if [ "$?" -ne 0 ]; then
+        echo "Simulation with $ENGINE engine failed, see $OUT_DIR/$ENGINE.log"
+        exit 1
+    fi
+done
+
+echo "*************************************************************************"
+echo "* Comparing model context"
+echo "*************************************************************************"
+if diff $OUT_DIR/reference.ctx $OUT_DIR/fast.ctx && diff $OUT_DIR/reference.hex $OUT_DIR/fast.hex; then
+    echo "Model context matches"
+    exit 0
+else
+    echo "Model context does not match"
+    exit 1
+fi
@@ -0,0 +1,81 @@
+; Mix of ISA v2 instructions executed in loop. Each result feeds operands of later
+; instructions, so any difference between execution engines propagates to final context.
+
+_start:
+    ; R31 = P25519 = 2^255 - 19
+    MOVI    r0, 0x000
+    NOT     r31, r0
+    LSR     r31, r31
+    XORI    r31, r31, 0x012
+
+    MOVI    r1, 0x5A3
+    MOVI    r2, 0x1C7
+    MOVI    r30, 100
+
+_loop:
+    ; Scramble seeds
+    ROL8    r3, r1
+    XOR     r1, r3, r2
+    ROLIN   r2, r2, r1
+    ROR8    r2, r2
+    AND     r1, r1, r31
+
+    ; Modular arithmetic
+    MUL25519 r4, r1, r1
+    MUL256  r5, r4, r1
+    AND     r5, r5, r31
+    ADDP    r6, r4, r5
+    SUBP    r7, r4, r5
+    SUBP    r8, r5, r4
+    MULP    r9, r6, r7
+    REDP    r10, r2, r3
+
+    ; 32-bit arithmetic and flags
+    ADD     r11, r1, r2
+    SUB     r12, r11, r3
+    CMP     r11, r12
+    CMPI    r12, 0x7FF
+    CSWAP   r13, r14
+    ZSWAP   r14, r9
+    ADDI    r13, r13, 0x7FF
+    SUBI    r14, r14, 0x001
+
+    ; Bit manipulation
+    SBIT    r15, r9, r11
+    CBIT    r16, r15, r12
+    SWE     r17, r16
+    ROR     r18, r17
+    ROL     r19, r18
+    LSL     r20, r19
+    RORIN   r21, r20, r19
+    ANDI    r22, r21, 0xF0F
+    ORI     r23, r22, 0x123
+    OR      r24, r23, r10
+
+    ; Memory
+    ST      r24, 0x0100
+    LD      r25, 0x0100
+    MOVI    r26, 0x140
+    STR     r25, r26
+    LDR     r26, r26
+    MOV     r27, r26
+    CALL    _mix
+    ST      r29, 0x1000
+
+    ; Units without dedicated fast handler
+    SCB     r28, r27, r1
+    HASH_IT
+    HASH    r26, r4
+
+    SUBI    r30, r30, 1
+    BRNZ    _loop
+
+    END
+
+_mix:
+    XOR     r29, r28, r27
+    BRZ     _mix_end
+    BRC     _mix_end
+    JMP     _mix_end
+_mix_end:
+    RET
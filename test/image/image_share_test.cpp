@@ -0,0 +1,111 @@
+/**************************************************************************************************
+**
+**
+** TODO: License
+**
+** Author: Ondrej Ille
+**************************************************************************************************/
+
+#include <stdio.h>
+
+#include <memory>
+
+#include "spect.h"
+#include "spect_defs.h"
+#include "CpuModel.h"
+#include "ProgramImage.h"
+#include "Symbol.h"
+#include "SymbolTable.h"
+
+// Program placed so that its loop crosses page boundary (see image_share_test.s)
+#define IMAGE_TEST_ADDR     (SPECT_INSTR_MEM_BASE + 0xF0)
+
+#define RESULT_ORIGINAL     300
+#define RESULT_PATCHED      500
+#define NUM_ITERATIONS      100
+
+static int errors = 0;
+
+static void check(bool cond, const char *what, spect::ExecEngine engine)
+{
+    if (!cond) {
+        printf("Failed (%s engine): %s\n",
+               engine == spect::ExecEngine::FAST ? "fast" : "reference", what);
+        errors++;
+    }
+}
+
+static uint256_t run(spect::CpuModel &model)
+{
+    model.Reset();
+    model.Start();
+    model.Step(0);
+    return model.GetGpr(1);
+}
+
+int main()
+{
+    auto image = std::make_shared<spect::ProgramImage>(2, spect::ParityType::NONE);
+    image->LoadProgram(IMAGE_TEST_FW, IMAGE_TEST_ADDR);
+
+    uint16_t add = image->GetSymbols()->GetSymbol("_add")->val_;
+    uint16_t patch = image->GetSymbols()->GetSymbol("_patch")->val_;
+    uint32_t add_wrd = image->GetInstrMemWord((add - SPECT_INSTR_MEM_BASE) >> 2);
+    uint32_t patch_wrd = image->GetInstrMemWord((patch - SPECT_INSTR_MEM_BASE) >> 2);
+
+    for (auto engine : {spect::ExecEngine::REFERENCE, spect::ExecEngine::FAST}) {
+        auto attach = [&](spect::CpuModel &model) {
+            model.SetExecEngine(engine);
+            model.SetProgramImage(image);
+        };
+
+        spect::CpuModel shared(2, true, true);
+        attach(shared);
+        check(run(shared) == RESULT_ORIGINAL, "model with image", engine);
+
+        // Write after load is seen only by the model which did it
+        spect::CpuModel patched(2, true, true);
+        attach(patched);
+        patched.WriteMemoryAhb(add, patch_wrd);
+        check(run(patched) == RESULT_PATCHED, "model with patched word", engine);
+        check(image->GetInstrMemWord((add - SPECT_INSTR_MEM_BASE) >> 2) == add_wrd,
+              "image word unchanged", engine);
+        check(shared.ReadMemoryAhb(add) == add_wrd, "other model word unchanged", engine);
+        check(run(shared) == RESULT_ORIGINAL, "other model after patch", engine);
+
+        // Original word written back executes original program again
+        patched.WriteMemoryAhb(add, add_wrd);
+        check(run(patched) == RESULT_ORIGINAL, "model with restored word", engine);
+
+        // Snapshot carries modified page to other model, and back
+        patched.WriteMemoryAhb(add, patch_wrd);
+        auto snapshot = patched.Snapshot();
+        spect::CpuModel restored(2, true, true);
+        attach(restored);
+        restored.Restore(*snapshot);
+        check(run(restored) == RESULT_PATCHED, "model restored from patched snapshot", engine);
+        restored.Restore(*shared.Snapshot());
+        check(run(restored) == RESULT_ORIGINAL, "model restored from image snapshot", engine);
+
+        // Blocks stop at breakpoint also on page shared with image
+        spect::CpuModel bp(2, true, true);
+        attach(bp);
+        bp.SetBreakpoint(add, true);
+        bp.Reset();
+        bp.Start();
+        int hits = 0;
+        while (!bp.IsFinished()) {
+            bp.StepBlock();
+            if (bp.GetPc() == add)
+                hits++;
+        }
+        check(hits == NUM_ITERATIONS, "breakpoint hits", engine);
+        check(bp.GetGpr(1) == RESULT_ORIGINAL, "model with breakpoint", engine);
+
+        bp.SetBreakpoint(add, false);
+        check(run(bp) == RESULT_ORIGINAL, "model with removed breakpoint", engine);
+    }
+
+    printf("Checked models sharing program image, errors: %d\n", errors);
+    return errors ? 1 : 0;
+}
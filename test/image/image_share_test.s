@@ -0,0 +1,21 @@
+; Program shared by several models via program image. When placed at 0x80F0, loop crosses
+; page boundary of Instruction memory and '_add' is the first word of the next page. Test
+; writes word of '_patch' over '_add'.
+
+_start:
+    MOVI    r1, 0x000
+    MOVI    r2, 100
+
+_loop:
+    MOVI    r3, 0x001
+_add:
+    ADDI    r1, r1, 3
+    XOR     r4, r4, r3
+    SUBI    r2, r2, 1
+    BRNZ    _loop
+
+    ST      r1, 0x1000
+    END
+
+_patch:
+    ADDI    r1, r1, 5
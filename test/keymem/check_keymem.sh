@@ -0,0 +1,66 @@
+#!/bin/bash
+
+# Check if the correct number of arguments are provided
+if [ "$#" -ne 4 ]; then
+    echo "Usage: $0 <spect_iss> <program> <load_program> <output_dir>"
+    exit 1
+fi
+
+# Assign arguments to variables
+ISS="$1"
+PROGRAM="$2"
+LOAD_PROGRAM="$3"
+OUT_DIR="$4"
+
+mkdir -p $OUT_DIR
+
+# Runs spect_iss, exits on failure
+run_iss() {
+    LOG=$1
+    shift
+    $ISS "$@" > $OUT_DIR/$LOG.log
+    if [ "$?" -ne 0 ]; then
+        echo "Simulation failed, see $OUT_DIR/$LOG.log"
+        exit 1
+    fi
+}
+
+echo "*************************************************************************"
+echo "* Dumping Key Memory of $PROGRAM as full and sparse file"
+echo "*************************************************************************"
+run_iss dump_full --program=$PROGRAM --dump-keymem=$OUT_DIR/full.txt
+run_iss dump_sparse --program=$PROGRAM --dump-keymem=$OUT_DIR/sparse.txt --sparse-keymem
+
+if [ "$(grep -c 'Status: FULL' $OUT_DIR/full.txt)" -ne 3 ]; then
+    echo "Unexpected number of programmed slots"
+    exit 1
+fi
+if [ "$(grep -A 11 'Type: 4 Slot: 9$' $OUT_DIR/full.txt | sed -n '4p;12p' | tr '\n' ' ')" != \
+     "00000123 00000789 " ]; then
+    echo "Slot programmed from RAM Buffer has wrong content"
+    exit 1
+fi
+if [ "$(grep -c 'Status:' $OUT_DIR/sparse.txt)" -ne 3 ]; then
+    echo "Sparse Key Memory holds unused slots"
+    exit 1
+fi
+
+echo "*************************************************************************"
+echo "* Converting Key Memory between full and sparse file"
+echo "*************************************************************************"
+run_iss sparse_to_full --program=$LOAD_PROGRAM --load-keymem=$OUT_DIR/sparse.txt \
+        --dump-keymem=$OUT_DIR/conv_full.txt
+run_iss full_to_sparse --program=$LOAD_PROGRAM --load-keymem=$OUT_DIR/full.txt \
+        --dump-keymem=$OUT_DIR/conv_sparse.txt --sparse-keymem
+
+if ! diff $OUT_DIR/full.txt $OUT_DIR/conv_full.txt; then
+    echo "Full Key Memory loaded from sparse file does not match"
+    exit 1
+fi
+if ! diff $OUT_DIR/sparse.txt $OUT_DIR/conv_sparse.txt; then
+    echo "Sparse Key Memory loaded from full file does not match"
+    exit 1
+fi
+
+echo "Key Memory matches"
+exit 0
@@ -0,0 +1,29 @@
+; ==============================================================================
+;   Programs few slots of Key Memory, one of them is erased again.
+;   Slot 9 of type 4 is programmed from RAM Buffer holding slot 5 read by
+;   LDK and partially rewritten by STK (0x123 at offset 0, 0x789 at 8).
+; ==============================================================================
+
+_start:
+    MOVI    r1, 5
+    MOVI    r2, 0x123
+    STK     r2, r1, 0x400
+    KBO     r1, 0x402
+
+    MOVI    r1, 200
+    MOVI    r2, 0x456
+    STK     r2, r1, 0xA01
+    KBO     r1, 0xA02
+
+    MOVI    r1, 5
+    LDK     r4, r1, 0x400
+    MOVI    r1, 9
+    MOVI    r2, 0x789
+    STK     r2, r1, 0x401
+    KBO     r1, 0x402
+
+    MOVI    r1, 7
+    KBO     r1, 0x402
+    KBO     r1, 0x403
+
+    END
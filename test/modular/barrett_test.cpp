@@ -0,0 +1,80 @@
+/**************************************************************************************************
+**
+**
+** TODO: License
+**
+** Author: Ondrej Ille
+**************************************************************************************************/
+
+#include <stdio.h>
+
+#include <random>
+
+#include "spect.h"
+#include "ModularReduction.h"
+
+#define NUM_MODULI          4000
+#define NUM_VALUES          100
+
+int main()
+{
+    std::mt19937_64 rng(11);
+    auto rnd = [&]() {
+        uint256_t v = 0;
+        for (int i = 0; i < 4; i++)
+            v = (v << 64) | uint256_t(rng());
+        return v;
+    };
+
+    // Single context re-targeted to each modulus, the same way model re-uses it when R31 changes
+    spect::ModularReduction red;
+    int mismatches = 0;
+
+    for (int i = 0; i < NUM_MODULI; i++) {
+        uint256_t m;
+        switch (i % 8) {
+        case 0: m = uint256_t(rng() % 2); break;                    // 0, 1 - No Barrett context
+        case 1: m = uint256_t(2U + rng() % 100); break;
+        case 2: m = uint256_t(1U) << (rng() % 256); break;
+        case 3: m = uint256_t(0U) - 1U - uint256_t(rng() % 3); break;
+        case 4: m = (uint256_t(1U) << 255) - 19U; break;
+        case 5: m = rnd() >> (rng() % 256); break;
+        default: m = rnd();
+        }
+        red.SetModulus(m);
+
+        if (red.GetModulus() != m) {
+            printf("Modulus not set: m=%s\n", spect::tohexs(m).c_str());
+            mismatches++;
+        }
+
+        for (int j = 0; j < NUM_VALUES; j++) {
+            uint256_t a = rnd();
+            uint256_t b = rnd();
+            uint512_t x;
+            switch (rng() % 6) {
+            case 0: x = (uint512_t(a) << 256) | uint512_t(b); break;
+            case 1: x = uint512_t(a) * uint512_t(b); break;
+            case 2: x = ~uint512_t(0U) - uint512_t(rng() % 4); break;
+            case 3: x = uint512_t(m) * uint512_t(b) + uint512_t(rng() % 3); break;
+            case 4: x = uint512_t(m) - uint512_t(rng() % 2); break;
+            default: x = uint512_t(rng() % 5);
+            }
+
+            if (red.Reduce(x) != uint256_t(x % uint512_t(m))) {
+                printf("Reduce mismatch: m=%s x=%s\n", spect::tohexs(m).c_str(),
+                       (spect::tohexs(uint256_t(x >> 256)) + spect::tohexs(uint256_t(x))).c_str());
+                mismatches++;
+            }
+
+            if (red.MulMod(a, b) != uint256_t((uint512_t(a) * uint512_t(b)) % uint512_t(m))) {
+                printf("MulMod mismatch: m=%s a=%s b=%s\n", spect::tohexs(m).c_str(),
+                       spect::tohexs(a).c_str(), spect::tohexs(b).c_str());
+                mismatches++;
+            }
+        }
+    }
+
+    printf("Checked Barrett reduction, mismatches: %d\n", mismatches);
+    return mismatches ? 1 : 0;
+}
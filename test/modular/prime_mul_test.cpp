@@ -0,0 +1,76 @@
+/**************************************************************************************************
+**
+**
+** TODO: License
+**
+** Author: Ondrej Ille
+**************************************************************************************************/
+
+#include <stdio.h>
+
+#include <random>
+#include <vector>
+
+#include "spect.h"
+#include "ModularReduction.h"
+
+#define NUM_RANDOM_CASES    200000
+
+static const uint512_t p_25519 = (uint512_t(1U) << 255) - 19U;
+static const uint512_t p_256   = (uint512_t(1U) << 256) - (uint512_t(1U) << 224) +
+                                 (uint512_t(1U) << 192) + (uint512_t(1U) << 96) - 1U;
+
+static int mismatches = 0;
+
+// Compares both kernels against generic '%' for single pair of operands
+static void check(const uint256_t &a, const uint256_t &b)
+{
+    uint256_t exp_25519 = uint256_t((uint512_t(a) * uint512_t(b)) % p_25519);
+    uint256_t exp_256   = uint256_t((uint512_t(a) * uint512_t(b)) % p_256);
+    uint256_t res_25519 = spect::ModularReduction::MulModP25519(a, b);
+    uint256_t res_256   = spect::ModularReduction::MulModP256(a, b);
+
+    if (res_25519 != exp_25519) {
+        printf("MulModP25519 mismatch: a=%s b=%s\n", spect::tohexs(a).c_str(),
+               spect::tohexs(b).c_str());
+        mismatches++;
+    }
+    if (res_256 != exp_256) {
+        printf("MulModP256 mismatch: a=%s b=%s\n", spect::tohexs(a).c_str(),
+               spect::tohexs(b).c_str());
+        mismatches++;
+    }
+}
+
+int main()
+{
+    std::mt19937_64 rng(7);
+    auto rnd = [&]() {
+        uint256_t v = 0;
+        for (int i = 0; i < 4; i++)
+            v = (v << 64) | uint256_t(rng());
+        return v;
+    };
+
+    // Edge operands: small values, values around both primes and 2^256 - 1
+    std::vector<uint256_t> edges = {0U, 1U, 2U, uint256_t(0U) - 1U, uint256_t(0U) - 2U};
+    for (const uint512_t &p : {p_25519, p_256}) {
+        edges.push_back(uint256_t(p) - 1U);
+        edges.push_back(uint256_t(p));
+        edges.push_back(uint256_t(p) + 1U);
+        edges.push_back(uint256_t(p) * 2U);
+    }
+
+    for (const auto &a : edges) {
+        for (const auto &b : edges)
+            check(a, b);
+        for (int i = 0; i < 1000; i++)
+            check(a, rnd());
+    }
+
+    for (int i = 0; i < NUM_RANDOM_CASES; i++)
+        check(rnd(), rnd());
+
+    printf("Checked fixed prime multiplication, mismatches: %d\n", mismatches);
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,127 @@
+/**************************************************************************************************
+**
+**
+** TODO: License
+**
+** Author: Ondrej Ille
+**************************************************************************************************/
+
+#include <stdio.h>
+
+#include <memory>
+#include <random>
+
+#include "spect.h"
+#include "spect_defs.h"
+#include "CpuModel.h"
+#include "ProgramImage.h"
+
+#define NUM_RUNS            200
+#define NUM_RESULTS         17
+
+// Generic reduction of modular instructions as executed without reduction context
+static uint256_t addp(const uint256_t &a, const uint256_t &b, const uint256_t &m)
+{
+    return uint256_t((uint512_t(a) + uint512_t(b)) % uint512_t(m));
+}
+
+static uint256_t subp(const uint256_t &a, const uint256_t &b, const uint256_t &m)
+{
+    uint512_t lhs = uint512_t(a);
+    if (b > a)
+        lhs += uint512_t(m);
+    return uint256_t((lhs - uint512_t(b)) % uint512_t(m));
+}
+
+static uint256_t mulp(const uint256_t &a, const uint256_t &b, const uint256_t &m)
+{
+    return uint256_t((uint512_t(a) * uint512_t(b)) % uint512_t(m));
+}
+
+static uint256_t redp(const uint256_t &a, const uint256_t &b, const uint256_t &m)
+{
+    return uint256_t(((uint512_t(a) << 256) | uint512_t(b)) % uint512_t(m));
+}
+
+// Stores 256 bit value to model memory, LS word first (as LD instruction loads it)
+static void set_operand(spect::CpuModel &model, uint16_t address, uint256_t val)
+{
+    for (int i = 0; i < 8; i++) {
+        model.SetMemory(address + (4 * i), static_cast<uint32_t>(val));
+        val = val >> 32;
+    }
+}
+
+int main()
+{
+    std::mt19937_64 rng(13);
+    auto rnd = [&]() {
+        uint256_t v = 0;
+        for (int i = 0; i < 4; i++)
+            v = (v << 64) | uint256_t(rng());
+        return v;
+    };
+
+    auto image = std::make_shared<spect::ProgramImage>(2, spect::ParityType::NONE);
+    image->LoadProgram(MODULAR_TEST_FW, SPECT_INSTR_MEM_BASE);
+
+    int mismatches = 0;
+    for (int run = 0; run < NUM_RUNS; run++) {
+        uint256_t a = rnd();
+        uint256_t b = rnd();
+        uint256_t m = rnd() >> (rng() % 256);
+        uint256_t p = uint256_t(1U) << (rng() % 256);
+        if (m == 0U)
+            m = 2U;
+
+        // Operands mostly reduced by M (as SW uses them), sometimes not reduced at all
+        if (run % 4) {
+            a %= m;
+            b %= m;
+        }
+
+        uint256_t exp[NUM_RESULTS];
+        exp[3]  = mulp(a, b, m);
+        exp[4]  = redp(a, b, m);
+        exp[5]  = addp(a, b, exp[3]);
+        exp[6]  = subp(a, b, exp[3]);
+        exp[7]  = mulp(a, b, p);
+        exp[8]  = redp(a, b, mulp(a, b, p));
+        exp[9]  = mulp(a, b, 0U);
+        exp[10] = addp(a, b, 0U);
+        exp[11] = redp(a, b, 1U);
+        exp[12] = subp(a, b, 1U);
+        exp[13] = mulp(a, b, 0x7FFU);
+        exp[14] = addp(a, b, m);
+        exp[15] = subp(a, b, 0x7FFU);
+        exp[16] = redp(a, b, m);
+
+        for (auto engine : {spect::ExecEngine::REFERENCE, spect::ExecEngine::FAST}) {
+            spect::CpuModel model(2, false, false);
+            model.SetExecEngine(engine);
+            model.SetProgramImage(image);
+
+            set_operand(model, SPECT_DATA_RAM_IN_BASE + 0x00, a);
+            set_operand(model, SPECT_DATA_RAM_IN_BASE + 0x20, b);
+            set_operand(model, SPECT_DATA_RAM_IN_BASE + 0x40, m);
+            set_operand(model, SPECT_DATA_RAM_IN_BASE + 0x60, p);
+
+            model.Reset();
+            model.Start();
+            model.Step(0);
+
+            for (int i = 3; i < NUM_RESULTS; i++) {
+                if (model.GetGpr(i) != exp[i]) {
+                    printf("Mismatch in R%d (%s engine): a=%s b=%s m=%s p=%s\n", i,
+                           engine == spect::ExecEngine::FAST ? "fast" : "reference",
+                           spect::tohexs(a).c_str(), spect::tohexs(b).c_str(),
+                           spect::tohexs(m).c_str(), spect::tohexs(p).c_str());
+                    mismatches++;
+                }
+            }
+        }
+    }
+
+    printf("Checked modular operations with reloaded R31, mismatches: %d\n", mismatches);
+    return mismatches ? 1 : 0;
+}
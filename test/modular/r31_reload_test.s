@@ -0,0 +1,50 @@
+; Modular operations with R31 rewritten between them. Result of each operation is kept
+; in distinct register and checked by r31_reload_test.cpp against generic reduction.
+;
+; Data RAM In:
+;   0x0000 - Operand A
+;   0x0020 - Operand B
+;   0x0040 - Modulus M
+;   0x0060 - Power of two P
+
+_start:
+    LD      r1, 0x0000
+    LD      r2, 0x0020
+
+    ; R31 loaded from memory
+    LD      r31, 0x0040
+    MULP    r3, r1, r2
+    REDP    r4, r1, r2
+
+    ; R31 moved from result of previous operation
+    MOV     r31, r3
+    ADDP    r5, r1, r2
+    SUBP    r6, r1, r2
+
+    ; R31 = power of two, rewritten by modular operation itself
+    LD      r31, 0x0060
+    MULP    r7, r1, r2
+    MULP    r31, r1, r2
+    REDP    r8, r1, r2
+
+    ; R31 = 0
+    MOVI    r31, 0x000
+    MULP    r9, r1, r2
+    ADDP    r10, r1, r2
+
+    ; R31 = 1
+    MOVI    r31, 0x001
+    REDP    r11, r1, r2
+    SUBP    r12, r1, r2
+
+    ; R31 = small value, alternated with M between each operation
+    MOVI    r31, 0x7FF
+    MULP    r13, r1, r2
+    LD      r31, 0x0040
+    ADDP    r14, r1, r2
+    MOVI    r31, 0x7FF
+    SUBP    r15, r1, r2
+    LD      r31, 0x0040
+    REDP    r16, r1, r2
+
+    END
@@ -0,0 +1,18 @@
+; Lexer corner cases: comments, spaces, labels followed by instructions,
+; register and numeric literal forms
+
+   ; indented comment
+_start:NOP
+    hex_const  .eq  0x1F ; comment after constant
+    dec_const .eq 42
+label_1: ADD R1,R2,R3
+label_2:   ADDI r31, r30, hex_const   ; comment after instruction
+    ADDI R10,R19, dec_const
+    ADDI R9,R10,hex_const;comment without space
+    ADDI R0,R1,0x3e
+    ADDI R0,R1,7
+label_3:
+label_4:  ; comment after label
+    JMP label_3
+    CALL label_4
+    END